@@ -1,11 +1,14 @@
+#include "QueensEngine.h"
+#include "QueensFarm.h"
+#include "QueensFuzz.h"
 #include <iostream>
-#include <cstdlib>
-#include <ctime>
-#include <string>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <cctype>
+#include <cstdio>
 using namespace std;
 
-const int BOARD_SIZE = 8;
-
 const string RESET = "\033[0m";
 const string BOLD = "\033[1m";
 const string RED = "\033[31m";
@@ -37,175 +40,6 @@ const string BG_LIME = "\033[48;5;154m";
 const string BG_TEAL = "\033[48;5;30m";
 const string BG_BROWN = "\033[48;5;130m";
 
-struct MoveNode {
-	int row;
-	int col;
-	int actionType;
-	MoveNode* next;
-};
-
-class MoveHistory {
-private:
-	MoveNode* head;
-	int count;
-public:
-	MoveHistory() {
-		head = NULL;
-		count = 0;
-	}
-
-	~MoveHistory() {
-		clear();
-	}
-
-	void addMove(int row, int col, int actionType) {
-		MoveNode* newNode = new MoveNode;
-		newNode->row = row;
-		newNode->col = col;
-		newNode->actionType = actionType;
-		newNode->next = head;
-		head = newNode;
-		count++;
-	}
-
-	MoveNode* getLastMove() {
-		return head;
-	}
-
-	void removeLastMove() {
-		if (head == NULL) return;
-		MoveNode* temp = head;
-		head = head->next;
-		delete temp;
-		count--;
-	}
-
-	int getCount() {
-		return count;
-	}
-
-	void clear() {
-		while (head != NULL) {
-			MoveNode* temp = head;
-			head = head->next;
-			delete temp;
-		}
-		count = 0;
-	}
-
-	void display() {
-		cout << CYAN << "Move History (" << count << " moves):\n" << RESET;
-		MoveNode* temp = head;
-		int i = count;
-		while (temp != NULL) {
-			string action;
-			if (temp->actionType == 1) action = "Place Queen";
-			else if (temp->actionType == 2) action = "Remove Queen";
-			else if (temp->actionType == 3) action = "Mark X";
-			else action = "Clear Cell";
-			cout << "  " << i << ". " << action << " at (" << temp->row << ", " << temp->col << ")\n";
-			temp = temp->next;
-			i--;
-		}
-	}
-};
-
-struct UndoNode {
-	int row;
-	int col;
-	int prevState;
-	int newState;
-	UndoNode* prev;
-	UndoNode* next;
-};
-
-class UndoRedoList {
-private:
-	UndoNode* head;
-	UndoNode* tail;
-	UndoNode* current;
-public:
-	UndoRedoList() {
-		head = NULL;
-		tail = NULL;
-		current = NULL;
-	}
-
-	~UndoRedoList() {
-		clear();
-	}
-
-	void addAction(int row, int col, int prevState, int newState) {
-		if (current != NULL && current->next != NULL) {
-			UndoNode* temp = current->next;
-			while (temp != NULL) {
-				UndoNode* toDelete = temp;
-				temp = temp->next;
-				delete toDelete;
-			}
-			current->next = NULL;
-			tail = current;
-		}
-
-		UndoNode* newNode = new UndoNode;
-		newNode->row = row;
-		newNode->col = col;
-		newNode->prevState = prevState;
-		newNode->newState = newState;
-		newNode->prev = tail;
-		newNode->next = NULL;
-
-		if (tail != NULL) {
-			tail->next = newNode;
-		}
-		tail = newNode;
-		current = newNode;
-
-		if (head == NULL) {
-			head = newNode;
-		}
-	}
-
-	UndoNode* undo() {
-		if (current == NULL) return NULL;
-		UndoNode* action = current;
-		current = current->prev;
-		return action;
-	}
-
-	UndoNode* redo() {
-		if (current == NULL && head != NULL) {
-			current = head;
-			return current;
-		}
-		if (current != NULL && current->next != NULL) {
-			current = current->next;
-			return current;
-		}
-		return NULL;
-	}
-
-	bool canUndo() {
-		return current != NULL;
-	}
-
-	bool canRedo() {
-		return (current == NULL && head != NULL) || (current != NULL && current->next != NULL);
-	}
-
-	void clear() {
-		UndoNode* temp = head;
-		while (temp != NULL) {
-			UndoNode* toDelete = temp;
-			temp = temp->next;
-			delete toDelete;
-		}
-		head = NULL;
-		tail = NULL;
-		current = NULL;
-	}
-};
-
 struct MenuNode {
 	int id;
 	string label;
@@ -287,6 +121,10 @@ public:
 		current = temp;
 	}
 
+	int getSize() {
+		return size;
+	}
+
 	int getCurrentId() {
 		if (current != NULL) return current->id;
 		return -1;
@@ -303,308 +141,279 @@ public:
 	}
 };
 
-struct RecordNode {
-	int moveCount;
-	int gameId;
-	bool won;
-	RecordNode* left;
-	RecordNode* right;
+const string regionColors[8] = {
+	BG_RED, BG_LIME, BG_YELLOW, BG_BLUE,
+	BG_PURPLE, BG_CYAN, BG_ORANGE, BG_PINK
 };
 
-class GameRecordsBST {
-private:
-	RecordNode* root;
-	int gameCounter;
-
-	RecordNode* insert(RecordNode* node, int moves, int id, bool won) {
-		if (node == NULL) {
-			RecordNode* newNode = new RecordNode;
-			newNode->moveCount = moves;
-			newNode->gameId = id;
-			newNode->won = won;
-			newNode->left = NULL;
-			newNode->right = NULL;
-			return newNode;
-		}
-		if (moves < node->moveCount) {
-			node->left = insert(node->left, moves, id, won);
-		}
-		else {
-			node->right = insert(node->right, moves, id, won);
-		}
-		return node;
-	}
+const string regionTextColors[8] = {
+	WHITE, BLACK, BLACK, WHITE,
+	WHITE, BLACK, BLACK, WHITE
+};
 
-	void inorder(RecordNode* node) {
-		if (node == NULL) return;
-		inorder(node->left);
-		string status = node->won ? GREEN + "Won" + RESET : RED + "Lost" + RESET;
-		cout << "  Game #" << node->gameId << ": " << node->moveCount << " moves - " << status << "\n";
-		inorder(node->right);
-	}
+const string hintReasons[4] = {
+	"This spot keeps more cells open for future moves.",
+	"This row has limited options.",
+	"This column has limited options.",
+	"This color region has limited options."
+};
 
-	RecordNode* findMin(RecordNode* node) {
-		while (node != NULL && node->left != NULL) {
-			node = node->left;
+// Each call writes its own temp file, so the stats thread and the menu can both dump at once.
+static atomic<unsigned> prometheusWrites(0);
+
+bool writePrometheus(string path, Telemetry* telemetry) {
+	ostringstream tempName;
+	tempName << path << "." << prometheusWrites++ << ".tmp";
+	string temp = tempName.str();
+	ofstream out(temp.c_str());
+	if (!out) return false;
+
+	out << "# HELP queens_operation_latency_seconds Latency of QueensGame operations.\n";
+	out << "# TYPE queens_operation_latency_seconds summary\n";
+	unsigned long long totals[LatencyHistogram::BUCKETS];
+	unsigned long long count;
+	double quantiles[3] = { 0.5, 0.99, 0.999 };
+	for (int op = 0; op < OP_COUNT; op++) {
+		operationStats.merge(op, totals, count);
+		double sum = 0;
+		for (int b = 0; b < LatencyHistogram::BUCKETS; b++) {
+			sum += totals[b] * (double)LatencyHistogram::bucketUpperBound(b);
 		}
-		return node;
-	}
-
-	void destroyTree(RecordNode* node) {
-		if (node == NULL) return;
-		destroyTree(node->left);
-		destroyTree(node->right);
-		delete node;
-	}
-
-public:
-	GameRecordsBST() {
-		root = NULL;
-		gameCounter = 0;
+		for (int q = 0; q < 3; q++) {
+			out << "queens_operation_latency_seconds{operation=\"" << operationNames[op] << "\",quantile=\"" << quantiles[q] << "\"} "
+				<< OperationStats::percentile(totals, count, quantiles[q]) / 1e9 << "\n";
+		}
+		out << "queens_operation_latency_seconds_sum{operation=\"" << operationNames[op] << "\"} " << sum / 1e9 << "\n";
+		out << "queens_operation_latency_seconds_count{operation=\"" << operationNames[op] << "\"} " << count << "\n";
 	}
-
-	~GameRecordsBST() {
-		destroyTree(root);
+	if (telemetry != NULL) {
+		TelemetrySummary summary = telemetry->getSummary();
+		out << "# TYPE queens_games_total counter\nqueens_games_total " << summary.games << "\n";
+		out << "# TYPE queens_wins_total counter\nqueens_wins_total " << summary.wins << "\n";
+		out << "# TYPE queens_moves_total counter\nqueens_moves_total " << summary.moves << "\n";
+		out << "# TYPE queens_hinted_moves_total counter\nqueens_hinted_moves_total " << summary.hintedMoves << "\n";
+		out << "# TYPE queens_telemetry_dropped_total counter\nqueens_telemetry_dropped_total " << summary.dropped << "\n";
+		out << "# TYPE queens_think_time_seconds summary\n";
+		out << "queens_think_time_seconds{quantile=\"0.5\"} " << summary.thinkP50Seconds << "\n";
+		out << "queens_think_time_seconds{quantile=\"0.99\"} " << summary.thinkP99Seconds << "\n";
 	}
-
-	void addRecord(int moves, bool won) {
-		gameCounter++;
-		root = insert(root, moves, gameCounter, won);
+	out.close();
+#ifdef _WIN32
+	// rename() will not replace an existing file here; elsewhere it does so atomically.
+	remove(path.c_str());
+#endif
+	if (rename(temp.c_str(), path.c_str()) != 0) {
+		remove(temp.c_str());
+		return false;
 	}
+	return true;
+}
 
-	void displayRecords() {
-		cout << CYAN << "\n=== Game Records (sorted by moves) ===\n" << RESET;
-		if (root == NULL) {
-			cout << "  No games played yet.\n";
-			return;
+class StatsDumper {
+private:
+	thread worker;
+	mutex lock;
+	condition_variable wake;
+	string path;
+	Telemetry* telemetry;
+	int intervalSeconds;
+	bool stopping;
+
+	void run() {
+		unique_lock<mutex> guard(lock);
+		while (!stopping) {
+			wake.wait_for(guard, chrono::seconds(intervalSeconds));
+			writePrometheus(path, telemetry);
 		}
-		inorder(root);
 	}
 
-	RecordNode* getBestGame() {
-		return findMin(root);
+public:
+	StatsDumper(string file, int seconds, Telemetry* sink) {
+		path = file;
+		telemetry = sink;
+		intervalSeconds = seconds;
+		stopping = false;
+		worker = thread(&StatsDumper::run, this);
 	}
 
-	int getTotalGames() {
-		return gameCounter;
+	~StatsDumper() {
+		{
+			lock_guard<mutex> guard(lock);
+			stopping = true;
+		}
+		wake.notify_all();
+		worker.join();
 	}
 };
 
-class ConflictGraph {
-private:
-	int rowConflicts[BOARD_SIZE];
-	int colConflicts[BOARD_SIZE];
-	int colorConflicts[BOARD_SIZE];
-	int colorGrid[BOARD_SIZE][BOARD_SIZE];
-
-public:
-	ConflictGraph() {
-		for (int i = 0; i < BOARD_SIZE; i++) {
-			rowConflicts[i] = 0;
-			colConflicts[i] = 0;
-			colorConflicts[i] = 0;
-		}
+void displayOperationStats() {
+	cout << CYAN << "\n=== Operation Latency (microseconds) ===\n" << RESET;
+#if QUEENS_PROFILING
+	unsigned long long totals[LatencyHistogram::BUCKETS];
+	unsigned long long count;
+	for (int op = 0; op < OP_COUNT; op++) {
+		operationStats.merge(op, totals, count);
+		if (count == 0) continue;
+		cout << "  " << left << setw(24) << operationNames[op] << " n=" << setw(8) << count << fixed << setprecision(2)
+			<< " p50=" << setw(10) << OperationStats::percentile(totals, count, 0.5) / 1000.0
+			<< " p99=" << setw(10) << OperationStats::percentile(totals, count, 0.99) / 1000.0
+			<< " p999=" << OperationStats::percentile(totals, count, 0.999) / 1000.0 << "\n";
 	}
+	cout << right << defaultfloat;
+#else
+	cout << "  Profiling was disabled at compile time (QUEENS_PROFILING=0).\n";
+#endif
+}
 
-	void setColorGrid(int grid[BOARD_SIZE][BOARD_SIZE]) {
-		for (int i = 0; i < BOARD_SIZE; i++) {
-			for (int j = 0; j < BOARD_SIZE; j++) {
-				colorGrid[i][j] = grid[i][j];
-			}
-		}
+// Prints the outcome of a move. Returns true when the move was applied.
+bool reportStatus(MoveStatus status, int row, int col) {
+	switch (status) {
+	case STATUS_OK:
+		return true;
+	case STATUS_OUT_OF_RANGE:
+		cout << RED << "Invalid position! Use 0-7 for row and column.\n" << RESET;
+		break;
+	case STATUS_OCCUPIED:
+		cout << RED << "There's already a queen here!\n" << RESET;
+		break;
+	case STATUS_MARKED:
+		cout << RED << "This cell is marked as invalid. Clear it first or choose another.\n" << RESET;
+		break;
+	case STATUS_ROW_CONFLICT:
+		cout << RED << "Invalid! Row " << row << " already has a queen.\n" << RESET;
+		break;
+	case STATUS_COL_CONFLICT:
+		cout << RED << "Invalid! Column " << col << " already has a queen.\n" << RESET;
+		break;
+	case STATUS_REGION_CONFLICT:
+		cout << RED << "Invalid! This color region already has a queen.\n" << RESET;
+		break;
+	case STATUS_DIAGONAL_TOUCH:
+		cout << RED << "Invalid! Queens cannot touch diagonally.\n" << RESET;
+		break;
+	case STATUS_BLOCKED:
+		cout << RED << "Invalid! That cell conflicts with a queen.\n" << RESET;
+		break;
+	case STATUS_NO_QUEEN:
+		cout << RED << "No queen at this position!\n" << RESET;
+		break;
+	case STATUS_IS_QUEEN:
+		cout << RED << "Cannot mark a queen position!\n" << RESET;
+		break;
+	case STATUS_ALREADY_MARKED:
+		cout << YELLOW << "Already marked as X.\n" << RESET;
+		break;
+	case STATUS_ALREADY_EMPTY:
+		cout << YELLOW << "Cell is already empty.\n" << RESET;
+		break;
+	case STATUS_NOTHING_TO_UNDO:
+		cout << RED << "Nothing to undo!\n" << RESET;
+		break;
+	case STATUS_NOTHING_TO_REDO:
+		cout << RED << "Nothing to redo!\n" << RESET;
+		break;
+	case STATUS_SAME_POSITION:
+		cout << YELLOW << "Already at this position.\n" << RESET;
+		break;
+	case STATUS_NO_SUCH_POSITION:
+		cout << RED << "No such position!\n" << RESET;
+		break;
+	case STATUS_ALREADY_SOLVED:
+		cout << YELLOW << "Puzzle already solved!\n" << RESET;
+		break;
+	case STATUS_UNSOLVABLE:
+		cout << RED << "This position cannot be solved! Try undoing some moves.\n" << RESET;
+		break;
+	case STATUS_NO_MOVES:
+		cout << RED << "No valid moves available! Try undoing some moves.\n" << RESET;
+		break;
+	case STATUS_BAD_SAVE:
+		cout << RED << "No valid saved game found; the current game is unchanged.\n" << RESET;
+		break;
+	default:
+		break;
 	}
+	return false;
+}
 
-	void addQueen(int row, int col) {
-		rowConflicts[row]++;
-		colConflicts[col]++;
-		colorConflicts[colorGrid[row][col]]++;
-	}
+bool placeQueen(QueensGame& game, int row, int col) {
+	if (!reportStatus(game.placeQueen(row, col), row, col)) return false;
+	cout << GREEN << "Queen placed at (" << row << ", " << col << ")!\n" << RESET;
+	return true;
+}
 
-	void removeQueen(int row, int col) {
-		rowConflicts[row]--;
-		colConflicts[col]--;
-		colorConflicts[colorGrid[row][col]]--;
-	}
+bool removeQueen(QueensGame& game, int row, int col) {
+	if (!reportStatus(game.removeQueen(row, col), row, col)) return false;
+	cout << GREEN << "Queen removed from (" << row << ", " << col << ")!\n" << RESET;
+	return true;
+}
 
-	bool hasRowConflict(int row) {
-		return rowConflicts[row] > 0;
-	}
+bool markX(QueensGame& game, int row, int col) {
+	if (!reportStatus(game.markX(row, col), row, col)) return false;
+	cout << GREEN << "Marked X at (" << row << ", " << col << ").\n" << RESET;
+	return true;
+}
 
-	bool hasColConflict(int col) {
-		return colConflicts[col] > 0;
-	}
+bool clearCell(QueensGame& game, int row, int col) {
+	if (!reportStatus(game.clearCell(row, col), row, col)) return false;
+	cout << GREEN << "Cell cleared at (" << row << ", " << col << ").\n" << RESET;
+	return true;
+}
 
-	bool hasColorConflict(int row, int col) {
-		return colorConflicts[colorGrid[row][col]] > 0;
-	}
+bool undo(QueensGame& game) {
+	if (!reportStatus(game.undo(), -1, -1)) return false;
+	cout << GREEN << "Undo successful!\n" << RESET;
+	return true;
+}
 
-	int getRowCount(int row) { return rowConflicts[row]; }
-	int getColCount(int col) { return colConflicts[col]; }
-	int getColorCount(int color) { return colorConflicts[color]; }
+bool redo(QueensGame& game) {
+	if (!reportStatus(game.redo(), -1, -1)) return false;
+	cout << GREEN << "Redo successful!\n" << RESET;
+	return true;
+}
 
-	void reset() {
-		for (int i = 0; i < BOARD_SIZE; i++) {
-			rowConflicts[i] = 0;
-			colConflicts[i] = 0;
-			colorConflicts[i] = 0;
-		}
-	}
-};
+bool jumpToVariation(QueensGame& game, int id) {
+	if (!reportStatus(game.jumpToVariation(id), -1, -1)) return false;
+	cout << GREEN << "Switched to position #" << id << ".\n" << RESET;
+	return true;
+}
 
-class QueensGame {
-private:
-	int board[BOARD_SIZE][BOARD_SIZE];
-	int colorGrid[BOARD_SIZE][BOARD_SIZE];
-	int queenCount;
-	int moveCount;
-	MoveHistory history;
-	UndoRedoList undoRedo;
-	ConflictGraph conflicts;
-	GameRecordsBST* records;
-
-	string regionColors[8] = {
-		BG_RED, BG_LIME, BG_YELLOW, BG_BLUE,
-		BG_PURPLE, BG_CYAN, BG_ORANGE, BG_PINK
-	};
-
-	string regionTextColors[8] = {
-		WHITE, BLACK, BLACK, WHITE,
-		WHITE, BLACK, BLACK, WHITE
-	};
+void displayBoard(QueensGame& game) {
+	PROFILE_OPERATION(OP_DISPLAY_BOARD);
+	cout << "\n";
 
-public:
-	QueensGame(GameRecordsBST* rec) {
-		srand((unsigned int)time(NULL));
-		records = rec;
-		queenCount = 0;
-		moveCount = 0;
-		initBoard();
-		generateColorRegions();
-		conflicts.setColorGrid(colorGrid);
+	cout << "      ";
+	for (int j = 0; j < BOARD_SIZE; j++) {
+		cout << CYAN << BOLD << " " << j << "  " << RESET;
 	}
+	cout << "\n";
 
-	void initBoard() {
-		for (int i = 0; i < BOARD_SIZE; i++) {
-			for (int j = 0; j < BOARD_SIZE; j++) {
-				board[i][j] = 0;
-			}
-		}
-		queenCount = 0;
-		moveCount = 0;
-		history.clear();
-		undoRedo.clear();
-		conflicts.reset();
+	cout << "     " << CYAN << "+";
+	for (int j = 0; j < BOARD_SIZE; j++) {
+		cout << "---+";
 	}
+	cout << RESET << "\n";
 
-	void generateColorRegions() {
-		int predefinedBoards[5][8][8] = {
-			{
-				{0, 0, 0, 0, 1, 1, 1, 1},
-				{0, 2, 2, 0, 1, 1, 1, 1},
-				{2, 2, 2, 0, 3, 3, 1, 1},
-				{2, 2, 0, 0, 3, 3, 3, 4},
-				{2, 0, 0, 3, 3, 3, 4, 4},
-				{5, 5, 0, 3, 6, 6, 4, 4},
-				{5, 5, 5, 6, 6, 6, 4, 4},
-				{5, 5, 5, 6, 6, 7, 7, 7}
-			},
-			{
-				{0, 0, 0, 1, 1, 1, 1, 2},
-				{0, 0, 1, 1, 1, 2, 2, 2},
-				{0, 3, 3, 1, 2, 2, 2, 2},
-				{3, 3, 3, 3, 4, 4, 2, 5},
-				{3, 3, 4, 4, 4, 4, 5, 5},
-				{6, 6, 4, 4, 5, 5, 5, 5},
-				{6, 6, 6, 7, 7, 5, 5, 5},
-				{6, 6, 6, 7, 7, 7, 7, 7}
-			},
-			{
-				{0, 0, 0, 0, 1, 1, 1, 1},
-				{0, 0, 2, 2, 2, 1, 1, 1},
-				{0, 2, 2, 2, 3, 3, 1, 1},
-				{0, 2, 2, 3, 3, 3, 3, 4},
-				{5, 5, 2, 3, 3, 4, 4, 4},
-				{5, 5, 5, 5, 6, 6, 4, 4},
-				{5, 5, 7, 6, 6, 6, 4, 4},
-				{7, 7, 7, 7, 6, 6, 6, 4}
-			},
-			{
-				{0, 0, 1, 1, 1, 2, 2, 2},
-				{0, 0, 0, 1, 1, 1, 2, 2},
-				{0, 0, 3, 3, 1, 2, 2, 2},
-				{4, 4, 3, 3, 3, 3, 5, 5},
-				{4, 4, 4, 3, 3, 5, 5, 5},
-				{4, 4, 4, 6, 6, 6, 5, 5},
-				{7, 4, 6, 6, 6, 6, 5, 5},
-				{7, 7, 7, 7, 6, 6, 5, 5}
-			},
-			{
-				{0, 0, 0, 0, 0, 1, 1, 1},
-				{0, 2, 2, 3, 3, 3, 1, 1},
-				{2, 2, 2, 3, 3, 3, 1, 1},
-				{2, 2, 3, 3, 4, 4, 4, 1},
-				{2, 5, 5, 4, 4, 4, 4, 1},
-				{5, 5, 5, 5, 4, 6, 6, 6},
-				{5, 5, 7, 7, 6, 6, 6, 6},
-				{7, 7, 7, 7, 7, 7, 6, 6}
-			}
-		};
-
-		int boardIndex = rand() % 5;
-
-		int shuffle[8];
-		for (int i = 0; i < 8; i++) shuffle[i] = i;
-		for (int i = 7; i > 0; i--) {
-			int j = rand() % (i + 1);
-			int temp = shuffle[i];
-			shuffle[i] = shuffle[j];
-			shuffle[j] = temp;
-		}
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		cout << CYAN << BOLD << "  " << i << "  " << RESET << CYAN << "|" << RESET;
 
-		for (int i = 0; i < BOARD_SIZE; i++) {
-			for (int j = 0; j < BOARD_SIZE; j++) {
-				colorGrid[i][j] = shuffle[predefinedBoards[boardIndex][i][j]];
-			}
-		}
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			int c = game.getColor(i, j);
+			string bg = regionColors[c];
+			string fg = regionTextColors[c];
+			string content;
 
-		int transform = rand() % 8;
-		if (transform >= 4) {
-			for (int i = 0; i < BOARD_SIZE; i++) {
-				for (int j = i + 1; j < BOARD_SIZE; j++) {
-					int temp = colorGrid[i][j];
-					colorGrid[i][j] = colorGrid[j][i];
-					colorGrid[j][i] = temp;
-				}
+			if (game.getCell(i, j) == 1) {
+				content = fg + BOLD + " Q " + RESET;
 			}
-		}
-		if (transform % 4 >= 2) {
-			for (int i = 0; i < BOARD_SIZE / 2; i++) {
-				for (int j = 0; j < BOARD_SIZE; j++) {
-					int temp = colorGrid[i][j];
-					colorGrid[i][j] = colorGrid[BOARD_SIZE - 1 - i][j];
-					colorGrid[BOARD_SIZE - 1 - i][j] = temp;
-				}
+			else if (game.getCell(i, j) == 2) {
+				content = fg + " X " + RESET;
 			}
-		}
-		if (transform % 2 == 1) {
-			for (int i = 0; i < BOARD_SIZE; i++) {
-				for (int j = 0; j < BOARD_SIZE / 2; j++) {
-					int temp = colorGrid[i][j];
-					colorGrid[i][j] = colorGrid[i][BOARD_SIZE - 1 - j];
-					colorGrid[i][BOARD_SIZE - 1 - j] = temp;
-				}
+			else {
+				content = fg + " . " + RESET;
 			}
-		}
 
-		conflicts.setColorGrid(colorGrid);
-	}
-
-	void displayBoard() {
-		cout << "\n";
-
-		cout << "      ";
-		for (int j = 0; j < BOARD_SIZE; j++) {
-			cout << CYAN << BOLD << " " << j << "  " << RESET;
+			cout << bg << content << RESET << CYAN << "|" << RESET;
 		}
 		cout << "\n";
 
@@ -613,387 +422,621 @@ public:
 			cout << "---+";
 		}
 		cout << RESET << "\n";
+	}
 
-		for (int i = 0; i < BOARD_SIZE; i++) {
-			cout << CYAN << BOLD << "  " << i << "  " << RESET << CYAN << "|" << RESET;
+	cout << "\n" << YELLOW << "Queens: " << game.getQueenCount() << "/8" << RESET;
+	cout << "  |  " << CYAN << "Moves: " << game.getMoveCount() << RESET;
+	cout << "  |  " << GREEN << "Solutions left: " << game.getSolutionsLeft() << RESET << "\n";
 
+	cout << "\n" << WHITE << "Regions: " << RESET;
+	for (int c = 0; c < BOARD_SIZE; c++) {
+		int cnt = 0;
+		for (int i = 0; i < BOARD_SIZE; i++) {
 			for (int j = 0; j < BOARD_SIZE; j++) {
-				int c = colorGrid[i][j];
-				string bg = regionColors[c];
-				string fg = regionTextColors[c];
-				string content;
+				if (game.getColor(i, j) == c && game.getCell(i, j) == 1) cnt++;
+			}
+		}
+		cout << regionColors[c] << regionTextColors[c] << " " << c << ":" << cnt << "/1 " << RESET << " ";
+	}
+	cout << "\n";
+}
 
-				if (board[i][j] == 1) {
-					content = fg + BOLD + " Q " + RESET;
-				}
-				else if (board[i][j] == 2) {
-					content = fg + " X " + RESET;
-				}
-				else {
-					content = fg + " . " + RESET;
-				}
+void showHint(QueensGame& game) {
+	HintResult hint;
+	if (!reportStatus(game.requestHint(hint), -1, -1)) return;
 
-				cout << bg << content << RESET << CYAN << "|" << RESET;
-			}
-			cout << "\n";
+	cout << "\n" << CYAN << BOLD << "=== HINT ===" << RESET << "\n";
+	cout << GREEN << "Suggested move: (" << hint.row << ", " << hint.col << ")\n" << RESET;
+	cout << WHITE << "Reason: " << hintReasons[hint.reason] << "\n" << RESET;
+	cout << YELLOW << "(Queen not placed - make the move yourself!)\n" << RESET;
+}
 
-			cout << "     " << CYAN << "+";
-			for (int j = 0; j < BOARD_SIZE; j++) {
-				cout << "---+";
-			}
-			cout << RESET << "\n";
-		}
+// Name of the change that led to a position in the variation tree.
+string variationAction(VariationNode* node) {
+	if (node->parent == NULL) return "Start";
+	if (node->newState == 1) return "Queen";
+	if (node->newState == 2) return "Mark X";
+	if (node->prevState == 1) return "Remove";
+	return "Clear";
+}
 
-		cout << "\n" << YELLOW << "Queens: " << queenCount << "/8" << RESET;
-		cout << "  |  " << CYAN << "Moves: " << moveCount << RESET << "\n";
+// The moves that built the current position, oldest first, then the undo, redo and jump steps
+// in the order they were taken. An undone move drops out of the first list.
+void showHistory(QueensGame& game) {
+	MoveHistory& history = game.getHistory();
+	VariationTree& variations = game.getVariations();
+	vector<int> solutionsAt(variations.getNodeCount(), -1);
+	vector<MoveNode*> navigation;
+	for (MoveNode* temp = history.getLastMove(); temp != NULL; temp = temp->next) {
+		if (temp->actionType >= 5) navigation.push_back(temp);
+		else if (temp->nodeId < (int)solutionsAt.size() && solutionsAt[temp->nodeId] == -1) solutionsAt[temp->nodeId] = temp->solutionsLeft;
+	}
 
-		cout << "\n" << WHITE << "Regions: " << RESET;
-		for (int c = 0; c < BOARD_SIZE; c++) {
-			int cnt = 0;
-			for (int i = 0; i < BOARD_SIZE; i++) {
-				for (int j = 0; j < BOARD_SIZE; j++) {
-					if (colorGrid[i][j] == c && board[i][j] == 1) cnt++;
-				}
-			}
-			cout << regionColors[c] << regionTextColors[c] << " " << c << ":" << cnt << "/1 " << RESET << " ";
-		}
+	vector<VariationNode*> path;
+	for (VariationNode* node = variations.getCurrent(); node != NULL && node->parent != NULL; node = node->parent) {
+		path.push_back(node);
+	}
+	cout << CYAN << "Move History (" << path.size() << " moves to this position):\n" << RESET;
+	for (int i = (int)path.size() - 1, n = 1; i >= 0; i--, n++) {
+		string action = variationAction(path[i]);
+		if (action == "Queen") action = "Place Queen";
+		else if (action == "Remove") action = "Remove Queen";
+		else if (action == "Clear") action = "Clear Cell";
+		cout << "  " << n << ". " << action << " at (" << path[i]->row << ", " << path[i]->col << ")";
+		if (solutionsAt[path[i]->id] != -1) cout << " - " << solutionsAt[path[i]->id] << " solutions left";
 		cout << "\n";
 	}
 
-	bool isValidPosition(int row, int col) {
-		return row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE;
+	if (navigation.empty()) return;
+	cout << CYAN << "Navigation (" << navigation.size() << " steps):\n" << RESET;
+	for (int i = (int)navigation.size() - 1; i >= 0; i--) {
+		MoveNode* step = navigation[i];
+		string action = step->actionType == 5 ? "Undo" : step->actionType == 6 ? "Redo" : "Jump";
+		cout << "  " << action << " to position #" << step->nodeId << " - " << step->solutionsLeft << " solutions left\n";
 	}
+}
 
-	bool hasDiagonalTouch(int row, int col) {
-		int dr[] = { -1, -1, 1, 1 };
-		int dc[] = { -1, 1, -1, 1 };
+void displayVariation(VariationNode* node, VariationNode* current) {
+	string indent(node->depth * 2, ' ');
+	string action = variationAction(node);
 
-		for (int d = 0; d < 4; d++) {
-			int nr = row + dr[d];
-			int nc = col + dc[d];
-			if (isValidPosition(nr, nc) && board[nr][nc] == 1) {
-				return true;
-			}
-		}
-		return false;
+	cout << (node == current ? YELLOW + BOLD + " > " : "   ") << indent << "#" << node->id << " " << action;
+	if (node->parent != NULL) {
+		cout << " (" << node->row << ", " << node->col << ")";
 	}
+	cout << RESET << "\n";
 
-	bool canPlaceQueen(int row, int col) {
-		if (!isValidPosition(row, col)) return false;
-		if (board[row][col] != 0) return false;
-		if (conflicts.hasRowConflict(row)) return false;
-		if (conflicts.hasColConflict(col)) return false;
-		if (conflicts.hasColorConflict(row, col)) return false;
-		if (hasDiagonalTouch(row, col)) return false;
-		return true;
+	for (VariationNode* child = node->firstChild; child != NULL; child = child->nextSibling) {
+		displayVariation(child, current);
 	}
+}
 
-	void recalculateInvalidMarks() {
-		for (int i = 0; i < BOARD_SIZE; i++) {
-			for (int j = 0; j < BOARD_SIZE; j++) {
-				if (board[i][j] == 2) {
-					board[i][j] = 0;
-				}
-			}
-		}
-
-		for (int i = 0; i < BOARD_SIZE; i++) {
-			for (int j = 0; j < BOARD_SIZE; j++) {
-				if (board[i][j] == 0 && !canPlaceQueen(i, j)) {
-					board[i][j] = 2;
-				}
-			}
-		}
+void showVariations(QueensGame& game) {
+	VariationTree& variations = game.getVariations();
+	cout << CYAN << "Variations (" << variations.getNodeCount() << " positions):\n" << RESET;
+	if (variations.getNodeCount() > 0) {
+		displayVariation(variations.getNode(0), variations.getCurrent());
 	}
+}
 
-	bool placeQueen(int row, int col) {
-		if (!isValidPosition(row, col)) {
-			cout << RED << "Invalid position! Use 0-7 for row and column.\n" << RESET;
-			return false;
-		}
+void showAnalysis(QueensGame& game) {
+	vector<MoveAnalysis> moves;
+	game.analyze(moves);
 
-		if (board[row][col] == 1) {
-			cout << RED << "There's already a queen here!\n" << RESET;
-			return false;
-		}
-
-		if (board[row][col] == 2) {
-			cout << RED << "This cell is marked as invalid. Clear it first or choose another.\n" << RESET;
-			return false;
-		}
+	string labels[5] = { "Forced", "Good", "Neutral", "Mistake", "Wasted" };
+	int totals[5] = { 0, 0, 0, 0, 0 };
+	for (size_t i = 0; i < moves.size(); i++) {
+		totals[moves[i].quality]++;
+	}
 
-		if (!canPlaceQueen(row, col)) {
-			if (conflicts.hasRowConflict(row)) {
-				cout << RED << "Invalid! Row " << row << " already has a queen.\n" << RESET;
-			}
-			else if (conflicts.hasColConflict(col)) {
-				cout << RED << "Invalid! Column " << col << " already has a queen.\n" << RESET;
-			}
-			else if (conflicts.hasColorConflict(row, col)) {
-				cout << RED << "Invalid! This color region already has a queen.\n" << RESET;
-			}
-			else if (hasDiagonalTouch(row, col)) {
-				cout << RED << "Invalid! Queens cannot touch diagonally.\n" << RESET;
-			}
-			return false;
+	cout << "\n" << CYAN << BOLD << "=== Move Analysis ===" << RESET << "\n";
+	for (int q = 0; q < 5; q++) {
+		cout << "  " << labels[q] << ": " << totals[q] << "\n";
+	}
+	for (size_t i = 0; i < moves.size(); i++) {
+		if (moves[i].quality == MOVE_MISTAKE) {
+			cout << RED << "  Move " << i + 1 << " at (" << moves[i].row << ", " << moves[i].col << ") left no solutions ("
+				<< moves[i].solutionsBefore << " -> 0)\n" << RESET;
 		}
+	}
+}
 
-		int prevState = board[row][col];
-		board[row][col] = 1;
-		queenCount++;
-		moveCount++;
-
-		conflicts.addQueen(row, col);
-		history.addMove(row, col, 1);
-		undoRedo.addAction(row, col, prevState, 1);
+void showSolution(QueensGame& game) {
+	int cols[BOARD_SIZE];
+	if (!reportStatus(game.solve(cols), -1, -1)) return;
 
-		recalculateInvalidMarks();
+	cout << "\n" << CYAN << BOLD << "=== SOLUTION ===" << RESET << "\n";
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		cout << "  ";
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			int c = game.getColor(i, j);
+			cout << regionColors[c] << regionTextColors[c] << (cols[i] == j ? " Q " : " . ") << RESET;
+		}
+		cout << "\n";
+	}
+}
 
-		cout << GREEN << "Queen placed at (" << row << ", " << col << ")!\n" << RESET;
-		return true;
+void showTelemetry(QueensGame& game, Telemetry& telemetry) {
+	telemetry.flush();
+	TelemetrySummary summary = telemetry.getSummary();
+	cout << "\n" << CYAN << BOLD << "=== TELEMETRY ===" << RESET << "\n";
+	cout << "Sessions: " << summary.sessions << "  Events: " << summary.events << "  Dropped: " << summary.dropped << "\n";
+	cout << "Games: " << summary.games << "  Won: " << summary.wins << "\n";
+	cout << "Moves: " << summary.moves << " (" << summary.hintedMoves << " following a hint)\n";
+	streamsize precision = cout.precision();
+	cout << fixed << setprecision(2);
+	cout << "Think time: median " << summary.thinkP50Seconds << "s, p99 " << summary.thinkP99Seconds << "s\n";
+
+	PuzzleTelemetry puzzle;
+	if (telemetry.getPuzzle(game.getPuzzleKey(), puzzle)) {
+		cout << "This puzzle: " << puzzle.games << " games, " << puzzle.wins << " won";
+		if (puzzle.wins > 0) cout << ", median solve " << puzzle.medianSolveSeconds << "s";
+		cout << "\n";
 	}
+	cout << defaultfloat;
+	cout.precision(precision);
+	if (telemetry.isLogging()) cout << WHITE << "Events are logged to queens_telemetry.qtel\n" << RESET;
+}
 
-	bool removeQueen(int row, int col) {
-		if (!isValidPosition(row, col)) {
-			cout << RED << "Invalid position!\n" << RESET;
-			return false;
-		}
+void restart(QueensGame& game) {
+	if (game.getMoveCount() > 0) {
+		showAnalysis(game);
+	}
+	game.restart();
+	cout << GREEN << "\n*** New Game Started! ***\n" << RESET;
+}
 
-		if (board[row][col] != 1) {
-			cout << RED << "No queen at this position!\n" << RESET;
-			return false;
-		}
+bool saveToFile(QueensGame& game, string path) {
+	vector<unsigned char> blob = game.saveSession();
+	ofstream out(path.c_str(), ios::binary);
+	if (!out) return false;
+	out.write((const char*)&blob[0], blob.size());
+	return out.good();
+}
 
-		int prevState = board[row][col];
-		board[row][col] = 0;
-		queenCount--;
-		moveCount++;
+bool loadFromFile(QueensGame& game, string path) {
+	ifstream in(path.c_str(), ios::binary);
+	if (!in) return false;
+	vector<unsigned char> blob((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+	return game.loadSession(blob);
+}
 
-		conflicts.removeQueen(row, col);
-		history.addMove(row, col, 2);
-		undoRedo.addAction(row, col, prevState, 0);
+void displayRecord(RecordNode* node) {
+	if (node == NULL) return;
+	displayRecord(node->left);
+	string status = node->won ? GREEN + "Won" + RESET : RED + "Lost" + RESET;
+	cout << "  Game #" << node->gameId << ": " << node->moveCount << " moves - " << status << "\n";
+	displayRecord(node->right);
+}
 
-		recalculateInvalidMarks();
+void displayRecords(GameRecordsBST& records) {
+	cout << CYAN << "\n=== Game Records (sorted by moves) ===\n" << RESET;
+	if (records.getRoot() == NULL) {
+		cout << "  No games played yet.\n";
+		return;
+	}
+	displayRecord(records.getRoot());
+}
 
-		cout << GREEN << "Queen removed from (" << row << ", " << col << ")!\n" << RESET;
-		return true;
+void displaySummary(string name, GameRecordsBST& records) {
+	RecordSummary summary = records.getSummary();
+	cout << "  " << left << setw(8) << name << right;
+	if (summary.games == 0) {
+		cout << "  no games\n";
+		return;
 	}
+	streamsize precision = cout.precision();
+	cout << fixed << setprecision(1)
+		<< "  games " << setw(9) << summary.games
+		<< "  won " << setw(5) << 100.0 * summary.wins / summary.games << "%"
+		<< "  avg moves " << setw(5) << (double)summary.totalMoves / summary.games
+		<< "  median " << setw(3) << summary.medianMoves
+		<< "  hints/game " << setw(5) << (double)summary.hintsUsed / summary.games
+		<< "  dead ends/game " << setw(5) << (double)summary.deadEnds / summary.games << "\n";
+	cout.unsetf(ios::fixed);
+	cout.precision(precision);
+}
 
-	bool markX(int row, int col) {
-		if (!isValidPosition(row, col)) {
-			cout << RED << "Invalid position!\n" << RESET;
-			return false;
+void displayLargeBoard(LargeBoard& large, int top, int left, int height, int width) {
+	int size = large.getSize();
+	if (top > size - height) top = size - height;
+	if (left > size - width) left = size - width;
+	if (top < 0) top = 0;
+	if (left < 0) left = 0;
+
+	cout << "\n" << CYAN << "Rows " << top << "-" << min(size, top + height) - 1 << ", columns " << left << "-"
+		<< min(size, left + width) - 1 << " of " << size << "x" << size << RESET << "\n";
+	for (int i = top; i < top + height && i < size; i++) {
+		cout << CYAN << setw(4) << i << " " << RESET;
+		for (int j = left; j < left + width && j < size; j++) {
+			cout << "\033[48;5;" << 17 + (large.getRegion(i, j) * 37) % 214 << "m";
+			if (large.hasQueen(i, j)) cout << BOLD << WHITE << "Q " << RESET;
+			else if (large.isCandidate(i, j)) cout << BLACK << ". " << RESET;
+			else cout << BLACK << "x " << RESET;
 		}
+		cout << "\n";
+	}
+	cout << YELLOW << "Queens: " << large.getQueenCount() << "/" << size << RESET;
+	cout << "  |  " << CYAN << "Memory: " << large.memoryBytes() / 1024 << " KB" << RESET << "\n";
+}
 
-		if (board[row][col] == 1) {
-			cout << RED << "Cannot mark a queen position!\n" << RESET;
-			return false;
-		}
+void announceWin(QueensGame& game, GameRecordsBST& records) {
+	cout << "\n" << GREEN << BOLD;
+	cout << "**********************************************\n";
+	cout << "*                                            *\n";
+	cout << "*   CONGRATULATIONS! You solved the puzzle!  *\n";
+	cout << "*   All 8 queens placed successfully!        *\n";
+	cout << "*                                            *\n";
+	cout << "**********************************************\n";
+	cout << RESET;
+	cout << YELLOW << "Total moves: " << game.getMoveCount() << "\n" << RESET;
+	showAnalysis(game);
+	records.addRecord(game.getMoveCount(), true);
+}
 
-		if (board[row][col] == 2) {
-			cout << YELLOW << "Already marked as X.\n" << RESET;
-			return false;
-		}
+bool parseNumber(const string& text, int& value) {
+	istringstream in(text);
+	return (in >> value) && in.peek() == EOF;
+}
 
-		int prevState = board[row][col];
-		board[row][col] = 2;
-		moveCount++;
+bool parseCell(const string& text, int& row, int& col) {
+	char comma;
+	istringstream in(text);
+	if (!(in >> row >> comma >> col) || comma != ',') return false;
+	return in.peek() == EOF;
+}
 
-		history.addMove(row, col, 3);
-		undoRedo.addAction(row, col, prevState, 2);
+void runCommands(QueensGame& game, GameRecordsBST& records, const string& line) {
+	istringstream tokens(line);
+	string token;
+	bool won = false;
+	int row, col;
 
-		cout << GREEN << "Marked X at (" << row << ", " << col << ").\n" << RESET;
-		return true;
-	}
+	while (tokens >> token) {
+		char command = (char)tolower(token[0]);
+		string args = token.substr(1);
+		bool needsCell = command == 'q' || command == 'd' || command == 'x' || command == 'c';
 
-	bool clearCell(int row, int col) {
-		if (!isValidPosition(row, col)) {
-			cout << RED << "Invalid position!\n" << RESET;
-			return false;
+		if (needsCell && !parseCell(args, row, col)) {
+			cout << RED << "Bad command '" << token << "': expected " << command << "row,col\n" << RESET;
+			continue;
 		}
-
-		if (board[row][col] == 0) {
-			cout << YELLOW << "Cell is already empty.\n" << RESET;
-			return false;
+		if (!needsCell && command != 'j' && !args.empty()) {
+			cout << RED << "Bad command '" << token << "'\n" << RESET;
+			continue;
 		}
 
-		int prevState = board[row][col];
-
-		if (board[row][col] == 1) {
-			conflicts.removeQueen(row, col);
-			queenCount--;
+		switch (command) {
+		case 'q':
+			placeQueen(game, row, col);
+			if (game.checkWin()) won = true;
+			break;
+		case 'd':
+			removeQueen(game, row, col);
+			break;
+		case 'x':
+			markX(game, row, col);
+			break;
+		case 'c':
+			clearCell(game, row, col);
+			break;
+		case 'u':
+			undo(game);
+			break;
+		case 'r':
+			redo(game);
+			break;
+		case 'h':
+			showHint(game);
+			break;
+		case 'j':
+			if (parseNumber(args, row)) jumpToVariation(game, row);
+			else cout << RED << "Bad command '" << token << "': expected j<position>\n" << RESET;
+			break;
+		default:
+			cout << RED << "Unknown command '" << token << "'\n" << RESET;
+			break;
 		}
-
-		board[row][col] = 0;
-		moveCount++;
-
-		history.addMove(row, col, 4);
-		undoRedo.addAction(row, col, prevState, 0);
-
-		recalculateInvalidMarks();
-
-		cout << GREEN << "Cell cleared at (" << row << ", " << col << ").\n" << RESET;
-		return true;
 	}
 
-	bool undo() {
-		if (!undoRedo.canUndo()) {
-			cout << RED << "Nothing to undo!\n" << RESET;
-			return false;
-		}
-
-		UndoNode* action = undoRedo.undo();
-		if (action == NULL) return false;
-
-		if (action->newState == 1) {
-			conflicts.removeQueen(action->row, action->col);
-			queenCount--;
-		}
-		if (action->prevState == 1) {
-			conflicts.addQueen(action->row, action->col);
-			queenCount++;
-		}
+	displayBoard(game);
+	if (won && game.checkWin()) {
+		announceWin(game, records);
+	}
+}
 
-		board[action->row][action->col] = action->prevState;
-		recalculateInvalidMarks();
+const long long SAT_CONFLICT_LIMIT = 1000000;
 
-		cout << GREEN << "Undo successful!\n" << RESET;
-		return true;
+void runLargeBoard() {
+	int size;
+	cout << "Board size (9-400): ";
+	cin >> size;
+	if (cin.fail() || size < 9 || size > 400) {
+		cin.clear();
+		cin.ignore(10000, '\n');
+		cout << RED << "Invalid size!\n" << RESET;
+		return;
 	}
-
-	bool redo() {
-		if (!undoRedo.canRedo()) {
-			cout << RED << "Nothing to redo!\n" << RESET;
-			return false;
+	cin.ignore(10000, '\n');
+
+	LargeBoard large(size, (unsigned long long)time(NULL));
+	int top = 0, left = 0, row, col;
+	displayLargeBoard(large, top, left, 24, 24);
+
+	string line;
+	while (true) {
+		cout << "Large board (q<row>,<col> d<row>,<col> v<row>,<col> s=solve c=CDCL solve u=unique? b=back): ";
+		if (!getline(cin, line)) return;
+		istringstream tokens(line);
+		string token;
+		while (tokens >> token) {
+			char command = (char)tolower(token[0]);
+			string args = token.substr(1);
+			if (command == 'b') return;
+			if ((command == 'q' || command == 'd' || command == 'v') && !parseCell(args, row, col)) {
+				cout << RED << "Bad command '" << token << "'\n" << RESET;
+				continue;
+			}
+			if ((command == 'q' || command == 'd') && !large.isInside(row, col)) {
+				cout << RED << "Invalid position! Use 0-" << large.getSize() - 1 << ".\n" << RESET;
+			}
+			else if (command == 'q') {
+				if (reportStatus(large.placeQueen(row, col), row, col)) {
+					cout << GREEN << "Queen placed at (" << row << ", " << col << ")!\n" << RESET;
+				}
+			}
+			else if (command == 'd') {
+				if (reportStatus(large.removeQueen(row, col), row, col)) {
+					cout << GREEN << "Queen removed from (" << row << ", " << col << ")!\n" << RESET;
+				}
+			}
+			else if (command == 'v') {
+				top = row;
+				left = col;
+			}
+			else if (command == 's') {
+				chrono::steady_clock::time_point start = chrono::steady_clock::now();
+				bool solved = large.solve(20000000);
+				double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+				if (solved) cout << GREEN << "Solved";
+				else cout << RED << "No solution found";
+				cout << " after " << large.getSolverNodes() << " nodes in " << ms << " ms\n" << RESET;
+			}
+			else if (command == 'c') {
+				chrono::steady_clock::time_point start = chrono::steady_clock::now();
+				SatResult result = large.solveSat(SAT_CONFLICT_LIMIT);
+				double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+				if (result == SAT_SATISFIABLE) cout << GREEN << "Solved";
+				else if (result == SAT_UNSATISFIABLE) cout << RED << "No solution exists with these queens";
+				else cout << RED << "Gave up";
+				cout << " after " << large.getSatConflicts() << " conflicts in " << ms << " ms\n" << RESET;
+			}
+			else if (command == 'u') {
+				vector<int> first, second;
+				SatResult result = large.findSecondSolution(SAT_CONFLICT_LIMIT, first, second);
+				if (result == SAT_UNSATISFIABLE && first.empty()) cout << RED << "The puzzle has no solution";
+				else if (result == SAT_UNSATISFIABLE) cout << GREEN << "The puzzle has exactly one solution";
+				else if (result == SAT_UNKNOWN) cout << RED << "Gave up";
+				else {
+					cout << YELLOW << "Not unique, two solutions differ in rows";
+					for (size_t r = 0; r < first.size(); r++) {
+						if (first[r] != second[r]) cout << " " << r << " (" << first[r] << " vs " << second[r] << ")";
+					}
+				}
+				cout << " after " << large.getSatConflicts() << " conflicts\n" << RESET;
+			}
+			else {
+				cout << RED << "Unknown command '" << token << "'\n" << RESET;
+			}
 		}
+		displayLargeBoard(large, top, left, 24, 24);
+	}
+}
 
-		UndoNode* action = undoRedo.redo();
-		if (action == NULL) return false;
-
-		if (action->prevState == 1) {
-			conflicts.removeQueen(action->row, action->col);
-			queenCount--;
-		}
-		if (action->newState == 1) {
-			conflicts.addQueen(action->row, action->col);
-			queenCount++;
+void displayVariantBoard(int grid[BOARD_SIZE][BOARD_SIZE], unsigned long long placed, unsigned long long blocked) {
+	cout << "\n      ";
+	for (int j = 0; j < BOARD_SIZE; j++) {
+		cout << CYAN << BOLD << " " << j << " " << RESET;
+	}
+	cout << "\n";
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		cout << CYAN << BOLD << "  " << i << "   " << RESET;
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			int cell = i * BOARD_SIZE + j;
+			cout << regionColors[grid[i][j]] << regionTextColors[grid[i][j]];
+			if ((placed >> cell) & 1) cout << BOLD << " Q " << RESET;
+			else if ((blocked >> cell) & 1) cout << " x " << RESET;
+			else cout << " . " << RESET;
 		}
-
-		board[action->row][action->col] = action->newState;
-		recalculateInvalidMarks();
-
-		cout << GREEN << "Redo successful!\n" << RESET;
-		return true;
+		cout << "\n";
 	}
+}
 
-	void showHint() {
-		if (queenCount >= 8) {
-			cout << YELLOW << "Puzzle already solved!\n" << RESET;
+template <class Rules>
+void playVariant() {
+	BasicPuzzleGenerator<Rules> generator;
+	int grid[BOARD_SIZE][BOARD_SIZE];
+	unsigned long long seed = (unsigned long long)time(NULL);
+	int seedsTried = 0;
+	while (!generator.generate(seed++, grid, 64)) {
+		if (++seedsTried == 32) {
+			cout << RED << "Could not generate a uniquely solvable " << Rules::name() << " puzzle.\n" << RESET;
 			return;
 		}
+	}
 
-		int bestRow = -1, bestCol = -1;
-		int minBlockedCells = BOARD_SIZE * BOARD_SIZE + 1;
-		string bestReason = "";
-
-		for (int i = 0; i < BOARD_SIZE; i++) {
-			for (int j = 0; j < BOARD_SIZE; j++) {
-				if (board[i][j] == 0 && canPlaceQueen(i, j)) {
-					int blocked = 0;
-					string reason = "";
-
-					int rowEmpty = 0;
-					for (int c = 0; c < BOARD_SIZE; c++) {
-						if (c != j && board[i][c] == 0) rowEmpty++;
-					}
-
-					int colEmpty = 0;
-					for (int r = 0; r < BOARD_SIZE; r++) {
-						if (r != i && board[r][j] == 0) colEmpty++;
-					}
-
-					int colorEmpty = 0;
-					int color = colorGrid[i][j];
-					for (int r = 0; r < BOARD_SIZE; r++) {
-						for (int c = 0; c < BOARD_SIZE; c++) {
-							if ((r != i || c != j) && colorGrid[r][c] == color && board[r][c] == 0) {
-								colorEmpty++;
-							}
-						}
-					}
-
-					blocked = rowEmpty + colEmpty + colorEmpty;
-
-					int dr[] = { -1, -1, 1, 1 };
-					int dc[] = { -1, 1, -1, 1 };
-					for (int d = 0; d < 4; d++) {
-						int nr = i + dr[d];
-						int nc = j + dc[d];
-						if (isValidPosition(nr, nc) && board[nr][nc] == 0) {
-							blocked++;
-						}
-					}
-
-					if (blocked < minBlockedCells) {
-						minBlockedCells = blocked;
-						bestRow = i;
-						bestCol = j;
-
-						if (rowEmpty <= 1) {
-							reason = "This row has limited options.";
-						}
-						else if (colEmpty <= 1) {
-							reason = "This column has limited options.";
-						}
-						else if (colorEmpty <= 1) {
-							reason = "This color region has limited options.";
-						}
-						else {
-							reason = "This spot keeps more cells open for future moves.";
-						}
-						bestReason = reason;
-					}
+	RuleBoard<Rules> board;
+	board.setRegions(grid);
+	unsigned long long placed = 0;
+	int row, col;
+	cout << YELLOW << Rules::name() << ": " << Rules::PER_UNIT << " per row, column and region\n" << RESET;
+	displayVariantBoard(grid, placed, board.blocked(placed) & ~placed);
+
+	string line;
+	while (true) {
+		cout << "Variant (q<row>,<col> d<row>,<col> s=solve b=back): ";
+		if (!getline(cin, line)) return;
+		istringstream tokens(line);
+		string token;
+		while (tokens >> token) {
+			char command = (char)tolower(token[0]);
+			if (command == 'b') return;
+			if (command == 's') {
+				vector<unsigned long long> found;
+				if (board.listSolutions(0, 1, found) == 0) {
+					cout << RED << "This puzzle has no solution!\n" << RESET;
+					continue;
 				}
+				placed = found[0];
+				continue;
+			}
+			if ((command != 'q' && command != 'd') || !parseCell(token.substr(1), row, col)
+				|| row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE) {
+				cout << RED << "Bad command '" << token << "'\n" << RESET;
+				continue;
+			}
+			unsigned long long bit = 1ULL << (row * BOARD_SIZE + col);
+			if (command == 'd') {
+				if (placed & bit) placed ^= bit;
+				else cout << RED << "No queen at (" << row << ", " << col << ")!\n" << RESET;
+			}
+			else if (!board.canPlace(placed, row, col)) {
+				cout << RED << "Cannot place a queen at (" << row << ", " << col << ")!\n" << RESET;
+			}
+			else {
+				placed |= bit;
 			}
 		}
-
-		if (bestRow == -1) {
-			cout << RED << "No valid moves available! Try undoing some moves.\n" << RESET;
+		displayVariantBoard(grid, placed, board.blocked(placed) & ~placed);
+		if (RuleBoard<Rules>::isSolved(placed)) {
+			cout << GREEN << BOLD << "Solved!\n" << RESET;
 			return;
 		}
+	}
+}
 
-		cout << "\n" << CYAN << BOLD << "=== HINT ===" << RESET << "\n";
-		cout << GREEN << "Suggested move: (" << bestRow << ", " << bestCol << ")\n" << RESET;
-		cout << WHITE << "Reason: " << bestReason << "\n" << RESET;
-		cout << YELLOW << "(Queen not placed - make the move yourself!)\n" << RESET;
+void runVariants() {
+	int choice;
+	cout << "1. " << ClassicRules::name() << "  2. " << ChessDiagonalRules::name() << "  3. "
+		<< StarBattleRules<2>::name() << " (2 per unit)  4. " << KnightExclusionRules::name() << "\nVariant: ";
+	cin >> choice;
+	if (cin.fail()) cin.clear();
+	cin.ignore(10000, '\n');
+	switch (choice) {
+	case 1:
+		playVariant<ClassicRules>();
+		break;
+	case 2:
+		playVariant<ChessDiagonalRules>();
+		break;
+	case 3:
+		playVariant<StarBattleRules<2> >();
+		break;
+	case 4:
+		playVariant<KnightExclusionRules>();
+		break;
+	default:
+		cout << RED << "Invalid variant!\n" << RESET;
+		break;
 	}
+}
 
-	bool checkWin() {
-		return queenCount == 8;
+void runTournament() {
+	long long games;
+	cout << "Number of games: ";
+	cin >> games;
+	if (cin.fail() || games <= 0) {
+		cin.clear();
+		cin.ignore(10000, '\n');
+		cout << RED << "Invalid number!\n" << RESET;
+		return;
 	}
 
-	void restart() {
-		if (moveCount > 0) {
-			records->addRecord(moveCount, checkWin());
-		}
+	int threads = (int)thread::hardware_concurrency();
+	if (threads <= 0) threads = 1;
+	cout << YELLOW << "Playing " << games << " games on " << threads << " threads...\n" << RESET;
 
-		initBoard();
-		generateColorRegions();
-		conflicts.setColorGrid(colorGrid);
+	SelfPlayTournament tournament((unsigned long long)time(NULL));
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	tournament.run(games, threads);
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
 
-		cout << GREEN << "\n*** New Game Started! ***\n" << RESET;
+	cout << CYAN << BOLD << "\n=== Self-Play Results ===" << RESET << "\n";
+	for (int p = 0; p < POLICY_COUNT; p++) {
+		displaySummary(policyNames[p], tournament.getResults(p));
 	}
+	cout << GREEN << "Finished in " << seconds << " s (" << (long long)(games / seconds) << " games/s)\n" << RESET;
+}
 
-	int getMoveCount() {
-		return moveCount;
+// Bots that know the answer but stumble: each one marks a few random cells, then places the
+// solution's queens in a random order, sometimes dropping one and placing it again.
+void runRace() {
+	int players;
+	cout << "Number of players: ";
+	cin >> players;
+	if (cin.fail() || players <= 0) {
+		cin.clear();
+		cin.ignore(10000, '\n');
+		cout << RED << "Invalid number!\n" << RESET;
+		return;
 	}
 
-	void showHistory() {
-		history.display();
+	unsigned long long rng = (unsigned long long)time(NULL);
+	int grid[BOARD_SIZE][BOARD_SIZE];
+	PuzzleGenerator generator;
+	while (!generator.generate(rng++, grid, 64)) {}
+
+	RaceCoordinator race(grid);
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	race.addPlayers(players);
+	const Puzzle* puzzle = race.getPuzzle();
+	for (int player = 0; player < players; player++) {
+		int cells[BOARD_SIZE], count = 0;
+		for (unsigned long long rest = puzzle->solution; rest; rest &= rest - 1) {
+			cells[count++] = LatencyHistogram::highestBit(rest & (0ULL - rest));
+		}
+		for (int k = count - 1; k > 0; k--) {
+			int j = (int)(ZobristKeys::next(rng) % (k + 1));
+			swap(cells[k], cells[j]);
+		}
+		for (int slip = (int)(ZobristKeys::next(rng) % 4); slip > 0; slip--) {
+			int cell = (int)(ZobristKeys::next(rng) % (BOARD_SIZE * BOARD_SIZE));
+			race.move(player, 3, cell / BOARD_SIZE, cell % BOARD_SIZE);
+		}
+		for (int k = 0; k < count; k++) {
+			int row = cells[k] / BOARD_SIZE, col = cells[k] % BOARD_SIZE;
+			if (race.move(player, 1, row, col) == STATUS_MARKED) {
+				race.move(player, 4, row, col);
+				race.move(player, 1, row, col);
+			}
+			if (ZobristKeys::next(rng) % 8 == 0 && k + 1 < count) {
+				race.move(player, 2, row, col);
+				race.move(player, 1, row, col);
+			}
+		}
 	}
-};
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	long long moves = 0;
+	for (int player = 0; player < players; player++) {
+		moves += race.getSession(player).getMoveCount();
+	}
+
+	vector<RaceResult> standings;
+	race.getStandings(standings);
+	cout << CYAN << BOLD << "\n=== Race Results ===" << RESET << "\n";
+	for (size_t k = 0; k < standings.size() && k < 10; k++) {
+		cout << setw(4) << standings[k].rank << ". player " << setw(8) << standings[k].player << "  "
+			<< standings[k].moves << " moves  " << standings[k].millis << " ms\n";
+	}
+	cout << YELLOW << race.getFinisherCount() << " of " << players << " finished, " << moves << " moves in "
+		<< seconds << " s\n" << RESET;
+	cout << WHITE << "Memory: " << sizeof(Puzzle) << " bytes shared + " << sizeof(RaceSession) << " bytes per player\n" << RESET;
+}
+
+int main(int argc, char** argv) {
+	if (argc > 1 && string(argv[1]) == "farm") return runFarm(argc - 2, argv + 2);
+	if (argc > 1 && string(argv[1]) == "fuzz") return runFuzz(argc - 2, argv + 2);
 
-int main() {
 	GameRecordsBST records;
 
 	CircularMenu menu;
@@ -1008,8 +1051,22 @@ int main() {
 	menu.addOption(9, "Restart Game");
 	menu.addOption(10, "View Records");
 	menu.addOption(11, "Exit");
-
+	menu.addOption(12, "Variations");
+	menu.addOption(13, "Stats");
+	menu.addOption(14, "Resume Saved Game");
+	menu.addOption(15, "Large Board Mode");
+	menu.addOption(16, "Self-Play Tournament");
+	menu.addOption(17, "Show Solution");
+	menu.addOption(18, "Telemetry");
+	menu.addOption(19, "Rule Variants");
+	menu.addOption(20, "Race Simulation");
+
+	Telemetry telemetry("queens_telemetry.qtel");
 	QueensGame game(&records);
+	game.setTelemetry(&telemetry);
+#if QUEENS_PROFILING
+	StatsDumper statsDumper("queens_stats.prom", 10, &telemetry);
+#endif
 
 	cout << GREEN << BOLD << "\n";
 	cout << "  ____                              ____                 _      \n";
@@ -1029,15 +1086,27 @@ int main() {
 	cout << "\n" << WHITE << "Legend: " << BOLD << "Q" << RESET << " = Queen, ";
 	cout << RED << "X" << RESET << " = Invalid, " << WHITE << "." << RESET << " = Empty\n";
 
-	game.displayBoard();
+	displayBoard(game);
 
 	bool playing = true;
 	int choice, row, col;
 
 	while (playing) {
 		menu.display();
-		cout << "Enter choice (1-11): ";
-		cin >> choice;
+		cout << "Enter choice (1-" << menu.getSize() << ") or commands (e.g. q3,4 x5,1 u r h): ";
+		cin >> ws;
+		if (cin.eof()) {
+			choice = 11;
+		}
+		else if (isalpha(cin.peek())) {
+			string line;
+			getline(cin, line);
+			runCommands(game, records, line);
+			continue;
+		}
+		else {
+			cin >> choice;
+		}
 
 		if (cin.fail()) {
 			cin.clear();
@@ -1058,19 +1127,10 @@ int main() {
 				cout << RED << "Invalid input!\n" << RESET;
 				break;
 			}
-			game.placeQueen(row, col);
-			game.displayBoard();
+			placeQueen(game, row, col);
+			displayBoard(game);
 			if (game.checkWin()) {
-				cout << "\n" << GREEN << BOLD;
-				cout << "**********************************************\n";
-				cout << "*                                            *\n";
-				cout << "*   CONGRATULATIONS! You solved the puzzle!  *\n";
-				cout << "*   All 8 queens placed successfully!        *\n";
-				cout << "*                                            *\n";
-				cout << "**********************************************\n";
-				cout << RESET;
-				cout << YELLOW << "Total moves: " << game.getMoveCount() << "\n" << RESET;
-				records.addRecord(game.getMoveCount(), true);
+				announceWin(game, records);
 			}
 			break;
 
@@ -1085,8 +1145,8 @@ int main() {
 				cout << RED << "Invalid input!\n" << RESET;
 				break;
 			}
-			game.removeQueen(row, col);
-			game.displayBoard();
+			removeQueen(game, row, col);
+			displayBoard(game);
 			break;
 
 		case 3:
@@ -1100,8 +1160,8 @@ int main() {
 				cout << RED << "Invalid input!\n" << RESET;
 				break;
 			}
-			game.markX(row, col);
-			game.displayBoard();
+			markX(game, row, col);
+			displayBoard(game);
 			break;
 
 		case 4:
@@ -1115,47 +1175,108 @@ int main() {
 				cout << RED << "Invalid input!\n" << RESET;
 				break;
 			}
-			game.clearCell(row, col);
-			game.displayBoard();
+			clearCell(game, row, col);
+			displayBoard(game);
 			break;
 
 		case 5:
-			game.showHint();
+			showHint(game);
 			break;
 
 		case 6:
-			game.undo();
-			game.displayBoard();
+			undo(game);
+			displayBoard(game);
 			break;
 
 		case 7:
-			game.redo();
-			game.displayBoard();
+			redo(game);
+			displayBoard(game);
 			break;
 
 		case 8:
-			game.showHistory();
+			showHistory(game);
 			break;
 
 		case 9:
-			game.restart();
-			game.displayBoard();
+			restart(game);
+			displayBoard(game);
 			break;
 
 		case 10:
-			records.displayRecords();
+			displayRecords(records);
 			break;
 
 		case 11:
 			playing = false;
 			if (game.getMoveCount() > 0 && !game.checkWin()) {
 				records.addRecord(game.getMoveCount(), false);
+				if (saveToFile(game, "queens_save.bin")) {
+					cout << WHITE << "Game saved to queens_save.bin - choose 'Resume Saved Game' next time.\n" << RESET;
+				}
 			}
 			cout << GREEN << "\nThanks for playing! Goodbye!\n" << RESET;
 			break;
 
+		case 12:
+			showVariations(game);
+			cout << "Enter position # to switch to (-1 to stay): ";
+			cin >> row;
+			if (cin.fail()) {
+				cin.clear();
+				cin.ignore(10000, '\n');
+				cout << RED << "Invalid input!\n" << RESET;
+				break;
+			}
+			if (row >= 0 && jumpToVariation(game, row)) {
+				displayBoard(game);
+			}
+			break;
+
+		case 13:
+			displayOperationStats();
+			if (writePrometheus("queens_stats.prom", &telemetry)) {
+				cout << WHITE << "Stats written to queens_stats.prom\n" << RESET;
+			}
+			break;
+
+		case 14:
+			if (loadFromFile(game, "queens_save.bin")) {
+				cout << GREEN << "Saved game restored!\n" << RESET;
+			}
+			else {
+				cout << RED << "No valid saved game found; the current game is unchanged.\n" << RESET;
+			}
+			displayBoard(game);
+			break;
+
+		case 15:
+			runLargeBoard();
+			displayBoard(game);
+			break;
+
+		case 16:
+			runTournament();
+			break;
+
+		case 17:
+			showSolution(game);
+			break;
+
+		case 18:
+			showTelemetry(game, telemetry);
+			break;
+
+		case 19:
+			runVariants();
+			displayBoard(game);
+			break;
+
+		case 20:
+			runRace();
+			break;
+
 		default:
-			cout << RED << "Invalid choice! Please enter 1-11.\n" << RESET;
+			cout << RED << "Invalid choice! Please enter 1-" << menu.getSize() << ".\n" << RESET;
 			break;
 		}
 	}
@@ -0,0 +1,254 @@
+#include "QueensAPI.h"
+#include "QueensEngine.h"
+#include <new>
+using namespace std;
+
+static_assert((int)QUEENS_BAD_SAVE == (int)STATUS_BAD_SAVE, "queens_status must mirror MoveStatus");
+static_assert((int)QUEENS_INVALID_ARGUMENT == (int)STATUS_COUNT, "API-only codes follow MoveStatus");
+static_assert(QUEENS_BOARD_SIZE == BOARD_SIZE, "QUEENS_BOARD_SIZE must match BOARD_SIZE");
+
+struct queens_game {
+	QueensGame game;
+
+	queens_game() : game(NULL, false) {
+	}
+};
+
+static const char* const statusNames[] = {
+	"ok", "out of range", "occupied", "marked", "row conflict", "column conflict",
+	"region conflict", "diagonal touch", "blocked", "no queen", "is queen", "already marked",
+	"already empty", "nothing to undo", "nothing to redo", "same position", "no such position",
+	"already solved", "unsolvable", "no moves", "bad save", "invalid argument", "buffer too small",
+	"out of memory", "internal error"
+};
+
+static bool inside(int row, int col) {
+	return row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE;
+}
+
+// Called from a catch (...) block: nothing may unwind through extern "C", so every exported
+// function that reaches the engine turns whatever it threw into a status.
+static queens_status caughtStatus() {
+	try {
+		throw;
+	} catch (const bad_alloc&) {
+		return QUEENS_OUT_OF_MEMORY;
+	} catch (...) {
+		return QUEENS_INTERNAL_ERROR;
+	}
+}
+
+extern "C" {
+
+queens_game* queens_create(unsigned long long seed) {
+	queens_game* handle = NULL;
+	try {
+		handle = new queens_game;
+		handle->game.seed(seed);
+		handle->game.restart();
+	} catch (...) {
+		delete handle;
+		return NULL;
+	}
+	return handle;
+}
+
+void queens_destroy(queens_game* game) {
+	delete game;
+}
+
+queens_status queens_seed(queens_game* game, unsigned long long seed) {
+	if (game == NULL) return QUEENS_INVALID_ARGUMENT;
+	try {
+		game->game.seed(seed);
+		game->game.restart();
+		return QUEENS_OK;
+	} catch (...) {
+		return caughtStatus();
+	}
+}
+
+queens_status queens_move(queens_game* game, queens_action action, int row, int col) {
+	if (game == NULL) return QUEENS_INVALID_ARGUMENT;
+	try {
+		switch (action) {
+		case QUEENS_PLACE:
+			return (queens_status)game->game.placeQueen(row, col);
+		case QUEENS_REMOVE:
+			return (queens_status)game->game.removeQueen(row, col);
+		case QUEENS_MARK:
+			return (queens_status)game->game.markX(row, col);
+		case QUEENS_CLEAR:
+			return (queens_status)game->game.clearCell(row, col);
+		default:
+			return QUEENS_INVALID_ARGUMENT;
+		}
+	} catch (...) {
+		return caughtStatus();
+	}
+}
+
+queens_status queens_undo(queens_game* game) {
+	if (game == NULL) return QUEENS_INVALID_ARGUMENT;
+	try {
+		return (queens_status)game->game.undo();
+	} catch (...) {
+		return caughtStatus();
+	}
+}
+
+queens_status queens_redo(queens_game* game) {
+	if (game == NULL) return QUEENS_INVALID_ARGUMENT;
+	try {
+		return (queens_status)game->game.redo();
+	} catch (...) {
+		return caughtStatus();
+	}
+}
+
+queens_status queens_hint(queens_game* game, int* row, int* col) {
+	if (game == NULL || row == NULL || col == NULL) return QUEENS_INVALID_ARGUMENT;
+	try {
+		HintResult hint;
+		MoveStatus status = game->game.requestHint(hint);
+		if (status == STATUS_OK) {
+			*row = hint.row;
+			*col = hint.col;
+		}
+		return (queens_status)status;
+	} catch (...) {
+		return caughtStatus();
+	}
+}
+
+queens_status queens_solve(queens_game* game, int cols[QUEENS_BOARD_SIZE]) {
+	if (game == NULL || cols == NULL) return QUEENS_INVALID_ARGUMENT;
+	try {
+		return (queens_status)game->game.solve(cols);
+	} catch (...) {
+		return caughtStatus();
+	}
+}
+
+int queens_verify(queens_game* game, const int cols[QUEENS_BOARD_SIZE]) {
+	if (game == NULL || cols == NULL) return 0;
+	try {
+		return game->game.verify(cols) ? 1 : 0;
+	} catch (...) {
+		return 0;
+	}
+}
+
+queens_status queens_serialize(queens_game* game, unsigned char* buffer, size_t* size) {
+	if (game == NULL || size == NULL) return QUEENS_INVALID_ARGUMENT;
+	try {
+		vector<unsigned char> blob = game->game.saveSession();
+		size_t capacity = *size;
+		*size = blob.size();
+		if (buffer == NULL || capacity < blob.size()) return QUEENS_BUFFER_TOO_SMALL;
+		for (size_t i = 0; i < blob.size(); i++) {
+			buffer[i] = blob[i];
+		}
+		return QUEENS_OK;
+	} catch (...) {
+		return caughtStatus();
+	}
+}
+
+queens_status queens_deserialize(queens_game* game, const unsigned char* buffer, size_t size) {
+	if (game == NULL || buffer == NULL) return QUEENS_INVALID_ARGUMENT;
+	try {
+		vector<unsigned char> blob(buffer, buffer + size);
+		return game->game.loadSession(blob) ? QUEENS_OK : QUEENS_BAD_SAVE;
+	} catch (...) {
+		return caughtStatus();
+	}
+}
+
+queens_status queens_set_puzzle(queens_game* game, const int regions[QUEENS_BOARD_SIZE * QUEENS_BOARD_SIZE]) {
+	if (game == NULL || regions == NULL) return QUEENS_INVALID_ARGUMENT;
+	try {
+		int grid[BOARD_SIZE][BOARD_SIZE];
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			grid[cell / BOARD_SIZE][cell % BOARD_SIZE] = regions[cell];
+		}
+		return (queens_status)game->game.setPuzzle(grid);
+	} catch (...) {
+		return caughtStatus();
+	}
+}
+
+unsigned long long queens_puzzle_key(queens_game* game) {
+	try {
+		return game == NULL ? 0 : game->game.getPuzzleKey();
+	} catch (...) {
+		return 0;
+	}
+}
+
+queens_status queens_load_pack(const unsigned char* buffer, size_t size) {
+	if (buffer == NULL) return QUEENS_INVALID_ARGUMENT;
+	try {
+		vector<unsigned char> blob(buffer, buffer + size);
+		return solutionIndex.loadPack(blob) ? QUEENS_OK : QUEENS_BAD_SAVE;
+	} catch (...) {
+		return caughtStatus();
+	}
+}
+
+int queens_cell(queens_game* game, int row, int col) {
+	if (game == NULL || !inside(row, col)) return -1;
+	try {
+		return game->game.getCell(row, col);
+	} catch (...) {
+		return -1;
+	}
+}
+
+int queens_region(queens_game* game, int row, int col) {
+	if (game == NULL || !inside(row, col)) return -1;
+	try {
+		return game->game.getColor(row, col);
+	} catch (...) {
+		return -1;
+	}
+}
+
+int queens_queen_count(queens_game* game) {
+	try {
+		return game == NULL ? 0 : game->game.getQueenCount();
+	} catch (...) {
+		return 0;
+	}
+}
+
+int queens_move_count(queens_game* game) {
+	try {
+		return game == NULL ? 0 : game->game.getMoveCount();
+	} catch (...) {
+		return 0;
+	}
+}
+
+int queens_solutions_left(queens_game* game) {
+	try {
+		return game == NULL ? 0 : game->game.getSolutionsLeft();
+	} catch (...) {
+		return 0;
+	}
+}
+
+int queens_is_solved(queens_game* game) {
+	try {
+		return game != NULL && game->game.checkWin() ? 1 : 0;
+	} catch (...) {
+		return 0;
+	}
+}
+
+const char* queens_status_name(queens_status status) {
+	if ((int)status < 0 || (int)status > (int)QUEENS_INTERNAL_ERROR) return "unknown";
+	return statusNames[status];
+}
+
+}
@@ -0,0 +1,128 @@
+#ifndef QUEENS_API_H
+#define QUEENS_API_H
+
+#include <stddef.h>
+
+/*
+ * C interface to the Queens engine. Every game is an opaque handle; a handle
+ * may be used from one thread at a time, and separate handles may be used
+ * from separate threads concurrently. Nothing here reads or writes stdio.
+ */
+
+#if defined(_WIN32)
+#if defined(QUEENS_API_EXPORTS)
+#define QUEENS_API __declspec(dllexport)
+#elif defined(QUEENS_API_SHARED)
+#define QUEENS_API __declspec(dllimport)
+#else
+#define QUEENS_API
+#endif
+#else
+#define QUEENS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define QUEENS_BOARD_SIZE 8
+
+typedef struct queens_game queens_game;
+
+/*
+ * Values match MoveStatus in QueensEngine.h; the codes from QUEENS_INVALID_ARGUMENT
+ * on are API-only. QUEENS_OUT_OF_MEMORY and QUEENS_INTERNAL_ERROR mean the engine
+ * failed part-way through the call; destroy the handle rather than keep playing on it.
+ */
+typedef enum queens_status {
+	QUEENS_OK = 0,
+	QUEENS_OUT_OF_RANGE,
+	QUEENS_OCCUPIED,
+	QUEENS_MARKED,
+	QUEENS_ROW_CONFLICT,
+	QUEENS_COL_CONFLICT,
+	QUEENS_REGION_CONFLICT,
+	QUEENS_DIAGONAL_TOUCH,
+	QUEENS_BLOCKED,
+	QUEENS_NO_QUEEN,
+	QUEENS_IS_QUEEN,
+	QUEENS_ALREADY_MARKED,
+	QUEENS_ALREADY_EMPTY,
+	QUEENS_NOTHING_TO_UNDO,
+	QUEENS_NOTHING_TO_REDO,
+	QUEENS_SAME_POSITION,
+	QUEENS_NO_SUCH_POSITION,
+	QUEENS_ALREADY_SOLVED,
+	QUEENS_UNSOLVABLE,
+	QUEENS_NO_MOVES,
+	QUEENS_BAD_SAVE,
+	QUEENS_INVALID_ARGUMENT,
+	QUEENS_BUFFER_TOO_SMALL,
+	QUEENS_OUT_OF_MEMORY,
+	QUEENS_INTERNAL_ERROR
+} queens_status;
+
+/* Same codes as the move history: place, remove, mark X, clear. */
+typedef enum queens_action {
+	QUEENS_PLACE = 1,
+	QUEENS_REMOVE = 2,
+	QUEENS_MARK = 3,
+	QUEENS_CLEAR = 4
+} queens_action;
+
+/*
+ * Creates a game with a puzzle generated from seed. Returns NULL if the game could not be
+ * created. Handles start no threads: hints are computed on the calling thread.
+ */
+QUEENS_API queens_game* queens_create(unsigned long long seed);
+QUEENS_API void queens_destroy(queens_game* game);
+
+/* Starts a new puzzle generated from seed. The same seed always gives the same puzzle. */
+QUEENS_API queens_status queens_seed(queens_game* game, unsigned long long seed);
+
+QUEENS_API queens_status queens_move(queens_game* game, queens_action action, int row, int col);
+QUEENS_API queens_status queens_undo(queens_game* game);
+QUEENS_API queens_status queens_redo(queens_game* game);
+QUEENS_API queens_status queens_hint(queens_game* game, int* row, int* col);
+
+/* Fills cols[row] with a full solution that keeps every queen on the board. */
+QUEENS_API queens_status queens_solve(queens_game* game, int cols[QUEENS_BOARD_SIZE]);
+
+/* Returns 1 if cols[row] solves this game's puzzle, 0 otherwise. */
+QUEENS_API int queens_verify(queens_game* game, const int cols[QUEENS_BOARD_SIZE]);
+
+/*
+ * Writes the save blob into buffer. *size is the buffer capacity on input and
+ * the blob size on output; QUEENS_BUFFER_TOO_SMALL leaves the needed size in *size.
+ */
+QUEENS_API queens_status queens_serialize(queens_game* game, unsigned char* buffer, size_t* size);
+/* Replaces the game with a saved one. On QUEENS_BAD_SAVE the game is left unchanged. */
+QUEENS_API queens_status queens_deserialize(queens_game* game, const unsigned char* buffer, size_t size);
+
+/* Starts a new game on regions[row * 8 + col]; colors 0-7 must all appear. */
+QUEENS_API queens_status queens_set_puzzle(queens_game* game, const int regions[QUEENS_BOARD_SIZE * QUEENS_BOARD_SIZE]);
+
+/* Symmetry- and relabel-independent key of the game's region map. */
+QUEENS_API unsigned long long queens_puzzle_key(queens_game* game);
+
+/*
+ * Adds every puzzle in a "QPAK" pack to the shared solution index, so solve and
+ * verify on those puzzles become lookups. Not safe to call while other threads use games.
+ */
+QUEENS_API queens_status queens_load_pack(const unsigned char* buffer, size_t size);
+
+/* 0 = empty, 1 = queen, 2 = X, -1 = out of range. */
+QUEENS_API int queens_cell(queens_game* game, int row, int col);
+QUEENS_API int queens_region(queens_game* game, int row, int col);
+QUEENS_API int queens_queen_count(queens_game* game);
+QUEENS_API int queens_move_count(queens_game* game);
+QUEENS_API int queens_solutions_left(queens_game* game);
+QUEENS_API int queens_is_solved(queens_game* game);
+
+QUEENS_API const char* queens_status_name(queens_status status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,3333 @@
+#include "QueensEngine.h"
+
+using namespace std;
+
+bool avx2Enabled = cpuHasAvx2();
+
+OperationStats operationStats;
+const ZobristKeys zobrist;
+TranspositionTable sharedTable;
+
+static SolutionIndex shippedSolutions() {
+	SolutionIndex index;
+	index.addShipped();
+	return index;
+}
+
+SolutionIndex solutionIndex = shippedSolutions();
+PuzzleTable puzzleTable;
+
+void OperationStats::merge(int op, unsigned long long totals[LatencyHistogram::BUCKETS], unsigned long long& count) {
+	count = 0;
+	for (int b = 0; b < LatencyHistogram::BUCKETS; b++) {
+		totals[b] = 0;
+		int threads = threadsSeen.load() < MAX_THREADS ? threadsSeen.load() : MAX_THREADS;
+		for (int t = 0; t < threads; t++) {
+			totals[b] += histograms[t][op].buckets[b].load(memory_order_relaxed);
+		}
+		count += totals[b];
+	}
+}
+
+double OperationStats::percentile(unsigned long long totals[LatencyHistogram::BUCKETS], unsigned long long count, double fraction) {
+	if (count == 0) return 0;
+	unsigned long long rank = (unsigned long long)(fraction * (count - 1)) + 1;
+	unsigned long long seen = 0;
+	for (int b = 0; b < LatencyHistogram::BUCKETS; b++) {
+		seen += totals[b];
+		if (seen >= rank) return (double)LatencyHistogram::bucketUpperBound(b);
+	}
+	return 0;
+}
+
+void OperationStats::record(int op, unsigned long long nanos) {
+	static thread_local int slot = -1;
+	if (slot == -1) {
+		slot = threadsSeen.fetch_add(1);
+		if (slot >= MAX_THREADS) slot = MAX_THREADS - 1;
+	}
+	histograms[slot][op].record(nanos);
+}
+
+void MoveHistory::addMove(int row, int col, int actionType, int solutionsLeft, int nodeId) {
+	MoveNode* newNode = new MoveNode;
+	newNode->row = row;
+	newNode->col = col;
+	newNode->actionType = actionType;
+	newNode->solutionsLeft = solutionsLeft;
+	newNode->nodeId = nodeId;
+	newNode->next = head;
+	head = newNode;
+	count++;
+}
+
+void MoveHistory::removeLastMove() {
+	if (head == NULL) return;
+	MoveNode* temp = head;
+	head = head->next;
+	delete temp;
+	count--;
+}
+
+void MoveHistory::clear() {
+	while (head != NULL) {
+		MoveNode* temp = head;
+		head = head->next;
+		delete temp;
+	}
+	count = 0;
+}
+
+VariationNode* VariationTree::createNode(VariationNode* parent, int row, int col, int prevState, int newState) {
+	VariationNode* newNode = new VariationNode;
+	newNode->id = (int)nodes.size();
+	newNode->depth = parent == NULL ? 0 : parent->depth + 1;
+	newNode->row = row;
+	newNode->col = col;
+	newNode->prevState = prevState;
+	newNode->newState = newState;
+	newNode->queens = 0;
+	newNode->marks = 0;
+	newNode->manualMarks = 0;
+	newNode->parent = parent;
+	newNode->firstChild = NULL;
+	newNode->nextSibling = NULL;
+	newNode->lastVisited = NULL;
+	nodes.push_back(newNode);
+	return newNode;
+}
+
+void VariationTree::reset(unsigned long long queens, unsigned long long marks) {
+	clear();
+	current = createNode(NULL, -1, -1, 0, 0);
+	current->queens = queens;
+	current->marks = marks;
+}
+
+VariationNode* VariationTree::addMove(int row, int col, int prevState, int newState, unsigned long long queens, unsigned long long marks, unsigned long long manualMarks) {
+	for (VariationNode* child = current->firstChild; child != NULL; child = child->nextSibling) {
+		if (child->row == row && child->col == col && child->newState == newState &&
+			child->queens == queens && child->marks == marks && child->manualMarks == manualMarks) {
+			current->lastVisited = child;
+			current = child;
+			return child;
+		}
+	}
+
+	VariationNode* newNode = createNode(current, row, col, prevState, newState);
+	newNode->queens = queens;
+	newNode->marks = marks;
+	newNode->manualMarks = manualMarks;
+	newNode->nextSibling = current->firstChild;
+	current->firstChild = newNode;
+	current->lastVisited = newNode;
+	current = newNode;
+	return newNode;
+}
+
+VariationNode* VariationTree::restoreNode(int parentId, int row, int col, int prevState, int newState, unsigned long long queens, unsigned long long marks, unsigned long long manualMarks) {
+	VariationNode* parent = nodes[parentId];
+	VariationNode* newNode = createNode(parent, row, col, prevState, newState);
+	newNode->queens = queens;
+	newNode->marks = marks;
+	newNode->manualMarks = manualMarks;
+	newNode->nextSibling = parent->firstChild;
+	parent->firstChild = newNode;
+	parent->lastVisited = newNode;
+	return newNode;
+}
+
+bool VariationTree::setLastVisited(int id, int childId) {
+	if (id < 0 || id >= (int)nodes.size() || childId < 0 || childId >= (int)nodes.size()) return false;
+	if (childId != 0 && nodes[childId]->parent != nodes[id]) return false;
+	nodes[id]->lastVisited = childId == 0 ? NULL : nodes[childId];
+	return true;
+}
+
+VariationNode* VariationTree::undo() {
+	if (!canUndo()) return NULL;
+	VariationNode* action = current;
+	current = current->parent;
+	return action;
+}
+
+VariationNode* VariationTree::redo() {
+	if (!canRedo()) return NULL;
+	current = current->lastVisited;
+	return current;
+}
+
+VariationNode* VariationTree::jumpTo(int id) {
+	if (id < 0 || id >= (int)nodes.size()) return NULL;
+	VariationNode* target = nodes[id];
+	for (VariationNode* node = target; node->parent != NULL; node = node->parent) {
+		node->parent->lastVisited = node;
+	}
+	current = target;
+	return current;
+}
+
+void VariationTree::clear() {
+	for (size_t i = 0; i < nodes.size(); i++) {
+		delete nodes[i];
+	}
+	nodes.clear();
+	current = NULL;
+}
+
+RecordNode* GameRecordsBST::insert(RecordNode* node, int moves, int id, bool won) {
+	if (node == NULL) {
+		RecordNode* newNode = new RecordNode;
+		newNode->moveCount = moves;
+		newNode->gameId = id;
+		newNode->won = won;
+		newNode->games = 1;
+		newNode->wins = won ? 1 : 0;
+		newNode->hintsUsed = 0;
+		newNode->deadEnds = 0;
+		newNode->left = NULL;
+		newNode->right = NULL;
+		return newNode;
+	}
+	if (moves < node->moveCount) {
+		node->left = insert(node->left, moves, id, won);
+	}
+	else {
+		node->right = insert(node->right, moves, id, won);
+	}
+	return node;
+}
+
+RecordNode* GameRecordsBST::findOrInsert(int moves) {
+	RecordNode** link = &root;
+	while (*link != NULL && (*link)->moveCount != moves) {
+		link = moves < (*link)->moveCount ? &(*link)->left : &(*link)->right;
+	}
+	if (*link == NULL) {
+		*link = insert(NULL, moves, 0, false);
+		(*link)->games = 0;
+	}
+	return *link;
+}
+
+void GameRecordsBST::mergeFrom(RecordNode* node) {
+	if (node == NULL) return;
+	mergeFrom(node->left);
+	addResults(node->moveCount, node->games, node->wins, node->hintsUsed, node->deadEnds);
+	mergeFrom(node->right);
+}
+
+void GameRecordsBST::summarize(RecordNode* node, RecordSummary& summary, int median) {
+	if (node == NULL) return;
+	summarize(node->left, summary, median);
+	if (summary.games < median && summary.games + node->games >= median) summary.medianMoves = node->moveCount;
+	summary.games += node->games;
+	summary.wins += node->wins;
+	summary.totalMoves += (long long)node->games * node->moveCount;
+	summary.hintsUsed += node->hintsUsed;
+	summary.deadEnds += node->deadEnds;
+	summarize(node->right, summary, median);
+}
+
+int GameRecordsBST::winsBelow(RecordNode* node, int moves) {
+	if (node == NULL) return 0;
+	if (node->moveCount >= moves) return winsBelow(node->left, moves);
+	return countWins(node->left) + node->wins + winsBelow(node->right, moves);
+}
+
+RecordNode* GameRecordsBST::findMin(RecordNode* node) {
+	while (node != NULL && node->left != NULL) {
+		node = node->left;
+	}
+	return node;
+}
+
+void GameRecordsBST::destroyTree(RecordNode* node) {
+	if (node == NULL) return;
+	destroyTree(node->left);
+	destroyTree(node->right);
+	delete node;
+}
+
+void GameRecordsBST::addResults(int moves, int games, int wins, long long hintsUsed, long long deadEnds) {
+	RecordNode* node = findOrInsert(moves);
+	node->games += games;
+	node->wins += wins;
+	node->won = node->wins > 0;
+	node->hintsUsed += hintsUsed;
+	node->deadEnds += deadEnds;
+	gameCounter += games;
+}
+
+RecordSummary GameRecordsBST::getSummary() {
+	RecordSummary summary = { 0, 0, 0, 0, 0, 0 };
+	summarize(root, summary, (gameCounter + 1) / 2);
+	return summary;
+}
+
+ConflictGraph::ConflictGraph() {
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		rowConflicts[i] = 0;
+		colConflicts[i] = 0;
+		colorConflicts[i] = 0;
+	}
+}
+
+void ConflictGraph::setColorGrid(int grid[BOARD_SIZE][BOARD_SIZE]) {
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			colorGrid[i][j] = grid[i][j];
+		}
+	}
+}
+
+void ConflictGraph::addQueen(int row, int col) {
+	rowConflicts[row]++;
+	colConflicts[col]++;
+	colorConflicts[colorGrid[row][col]]++;
+}
+
+void ConflictGraph::removeQueen(int row, int col) {
+	rowConflicts[row]--;
+	colConflicts[col]--;
+	colorConflicts[colorGrid[row][col]]--;
+}
+
+void ConflictGraph::reset() {
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		rowConflicts[i] = 0;
+		colConflicts[i] = 0;
+		colorConflicts[i] = 0;
+	}
+}
+
+bool BoardSnapshot::hasDiagonalTouch(int row, int col) {
+	int dr[] = { -1, -1, 1, 1 };
+	int dc[] = { -1, 1, -1, 1 };
+
+	for (int d = 0; d < 4; d++) {
+		int nr = row + dr[d];
+		int nc = col + dc[d];
+		if (isValidPosition(nr, nc) && board[nr][nc] == 1) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool BoardSnapshot::canPlaceQueen(int row, int col) {
+	if (board[row][col] != 0) return false;
+	if (conflicts.hasRowConflict(row)) return false;
+	if (conflicts.hasColConflict(col)) return false;
+	if (conflicts.hasColorConflict(row, col)) return false;
+	if (hasDiagonalTouch(row, col)) return false;
+	return true;
+}
+
+bool BoardSnapshot::findHint(HintResult& result, atomic<unsigned int>& latest, unsigned int generation) {
+	result.row = -1;
+	result.col = -1;
+	result.reason = 0;
+	int minBlockedCells = BOARD_SIZE * BOARD_SIZE + 1;
+
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		if (latest.load() != generation) return false;
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			if (board[i][j] == 0 && canPlaceQueen(i, j)) {
+				int blocked = 0;
+
+				int rowEmpty = 0;
+				for (int c = 0; c < BOARD_SIZE; c++) {
+					if (c != j && board[i][c] == 0) rowEmpty++;
+				}
+
+				int colEmpty = 0;
+				for (int r = 0; r < BOARD_SIZE; r++) {
+					if (r != i && board[r][j] == 0) colEmpty++;
+				}
+
+				int colorEmpty = 0;
+				int color = colorGrid[i][j];
+				for (int r = 0; r < BOARD_SIZE; r++) {
+					for (int c = 0; c < BOARD_SIZE; c++) {
+						if ((r != i || c != j) && colorGrid[r][c] == color && board[r][c] == 0) {
+							colorEmpty++;
+						}
+					}
+				}
+
+				blocked = rowEmpty + colEmpty + colorEmpty;
+
+				int dr[] = { -1, -1, 1, 1 };
+				int dc[] = { -1, 1, -1, 1 };
+				for (int d = 0; d < 4; d++) {
+					int nr = i + dr[d];
+					int nc = j + dc[d];
+					if (isValidPosition(nr, nc) && board[nr][nc] == 0) {
+						blocked++;
+					}
+				}
+
+				if (blocked < minBlockedCells) {
+					minBlockedCells = blocked;
+					result.row = i;
+					result.col = j;
+
+					if (rowEmpty <= 1) {
+						result.reason = 1;
+					}
+					else if (colEmpty <= 1) {
+						result.reason = 2;
+					}
+					else if (colorEmpty <= 1) {
+						result.reason = 3;
+					}
+					else {
+						result.reason = 0;
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+ZobristKeys::ZobristKeys() {
+	unsigned long long state = 0x51A7E5EEDULL;
+	for (int i = 0; i < BOARD_SIZE * BOARD_SIZE; i++) {
+		queenKeys[i] = next(state);
+		for (int c = 0; c < BOARD_SIZE; c++) {
+			colorKeys[i][c] = next(state);
+		}
+	}
+}
+
+bool TranspositionTable::probe(unsigned long long key, TableEntry& entry) {
+	Slot& slot = slots[key & (TABLE_SIZE - 1)];
+	unsigned long long check = slot.check.load(memory_order_acquire);
+	entry.markMask = slot.markMask.load(memory_order_relaxed);
+	entry.data = slot.data.load(memory_order_relaxed);
+	return (check ^ entry.markMask ^ entry.data) == key;
+}
+
+void TranspositionTable::store(unsigned long long key, TableEntry& entry) {
+	Slot& slot = slots[key & (TABLE_SIZE - 1)];
+	slot.markMask.store(entry.markMask, memory_order_relaxed);
+	slot.data.store(entry.data, memory_order_relaxed);
+	slot.check.store(key ^ entry.markMask ^ entry.data, memory_order_release);
+}
+
+void TranspositionTable::getHint(TableEntry& entry, HintResult& hint) {
+	int packed = (int)((entry.data >> 40) & 0xFFF);
+	hint.row = (packed & 0xF) == 0xF ? -1 : (packed & 0xF);
+	hint.col = (packed >> 4) & 0xF;
+	hint.reason = (packed >> 8) & 0x3;
+}
+
+void PuzzleSymmetry::forward(int transform, int& row, int& col) {
+	if (transform >= 4) {
+		int temp = row;
+		row = col;
+		col = temp;
+	}
+	if (transform % 4 >= 2) row = BOARD_SIZE - 1 - row;
+	if (transform % 2 == 1) col = BOARD_SIZE - 1 - col;
+}
+
+void PuzzleSymmetry::inverse(int transform, int& row, int& col) {
+	if (transform % 2 == 1) col = BOARD_SIZE - 1 - col;
+	if (transform % 4 >= 2) row = BOARD_SIZE - 1 - row;
+	if (transform >= 4) {
+		int temp = row;
+		row = col;
+		col = temp;
+	}
+}
+
+bool PuzzleSymmetry::mapSolution(int transform, unsigned int packed, unsigned int& result, bool backward) {
+	result = 0;
+	int rowsSeen = 0;
+	for (int r = 0; r < BOARD_SIZE; r++) {
+		int row = r;
+		int col = (packed >> (3 * r)) & 7;
+		if (backward) inverse(transform, row, col);
+		else forward(transform, row, col);
+		rowsSeen |= 1 << row;
+		result |= (unsigned int)col << (3 * row);
+	}
+	return rowsSeen == (1 << BOARD_SIZE) - 1;
+}
+
+void CanonicalForm::compute(const int grid[BOARD_SIZE][BOARD_SIZE]) {
+	unsigned long long best[4] = { 0, 0, 0, 0 };
+	transform = -1;
+	for (int t = 0; t < 8; t++) {
+		int mapped[BOARD_SIZE][BOARD_SIZE];
+		for (int i = 0; i < BOARD_SIZE; i++) {
+			for (int j = 0; j < BOARD_SIZE; j++) {
+				int row = i, col = j;
+				PuzzleSymmetry::forward(t, row, col);
+				mapped[row][col] = grid[i][j];
+			}
+		}
+
+		int relabel[16];
+		int next = 0;
+		for (int c = 0; c < 16; c++) relabel[c] = -1;
+		unsigned long long words[4] = { 0, 0, 0, 0 };
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			int color = mapped[cell / BOARD_SIZE][cell % BOARD_SIZE] & 15;
+			if (relabel[color] == -1) relabel[color] = next++;
+			mapped[cell / BOARD_SIZE][cell % BOARD_SIZE] = relabel[color];
+			words[cell / 16] |= (unsigned long long)relabel[color] << (60 - 4 * (cell % 16));
+		}
+
+		bool smaller = transform == -1;
+		for (int w = 0; w < 4 && !smaller; w++) {
+			if (words[w] != best[w]) {
+				smaller = words[w] < best[w];
+				break;
+			}
+		}
+		if (smaller) {
+			transform = t;
+			for (int w = 0; w < 4; w++) best[w] = words[w];
+			for (int i = 0; i < BOARD_SIZE; i++) {
+				for (int j = 0; j < BOARD_SIZE; j++) {
+					labels[i][j] = mapped[i][j];
+				}
+			}
+		}
+	}
+
+	unsigned long long state = 0;
+	key = 0;
+	for (int w = 0; w < 4; w++) {
+		state ^= best[w];
+		key ^= ZobristKeys::next(state);
+	}
+}
+
+UniquenessCertificate::UniquenessCertificate(const int grid[BOARD_SIZE][BOARD_SIZE]) {
+	for (int u = 0; u < BOARD_SIZE; u++) {
+		units[u] = 0xFFULL << (BOARD_SIZE * u);
+		units[BOARD_SIZE + u] = 0x0101010101010101ULL << u;
+		units[2 * BOARD_SIZE + u] = 0;
+	}
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		units[2 * BOARD_SIZE + grid[cell / BOARD_SIZE][cell % BOARD_SIZE]] |= 1ULL << cell;
+	}
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		int row = cell / BOARD_SIZE;
+		int col = cell % BOARD_SIZE;
+		peers[cell] = units[row] | units[BOARD_SIZE + col] | units[2 * BOARD_SIZE + grid[row][col]];
+		unitsOf[cell] = (1U << row) | (1U << (BOARD_SIZE + col)) | (1U << (2 * BOARD_SIZE + grid[row][col]));
+		for (int dr = -1; dr <= 1; dr += 2) {
+			for (int dc = -1; dc <= 1; dc += 2) {
+				if (row + dr >= 0 && row + dr < BOARD_SIZE && col + dc >= 0 && col + dc < BOARD_SIZE) {
+					peers[cell] |= 1ULL << ((row + dr) * BOARD_SIZE + col + dc);
+				}
+			}
+		}
+	}
+	solutions = 0;
+	solution = 0;
+}
+
+bool UniquenessCertificate::prove(unsigned long long queens, unsigned long long open, vector<unsigned char>& out) {
+	if (popcount64(queens) == BOARD_SIZE) {
+		solution = queens;
+		return ++solutions == 1;
+	}
+	int best = -1, bestCount = BOARD_SIZE + 1;
+	for (int u = 0; u < UNITS; u++) {
+		if (units[u] & queens) continue;
+		int count = popcount64(units[u] & open);
+		if (count == 0) {
+			out.push_back((unsigned char)(DEAD | u));
+			return true;
+		}
+		if (count < bestCount) {
+			best = u;
+			bestCount = count;
+		}
+	}
+	out.push_back((unsigned char)best);
+	for (unsigned long long rest = units[best] & open; rest; rest &= rest - 1) {
+		int cell = LatencyHistogram::highestBit(rest & (0ULL - rest));
+		if (!prove(queens | (1ULL << cell), open & ~peers[cell], out)) return false;
+	}
+	return true;
+}
+
+bool UniquenessCertificate::check(const vector<unsigned char>& data, size_t& pos, unsigned long long queens, unsigned long long open, unsigned int live) {
+	if (popcount64(queens) == BOARD_SIZE) {
+		solution = queens;
+		return ++solutions == 1;
+	}
+	if (pos >= data.size()) return false;
+	int node = data[pos++];
+	int u = node & ~DEAD;
+	if (u >= UNITS || !((live >> u) & 1)) return false;
+	unsigned long long choices = units[u] & open;
+	if ((node & DEAD) != 0 && choices != 0) return false;
+	// Only the prover's choice is accepted: every earlier unit has more open cells than this
+	// one, and no later one has fewer. Clearing a few of a unit's open cells tells, without a
+	// popcount per unit.
+	int count = popcount64(choices);
+	for (unsigned int rest = live & ~(1U << u); rest; rest &= rest - 1) {
+		int v = LatencyHistogram::highestBit(rest & (0U - rest));
+		int allowed = v < u ? count : count - 1;
+		if (allowed < 0) continue;
+		unsigned long long cells = units[v] & open;
+		for (int k = 0; k < allowed && cells; k++) cells &= cells - 1;
+		if (cells == 0) return false;
+	}
+	if (node & DEAD) return true;
+	if (choices == 0) return false;
+	for (; choices; choices &= choices - 1) {
+		int cell = LatencyHistogram::highestBit(choices & (0ULL - choices));
+		if (!check(data, pos, queens | (1ULL << cell), open & ~peers[cell], live & ~unitsOf[cell])) return false;
+	}
+	return true;
+}
+
+unsigned int UniquenessCertificate::packSolution(unsigned long long queens) {
+	unsigned int packed = 0;
+	for (int row = 0; row < BOARD_SIZE; row++) {
+		packed |= (unsigned int)LatencyHistogram::highestBit((queens >> (BOARD_SIZE * row)) & 0xFF) << (3 * row);
+	}
+	return packed;
+}
+
+bool UniquenessCertificate::build(const int grid[BOARD_SIZE][BOARD_SIZE], vector<unsigned char>& certificate, unsigned int& packed) {
+	UniquenessCertificate proof(grid);
+	certificate.clear();
+	if (!proof.prove(0, ~0ULL, certificate) || proof.solutions != 1) {
+		certificate.clear();
+		return false;
+	}
+	packed = packSolution(proof.solution);
+	return true;
+}
+
+bool UniquenessCertificate::verify(const int grid[BOARD_SIZE][BOARD_SIZE], const vector<unsigned char>& certificate, unsigned int packed) {
+	UniquenessCertificate proof(grid);
+	size_t pos = 0;
+	return proof.check(certificate, pos, 0, ~0ULL, (1U << UNITS) - 1) && pos == certificate.size()
+		&& proof.solutions == 1 && packSolution(proof.solution) == packed;
+}
+
+void SolutionIndex::insert(const int grid[BOARD_SIZE][BOARD_SIZE], const vector<unsigned int>& solutions) {
+	CanonicalForm form;
+	form.compute(grid);
+	SolutionSet set;
+	set.key = form.key;
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			set.labels[i][j] = form.labels[i][j];
+		}
+	}
+	for (size_t k = 0; k < solutions.size(); k++) {
+		unsigned int mapped;
+		if (PuzzleSymmetry::mapSolution(form.transform, solutions[k], mapped, false)) set.solutions.push_back(mapped);
+	}
+	sort(set.solutions.begin(), set.solutions.end());
+	sets.push_back(set);
+}
+
+void SolutionIndex::rebuild() {
+	sort(sets.begin(), sets.end(), byKey);
+	size_t kept = 0;
+	for (size_t i = 0; i < sets.size(); i++) {
+		if (kept > 0 && sets[kept - 1].key == sets[i].key && compareLabels(sets[kept - 1].labels, sets[i].labels) == 0) continue;
+		if (kept != i) sets[kept] = sets[i];
+		kept++;
+	}
+	sets.resize(kept);
+
+	hashSeed = 0;
+	while (!buildHash()) {
+		hashSeed++;
+	}
+}
+
+bool SolutionIndex::buildHash() {
+	size_t bucketCount = sets.size() / 4 + 1;
+	size_t slotCount = sets.size() + sets.size() / 4 + 1;
+	vector<vector<int> > buckets(bucketCount);
+	for (size_t i = 0; i < sets.size(); i++) {
+		if (i > 0 && sets[i - 1].key == sets[i].key) continue;
+		buckets[mix(sets[i].key, 0) % bucketCount].push_back((int)i);
+	}
+	vector<pair<size_t, size_t> > order(bucketCount);
+	for (size_t b = 0; b < bucketCount; b++) order[b] = make_pair(buckets[b].size(), b);
+	sort(order.begin(), order.end(), largerBucket);
+
+	displacements.assign(bucketCount, 0);
+	slots.assign(slotCount, -1);
+	vector<size_t> taken;
+	for (size_t n = 0; n < bucketCount; n++) {
+		vector<int>& bucket = buckets[order[n].second];
+		if (bucket.empty()) break;
+		bool placed = false;
+		for (unsigned int d = 1; d <= MAX_DISPLACEMENT && !placed; d++) {
+			taken.clear();
+			bool fits = true;
+			for (size_t k = 0; k < bucket.size() && fits; k++) {
+				size_t slot = mix(sets[bucket[k]].key, d) % slotCount;
+				fits = slots[slot] == -1;
+				for (size_t t = 0; t < taken.size() && fits; t++) {
+					fits = taken[t] != slot;
+				}
+				taken.push_back(slot);
+			}
+			if (!fits) continue;
+			displacements[order[n].second] = d;
+			for (size_t k = 0; k < bucket.size(); k++) {
+				slots[taken[k]] = bucket[k];
+			}
+			placed = true;
+		}
+		if (!placed) return false;
+	}
+	return true;
+}
+
+void SolutionIndex::addShipped() {
+	for (int m = 0; m < BASE_MAP_COUNT; m++) {
+		vector<unsigned int> solutions(BASE_SOLUTIONS + BASE_SOLUTION_OFFSETS[m], BASE_SOLUTIONS + BASE_SOLUTION_OFFSETS[m + 1]);
+		insert(BASE_MAPS[m], solutions);
+	}
+	rebuild();
+}
+
+void SolutionIndex::addPuzzle(const int grid[BOARD_SIZE][BOARD_SIZE], PuzzleSolver& solver) {
+	int colors[BOARD_SIZE][BOARD_SIZE];
+	int allowed[BOARD_SIZE];
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			colors[i][j] = grid[i][j];
+		}
+		allowed[i] = (1 << BOARD_SIZE) - 1;
+	}
+	vector<unsigned int> solutions;
+	solver.setColorGrid(colors);
+	solver.listSolutions(allowed, solutions);
+	insert(grid, solutions);
+	SolutionSet& set = sets.back();
+	unsigned int proven;
+	if (set.solutions.size() == 1 && (!UniquenessCertificate::build(set.labels, set.certificate, proven) || proven != set.solutions[0])) {
+		set.certificate.clear();
+	}
+}
+
+const SolutionSet* SolutionIndex::find(unsigned long long key, const int labels[BOARD_SIZE][BOARD_SIZE]) const {
+	if (sets.empty()) return NULL;
+	size_t bucket = mix(key, 0) % displacements.size();
+	int index = slots[mix(key, displacements[bucket]) % slots.size()];
+	if (index == -1) return NULL;
+	for (size_t k = (size_t)index; k < sets.size() && sets[k].key == key; k++) {
+		if (compareLabels(sets[k].labels, labels) == 0) return &sets[k];
+	}
+	return NULL;
+}
+
+bool SolutionIndex::checkPuzzle(const int grid[BOARD_SIZE][BOARD_SIZE], const vector<unsigned int>& solutions, const vector<unsigned char>& certificate) {
+	RuleBoard<ClassicRules> board;
+	board.setRegions(grid);
+	for (size_t s = 0; s < solutions.size(); s++) {
+		unsigned long long placed = 0;
+		for (int row = 0; row < BOARD_SIZE; row++) {
+			int col = (solutions[s] >> (3 * row)) & 7;
+			if (!board.canPlace(placed, row, col)) return false;
+			placed |= 1ULL << (row * BOARD_SIZE + col);
+		}
+	}
+	if (certificate.empty()) return true;
+	return solutions.size() == 1 && UniquenessCertificate::verify(grid, certificate, solutions[0]);
+}
+
+vector<unsigned char> SolutionIndex::savePack() const {
+	vector<unsigned char> out;
+	out.push_back('Q');
+	out.push_back('P');
+	out.push_back('A');
+	out.push_back('K');
+	out.push_back((unsigned char)PACK_VERSION);
+	putVarint(out, sets.size());
+	for (size_t k = 0; k < sets.size(); k++) {
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell += 2) {
+			int first = sets[k].labels[cell / BOARD_SIZE][cell % BOARD_SIZE];
+			int second = sets[k].labels[(cell + 1) / BOARD_SIZE][(cell + 1) % BOARD_SIZE];
+			out.push_back((unsigned char)(first | (second << 4)));
+		}
+		putVarint(out, sets[k].solutions.size());
+		for (size_t s = 0; s < sets[k].solutions.size(); s++) {
+			unsigned int packed = sets[k].solutions[s];
+			out.push_back((unsigned char)(packed & 0xFF));
+			out.push_back((unsigned char)((packed >> 8) & 0xFF));
+			out.push_back((unsigned char)(packed >> 16));
+		}
+		putVarint(out, sets[k].certificate.size());
+		out.insert(out.end(), sets[k].certificate.begin(), sets[k].certificate.end());
+	}
+	return out;
+}
+
+bool SolutionIndex::loadPack(const vector<unsigned char>& in, bool rebuildNow, bool checkPuzzles) {
+	if (in.size() < 5 || in[0] != 'Q' || in[1] != 'P' || in[2] != 'A' || in[3] != 'K' || in[4] < 1 || in[4] > PACK_VERSION) return false;
+	int version = in[4];
+	size_t pos = 5;
+	unsigned long long count;
+	if (!getVarint(in, pos, count)) return false;
+
+	size_t before = sets.size();
+	bool valid = true;
+	for (unsigned long long k = 0; k < count && valid; k++) {
+		valid = pos + BOARD_SIZE * BOARD_SIZE / 2 <= in.size();
+		if (!valid) break;
+		int grid[BOARD_SIZE][BOARD_SIZE];
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			unsigned char packed = in[pos + cell / 2];
+			grid[cell / BOARD_SIZE][cell % BOARD_SIZE] = cell % 2 == 0 ? (packed & 0xF) : (packed >> 4);
+			if (grid[cell / BOARD_SIZE][cell % BOARD_SIZE] >= BOARD_SIZE) valid = false;
+		}
+		pos += BOARD_SIZE * BOARD_SIZE / 2;
+
+		unsigned long long solutionCount;
+		valid = valid && getVarint(in, pos, solutionCount) && solutionCount <= (in.size() - pos) / 3;
+		if (!valid) break;
+		vector<unsigned int> solutions;
+		for (unsigned long long s = 0; s < solutionCount; s++) {
+			solutions.push_back(in[pos] | (in[pos + 1] << 8) | (in[pos + 2] << 16));
+			pos += 3;
+		}
+
+		unsigned long long certificateSize = 0;
+		valid = version < 2 || (getVarint(in, pos, certificateSize) && certificateSize <= in.size() - pos);
+		if (!valid) break;
+		vector<unsigned char> certificate(in.begin() + pos, in.begin() + pos + (size_t)certificateSize);
+		pos += (size_t)certificateSize;
+		valid = !checkPuzzles || checkPuzzle(grid, solutions, certificate);
+		if (!valid) break;
+
+		insert(grid, solutions);
+		SolutionSet& set = sets.back();
+		set.certificate.swap(certificate);
+		// The certificate proves the map as the pack stored it; savePack() writes canonical maps,
+		// but one written some other way needs a proof over the canonical labels.
+		unsigned int proven;
+		if (checkPuzzles && !set.certificate.empty() && compareLabels(set.labels, grid) != 0
+			&& (!UniquenessCertificate::build(set.labels, set.certificate, proven) || proven != set.solutions[0])) {
+			set.certificate.clear();
+		}
+	}
+	if (!valid) {
+		sets.resize(before);
+		return false;
+	}
+	if (rebuildNow) rebuild();
+	return true;
+}
+
+Puzzle::Puzzle(const int grid[BOARD_SIZE][BOARD_SIZE], unsigned long long mapKey) {
+	references = 0;
+	key = mapKey;
+	rules.setRegions(grid);
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		int row = cell / BOARD_SIZE;
+		int col = cell % BOARD_SIZE;
+		regions[cell] = (unsigned char)grid[row][col];
+		peers[cell] = (0xFFULL << (BOARD_SIZE * row)) | (0x0101010101010101ULL << col)
+			| rules.getRegionMask(grid[row][col]) | AttackTable<ClassicRules>::instance.masks[cell];
+	}
+	// Runs under the table lock, so stop as soon as a second solution shows the map is not unique.
+	vector<unsigned long long> found;
+	solutionCount = rules.listSolutions(0, 2, found);
+	solution = found.empty() ? 0 : found[0];
+}
+
+bool Puzzle::hasMap(const int grid[BOARD_SIZE][BOARD_SIZE]) const {
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		if (regions[cell] != grid[cell / BOARD_SIZE][cell % BOARD_SIZE]) return false;
+	}
+	return true;
+}
+
+PuzzleTable::~PuzzleTable() {
+	for (PuzzleMap::iterator it = puzzles.begin(); it != puzzles.end(); ++it) {
+		delete it->second;
+	}
+}
+
+Puzzle* PuzzleTable::intern(const int grid[BOARD_SIZE][BOARD_SIZE]) {
+	unsigned long long mapKey = 0;
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		mapKey ^= zobrist.colorKeys[cell][grid[cell / BOARD_SIZE][cell % BOARD_SIZE]];
+	}
+	lock_guard<mutex> guard(lock);
+	pair<PuzzleMap::iterator, PuzzleMap::iterator> range = puzzles.equal_range(mapKey);
+	Puzzle* puzzle = NULL;
+	for (PuzzleMap::iterator it = range.first; it != range.second && puzzle == NULL; ++it) {
+		if (it->second->hasMap(grid)) puzzle = it->second;
+	}
+	if (puzzle == NULL) {
+		puzzle = new Puzzle(grid, mapKey);
+		puzzles.insert(make_pair(mapKey, puzzle));
+	}
+	puzzle->references++;
+	return puzzle;
+}
+
+void PuzzleTable::release(Puzzle* puzzle) {
+	lock_guard<mutex> guard(lock);
+	if (--puzzle->references > 0) return;
+	pair<PuzzleMap::iterator, PuzzleMap::iterator> range = puzzles.equal_range(puzzle->key);
+	for (PuzzleMap::iterator it = range.first; it != range.second; ++it) {
+		if (it->second == puzzle) {
+			puzzles.erase(it);
+			break;
+		}
+	}
+	delete puzzle;
+}
+
+RaceSession::RaceSession(const Puzzle* shared) {
+	puzzle = shared;
+	queens = 0;
+	manualMarks = 0;
+	moves = 0;
+	finishMillis = 0;
+}
+
+unsigned long long RaceSession::getMarks() const {
+	unsigned long long marks = manualMarks;
+	for (unsigned long long rest = queens; rest; rest &= rest - 1) {
+		marks |= puzzle->peers[LatencyHistogram::highestBit(rest & (0ULL - rest))];
+	}
+	return marks & ~queens;
+}
+
+MoveStatus RaceSession::placeQueen(int row, int col) {
+	if (!inside(row, col)) return STATUS_OUT_OF_RANGE;
+	unsigned long long bit = 1ULL << (row * BOARD_SIZE + col);
+	if (queens & bit) return STATUS_OCCUPIED;
+	if (getMarks() & bit) return STATUS_MARKED;
+	queens |= bit;
+	manualMarks = 0;
+	moves++;
+	return STATUS_OK;
+}
+
+MoveStatus RaceSession::removeQueen(int row, int col) {
+	if (!inside(row, col)) return STATUS_OUT_OF_RANGE;
+	unsigned long long bit = 1ULL << (row * BOARD_SIZE + col);
+	if (!(queens & bit)) return STATUS_NO_QUEEN;
+	queens &= ~bit;
+	manualMarks = 0;
+	moves++;
+	return STATUS_OK;
+}
+
+MoveStatus RaceSession::markX(int row, int col) {
+	if (!inside(row, col)) return STATUS_OUT_OF_RANGE;
+	unsigned long long bit = 1ULL << (row * BOARD_SIZE + col);
+	if (queens & bit) return STATUS_IS_QUEEN;
+	if (getMarks() & bit) return STATUS_ALREADY_MARKED;
+	manualMarks |= bit;
+	moves++;
+	return STATUS_OK;
+}
+
+MoveStatus RaceSession::clearCell(int row, int col) {
+	if (!inside(row, col)) return STATUS_OUT_OF_RANGE;
+	unsigned long long bit = 1ULL << (row * BOARD_SIZE + col);
+	if (!((queens | getMarks()) & bit)) return STATUS_ALREADY_EMPTY;
+	queens &= ~bit;
+	manualMarks = 0;
+	moves++;
+	return STATUS_OK;
+}
+
+int RaceSession::getCell(int row, int col) const {
+	int cell = row * BOARD_SIZE + col;
+	if ((queens >> cell) & 1) return 1;
+	return (getMarks() >> cell) & 1 ? 2 : 0;
+}
+
+int RaceCoordinator::addPlayers(int count) {
+	int first = (int)sessions.size();
+	sessions.resize(sessions.size() + count, RaceSession(puzzle));
+	return first;
+}
+
+MoveStatus RaceCoordinator::move(int player, int action, int row, int col) {
+	if (player < 0 || player >= (int)sessions.size()) return STATUS_OUT_OF_RANGE;
+	RaceSession& session = sessions[player];
+	if (session.isSolved()) return STATUS_ALREADY_SOLVED;
+	MoveStatus status;
+	switch (action) {
+	case 1:
+		status = session.placeQueen(row, col);
+		break;
+	case 2:
+		status = session.removeQueen(row, col);
+		break;
+	case 3:
+		status = session.markX(row, col);
+		break;
+	case 4:
+		status = session.clearCell(row, col);
+		break;
+	default:
+		return STATUS_OUT_OF_RANGE;
+	}
+	if (status == STATUS_OK && session.isSolved()) {
+		unsigned long long elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+		session.setFinishMillis((unsigned int)elapsed + 1);
+		lock_guard<mutex> guard(lock);
+		results.addResults(session.getMoveCount(), 1, 1, 0, 0);
+		finishers.push_back(player);
+	}
+	return status;
+}
+
+int RaceCoordinator::getRank(int player) {
+	if (player < 0 || player >= (int)sessions.size() || !sessions[player].isSolved()) return 0;
+	lock_guard<mutex> guard(lock);
+	return results.countWinsBelow(sessions[player].getMoveCount()) + 1;
+}
+
+void RaceCoordinator::getStandings(vector<RaceResult>& out) {
+	lock_guard<mutex> guard(lock);
+	out.clear();
+	for (size_t k = 0; k < finishers.size(); k++) {
+		RaceSession& session = sessions[finishers[k]];
+		RaceResult result = { finishers[k], session.getMoveCount(), session.getFinishMillis(),
+			results.countWinsBelow(session.getMoveCount()) + 1 };
+		out.push_back(result);
+	}
+	stable_sort(out.begin(), out.end(), rankedFirst);
+}
+
+int MoveAnalyzer::count(VariationNode* node) {
+	int allowed[BOARD_SIZE];
+	int full = (1 << BOARD_SIZE) - 1;
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		int rowQueens = (int)((node->queens >> (i * BOARD_SIZE)) & full);
+		allowed[i] = rowQueens != 0 ? rowQueens : full & ~(int)((node->manualMarks >> (i * BOARD_SIZE)) & full);
+	}
+	return solver.countSolutions(allowed);
+}
+
+void MoveAnalyzer::travel(VariationNode* from, VariationNode* to) {
+	while (from->depth > to->depth) {
+		leave(from);
+		from = from->parent;
+	}
+	vector<VariationNode*> path;
+	while (to->depth > from->depth) {
+		path.push_back(to);
+		to = to->parent;
+	}
+	while (from != to) {
+		leave(from);
+		path.push_back(to);
+		from = from->parent;
+		to = to->parent;
+	}
+	for (int k = (int)path.size() - 1; k >= 0; k--) {
+		enter(path[k]);
+	}
+}
+
+void MoveAnalyzer::analyze(MoveNode* lastMove, int colorGrid[BOARD_SIZE][BOARD_SIZE], VariationTree& tree, vector<MoveAnalysis>& result) {
+	vector<MoveNode*> moves;
+	for (MoveNode* temp = lastMove; temp != NULL; temp = temp->next) {
+		moves.push_back(temp);
+	}
+
+	solver.setColorGrid(colorGrid);
+	result.clear();
+	enteredBy.assign(tree.getNodeCount(), -1);
+	undone.clear();
+	vector<bool> takenBack;
+	int placedAt[BOARD_SIZE * BOARD_SIZE];
+	for (int i = 0; i < BOARD_SIZE * BOARD_SIZE; i++) placedAt[i] = -1;
+
+	VariationNode* position = tree.getNode(0);
+	int current = count(position);
+
+	for (int m = (int)moves.size() - 1; m >= 0; m--) {
+		MoveNode* move = moves[m];
+		VariationNode* next = tree.getNode(move->nodeId);
+		if (next == NULL) continue;
+
+		if (move->actionType >= 5) {
+			travel(position, next);
+			position = next;
+			current = count(position);
+			continue;
+		}
+
+		int cell = move->row * BOARD_SIZE + move->col;
+		if (move->actionType != 1 && move->actionType != 3 && (position->queens >> cell) & 1 && placedAt[cell] != -1) {
+			takenBack[placedAt[cell]] = true;
+		}
+
+		MoveAnalysis analysis;
+		analysis.row = move->row;
+		analysis.col = move->col;
+		analysis.actionType = move->actionType;
+		analysis.solutionsBefore = current;
+		current = count(next);
+		analysis.solutionsAfter = current;
+
+		if (analysis.solutionsBefore > 0 && analysis.solutionsAfter == 0) {
+			analysis.quality = MOVE_MISTAKE;
+		}
+		else if (move->actionType == 1 && analysis.solutionsAfter == analysis.solutionsBefore && analysis.solutionsAfter > 0) {
+			analysis.quality = MOVE_FORCED;
+		}
+		else if (analysis.solutionsAfter > 0 && (analysis.solutionsBefore == 0 || analysis.solutionsAfter < analysis.solutionsBefore)) {
+			analysis.quality = MOVE_GOOD;
+		}
+		else {
+			analysis.quality = MOVE_NEUTRAL;
+		}
+
+		if (move->actionType == 1) placedAt[cell] = (int)result.size();
+		enteredBy[next->id] = (int)result.size();
+		result.push_back(analysis);
+		undone.push_back(false);
+		takenBack.push_back(false);
+		position = next;
+	}
+
+	for (size_t k = 0; k < result.size(); k++) {
+		if (undone[k] || takenBack[k]) result[k].quality = MOVE_WASTED;
+	}
+}
+
+bool BatchVerifier::verifyOne(const SolutionBatch& batch, int s) {
+	const int* regions = batch.regionMaps + batch.puzzleIds[s] * BOARD_SIZE * BOARD_SIZE;
+	int rowMask = 0, colMask = 0, colorMask = 0;
+	unsigned long long occupied = 0;
+	for (int k = 0; k < BOARD_SIZE; k++) {
+		int row = batch.queenRows[k][s];
+		int col = batch.queenCols[k][s];
+		if (row >= BOARD_SIZE || col >= BOARD_SIZE) return false;
+		rowMask |= 1 << row;
+		colMask |= 1 << col;
+		colorMask |= 1 << regions[row * BOARD_SIZE + col];
+		occupied |= 1ULL << (row * BOARD_SIZE + col);
+	}
+	int full = (1 << BOARD_SIZE) - 1;
+	if (rowMask != full || colMask != full || colorMask != full) return false;
+	unsigned long long touching = (occupied & ((occupied << 9) & NOT_FIRST_COL)) | (occupied & ((occupied << 7) & NOT_LAST_COL));
+	return touching == 0;
+}
+
+#if QUEENS_AVX2
+QUEENS_AVX2_TARGET int BatchVerifier::verifyEight(const SolutionBatch& batch, int s) {
+	__m256i one = _mm256_set1_epi32(1);
+	__m256i seven = _mm256_set1_epi32(7);
+	__m256i full = _mm256_set1_epi32((1 << BOARD_SIZE) - 1);
+	__m256i ids = _mm256_loadu_si256((const __m256i*)(batch.puzzleIds + s));
+	__m256i base = _mm256_slli_epi32(ids, 6);
+	__m256i rowMask = _mm256_setzero_si256();
+	__m256i colMask = _mm256_setzero_si256();
+	__m256i colorMask = _mm256_setzero_si256();
+	__m256i outOfRange = _mm256_setzero_si256();
+	__m256i rows[BOARD_SIZE];
+	__m256i cols[BOARD_SIZE];
+
+	for (int k = 0; k < BOARD_SIZE; k++) {
+		rows[k] = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(batch.queenRows[k] + s)));
+		cols[k] = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(batch.queenCols[k] + s)));
+		outOfRange = _mm256_or_si256(outOfRange, _mm256_andnot_si256(seven, _mm256_or_si256(rows[k], cols[k])));
+		rowMask = _mm256_or_si256(rowMask, _mm256_sllv_epi32(one, rows[k]));
+		colMask = _mm256_or_si256(colMask, _mm256_sllv_epi32(one, cols[k]));
+		__m256i cell = _mm256_add_epi32(base, _mm256_add_epi32(_mm256_slli_epi32(_mm256_and_si256(rows[k], seven), 3), _mm256_and_si256(cols[k], seven)));
+		__m256i color = _mm256_i32gather_epi32(batch.regionMaps, cell, 4);
+		colorMask = _mm256_or_si256(colorMask, _mm256_sllv_epi32(one, color));
+	}
+
+	__m256i touching = _mm256_setzero_si256();
+	for (int a = 0; a < BOARD_SIZE; a++) {
+		for (int b = a + 1; b < BOARD_SIZE; b++) {
+			__m256i dr = _mm256_abs_epi32(_mm256_sub_epi32(rows[a], rows[b]));
+			__m256i dc = _mm256_abs_epi32(_mm256_sub_epi32(cols[a], cols[b]));
+			touching = _mm256_or_si256(touching, _mm256_and_si256(_mm256_cmpeq_epi32(dr, one), _mm256_cmpeq_epi32(dc, one)));
+		}
+	}
+
+	__m256i valid = _mm256_and_si256(_mm256_cmpeq_epi32(rowMask, full), _mm256_cmpeq_epi32(colMask, full));
+	valid = _mm256_and_si256(valid, _mm256_cmpeq_epi32(colorMask, full));
+	valid = _mm256_and_si256(valid, _mm256_cmpeq_epi32(outOfRange, _mm256_setzero_si256()));
+	valid = _mm256_andnot_si256(touching, valid);
+	return _mm256_movemask_ps(_mm256_castsi256_ps(valid));
+}
+#endif
+void BatchVerifier::verify(const SolutionBatch& batch, unsigned long long* verdicts) {
+	int words = (batch.count + 63) / 64;
+	for (int w = 0; w < words; w++) {
+		verdicts[w] = 0;
+	}
+
+	int s = 0;
+#if QUEENS_AVX2
+	for (; avx2Enabled && s + 8 <= batch.count; s += 8) {
+		verdicts[s / 64] |= (unsigned long long)verifyEight(batch, s) << (s % 64);
+	}
+#endif
+	for (; s < batch.count; s++) {
+		if (verifyOne(batch, s)) {
+			verdicts[s / 64] |= 1ULL << (s % 64);
+		}
+	}
+}
+
+void BatchSolver::buildRegionBits(const int* regions, unsigned int* bits) {
+	for (int r = 0; r < BOARD_SIZE; r++) {
+		unsigned int low = 0, high = 0;
+		for (int k = 0; k < 4; k++) {
+			low |= (1u << regions[r * BOARD_SIZE + 3 - k]) << (8 * k);
+			high |= (1u << regions[r * BOARD_SIZE + 7 - k]) << (8 * k);
+		}
+		bits[2 * r] = low;
+		bits[2 * r + 1] = high;
+	}
+}
+
+int BatchSolver::searchOne(const int* regions, int row, int cols, int regs, int below, unsigned int chosen, int& left, vector<unsigned int>& found) {
+	if (row == BOARD_SIZE) {
+		found.push_back(chosen);
+		left--;
+		return 1;
+	}
+	int total = 0;
+	int open = ~(cols | below) & ((1 << BOARD_SIZE) - 1);
+	while (open && left > 0) {
+		int bit = open & -open;
+		open ^= bit;
+		int col = LatencyHistogram::highestBit((unsigned long long)bit);
+		int region = regions[row * BOARD_SIZE + col];
+		if ((regs >> region) & 1) continue;
+		total += searchOne(regions, row + 1, cols | bit, regs | (1 << region), ((bit << 1) | (bit >> 1)), chosen | (col << (3 * row)), left, found);
+	}
+	return total;
+}
+
+#if QUEENS_AVX2
+QUEENS_AVX2_TARGET void BatchSolver::solveLanes(const unsigned int* bits, int count, int limit, vector<unsigned int>& found, vector<int>& owners) {
+	const int LANES = 8;
+	int puzzle[LANES], left[LANES];
+	alignas(32) int row[LANES], cols[LANES], regs[LANES], chosen[LANES], lowCand[LANES], highCand[LANES];
+	alignas(32) int rowLow[LANES], rowHigh[LANES], base[LANES], live[LANES];
+	int next = 0, running = 0;
+	for (int l = 0; l < LANES; l++) {
+		puzzle[l] = -1;
+		base[l] = 0;
+		live[l] = 0;
+		row[l] = 0;
+	}
+
+	while (true) {
+		// Hand out maps to lanes that are idle, finished or have reached the limit.
+		for (int l = 0; l < LANES; l++) {
+			if (puzzle[l] >= 0 && row[l] == BOARD_SIZE) {
+				found.push_back((unsigned int)chosen[l]);
+				owners.push_back(puzzle[l]);
+				if (--left[l] > 0) continue;
+			}
+			else if (puzzle[l] >= 0 && row[l] >= 0) {
+				continue;
+			}
+			if (puzzle[l] >= 0) running--;
+			puzzle[l] = -1;
+			live[l] = 0;
+			base[l] = 0;
+			row[l] = 0;
+			if (next == count) continue;
+			puzzle[l] = next++;
+			running++;
+			left[l] = limit;
+			live[l] = -1;
+			base[l] = puzzle[l] * 2 * BOARD_SIZE;
+			cols[l] = 0;
+			regs[l] = 0;
+			chosen[l] = 0;
+			lowCand[l] = (1 << BOARD_SIZE) - 1;
+			highCand[l] = 0;
+			rowLow[l] = (int)bits[base[l]];
+			rowHigh[l] = (int)bits[base[l] + 1];
+		}
+		if (running == 0) return;
+
+		__m256i R = _mm256_load_si256((const __m256i*)row);
+		__m256i COLS = _mm256_load_si256((const __m256i*)cols);
+		__m256i REGS = _mm256_load_si256((const __m256i*)regs);
+		__m256i CHOSEN = _mm256_load_si256((const __m256i*)chosen);
+		__m256i LO = _mm256_load_si256((const __m256i*)lowCand);
+		__m256i HI = _mm256_load_si256((const __m256i*)highCand);
+		__m256i ROWLO = _mm256_load_si256((const __m256i*)rowLow);
+		__m256i ROWHI = _mm256_load_si256((const __m256i*)rowHigh);
+		__m256i BASE = _mm256_load_si256((const __m256i*)base);
+		__m256i LIVE = _mm256_load_si256((const __m256i*)live);
+
+		__m256i zero = _mm256_setzero_si256();
+		__m256i one = _mm256_set1_epi32(1);
+		__m256i three = _mm256_set1_epi32(3);
+		__m256i seven = _mm256_set1_epi32(7);
+		__m256i eight = _mm256_set1_epi32(BOARD_SIZE);
+		int events = 0;
+		while (events == 0) {
+			__m256i inHigh = _mm256_cmpgt_epi32(R, three);
+			__m256i shift = _mm256_slli_epi32(_mm256_and_si256(R, three), 3);
+			__m256i words = _mm256_blendv_epi8(LO, HI, inHigh);
+			__m256i cand = _mm256_andnot_si256(_mm256_cmpeq_epi32(R, eight), byteAt(words, shift));
+			__m256i advance = _mm256_andnot_si256(_mm256_cmpeq_epi32(cand, zero), LIVE);
+			__m256i retreat = _mm256_andnot_si256(advance, LIVE);
+
+			// Forward: take the lowest untried column of this row.
+			__m256i bit = _mm256_and_si256(cand, _mm256_sub_epi32(zero, cand));
+			__m256i col = _mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(bit)), 23), _mm256_set1_epi32(127));
+			words = withByte(words, shift, _mm256_xor_si256(cand, bit));
+			__m256i forwardLo = _mm256_blendv_epi8(words, LO, inHigh);
+			__m256i forwardHi = _mm256_blendv_epi8(HI, words, inHigh);
+			__m256i forwardRegs = _mm256_or_si256(REGS, regionOf(ROWLO, ROWHI, col));
+			__m256i forwardCols = _mm256_or_si256(COLS, bit);
+			__m256i forwardChosen = _mm256_or_si256(CHOSEN, _mm256_sllv_epi32(col, _mm256_mullo_epi32(R, three)));
+			__m256i forwardRow = _mm256_add_epi32(R, one);
+
+			// Back: undo the queen of the row above.
+			__m256i backRow = _mm256_sub_epi32(R, one);
+			__m256i backShift = _mm256_mullo_epi32(backRow, three);
+			__m256i backCol = _mm256_and_si256(_mm256_srlv_epi32(CHOSEN, backShift), seven);
+			__m256i backChosen = _mm256_andnot_si256(_mm256_sllv_epi32(seven, backShift), CHOSEN);
+			__m256i backCols = _mm256_andnot_si256(_mm256_sllv_epi32(one, backCol), COLS);
+
+			// Both directions need the region bytes of the row they land on.
+			__m256i target = _mm256_blendv_epi8(backRow, forwardRow, advance);
+			target = _mm256_min_epi32(_mm256_max_epi32(target, zero), seven);
+			__m256i index = _mm256_add_epi32(BASE, _mm256_slli_epi32(target, 1));
+			__m256i nextLo = _mm256_i32gather_epi32((const int*)bits, index, 4);
+			__m256i nextHi = _mm256_i32gather_epi32((const int*)bits, _mm256_add_epi32(index, one), 4);
+			__m256i backRegs = _mm256_andnot_si256(regionOf(nextLo, nextHi, backCol), REGS);
+
+			__m256i touching = _mm256_or_si256(_mm256_slli_epi32(bit, 1), _mm256_srli_epi32(bit, 1));
+			__m256i blocked = _mm256_or_si256(_mm256_or_si256(forwardCols, touching), blockedColumns(nextLo, nextHi, forwardRegs));
+			__m256i open = _mm256_andnot_si256(blocked, _mm256_set1_epi32(0xFF));
+			__m256i openHigh = _mm256_cmpgt_epi32(forwardRow, three);
+			__m256i openShift = _mm256_slli_epi32(_mm256_and_si256(forwardRow, three), 3);
+			__m256i openWords = withByte(_mm256_blendv_epi8(forwardLo, forwardHi, openHigh), openShift, open);
+			__m256i inside = _mm256_cmpgt_epi32(eight, forwardRow);
+			forwardLo = _mm256_blendv_epi8(forwardLo, openWords, _mm256_andnot_si256(openHigh, inside));
+			forwardHi = _mm256_blendv_epi8(forwardHi, openWords, _mm256_and_si256(openHigh, inside));
+
+			R = _mm256_blendv_epi8(_mm256_blendv_epi8(R, backRow, retreat), forwardRow, advance);
+			COLS = _mm256_blendv_epi8(_mm256_blendv_epi8(COLS, backCols, retreat), forwardCols, advance);
+			REGS = _mm256_blendv_epi8(_mm256_blendv_epi8(REGS, backRegs, retreat), forwardRegs, advance);
+			CHOSEN = _mm256_blendv_epi8(_mm256_blendv_epi8(CHOSEN, backChosen, retreat), forwardChosen, advance);
+			LO = _mm256_blendv_epi8(LO, forwardLo, advance);
+			HI = _mm256_blendv_epi8(HI, forwardHi, advance);
+			ROWLO = _mm256_blendv_epi8(ROWLO, nextLo, LIVE);
+			ROWHI = _mm256_blendv_epi8(ROWHI, nextHi, LIVE);
+
+			// A lane that found a solution or ran out of rows needs the scalar loop above.
+			__m256i event = _mm256_or_si256(_mm256_cmpeq_epi32(R, eight), _mm256_cmpgt_epi32(zero, R));
+			events = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(event, LIVE)));
+		}
+
+		_mm256_store_si256((__m256i*)row, R);
+		_mm256_store_si256((__m256i*)cols, COLS);
+		_mm256_store_si256((__m256i*)regs, REGS);
+		_mm256_store_si256((__m256i*)chosen, CHOSEN);
+		_mm256_store_si256((__m256i*)lowCand, LO);
+		_mm256_store_si256((__m256i*)highCand, HI);
+		_mm256_store_si256((__m256i*)rowLow, ROWLO);
+		_mm256_store_si256((__m256i*)rowHigh, ROWHI);
+	}
+}
+#endif
+void BatchSolver::solve(const int* regionMaps, int count, int limit, vector<unsigned int>& solutions, vector<int>& offsets) {
+	solutions.clear();
+	offsets.assign(count + 1, 0);
+	if (limit <= 0) return;
+#if QUEENS_AVX2
+	if (avx2Enabled && count >= 8) {
+		vector<unsigned int> bits((size_t)count * 2 * BOARD_SIZE);
+		for (int p = 0; p < count; p++) {
+			buildRegionBits(regionMaps + p * BOARD_SIZE * BOARD_SIZE, &bits[(size_t)p * 2 * BOARD_SIZE]);
+		}
+		vector<unsigned int> found;
+		vector<int> owners;
+		solveLanes(&bits[0], count, limit, found, owners);
+
+		// Lanes finish in any order; a stable counting sort groups the solutions by map.
+		for (size_t k = 0; k < owners.size(); k++) {
+			offsets[owners[k] + 1]++;
+		}
+		for (int p = 0; p < count; p++) {
+			offsets[p + 1] += offsets[p];
+		}
+		solutions.resize(found.size());
+		vector<int> fill(offsets.begin(), offsets.end() - 1);
+		for (size_t k = 0; k < found.size(); k++) {
+			solutions[fill[owners[k]]++] = found[k];
+		}
+		return;
+	}
+#endif
+	for (int p = 0; p < count; p++) {
+		int left = limit;
+		searchOne(regionMaps + p * BOARD_SIZE * BOARD_SIZE, 0, 0, 0, 0, 0, left, solutions);
+		offsets[p + 1] = (int)solutions.size();
+	}
+}
+
+void SatSolver::siftUp(int index) {
+	int var = heap[index];
+	while (index > 0 && before(var, heap[(index - 1) / 2])) {
+		heap[index] = heap[(index - 1) / 2];
+		heapIndex[heap[index]] = index;
+		index = (index - 1) / 2;
+	}
+	heap[index] = var;
+	heapIndex[var] = index;
+}
+
+void SatSolver::siftDown(int index) {
+	int var = heap[index];
+	int count = (int)heap.size();
+	while (2 * index + 1 < count) {
+		int child = 2 * index + 1;
+		if (child + 1 < count && before(heap[child + 1], heap[child])) child++;
+		if (!before(heap[child], var)) break;
+		heap[index] = heap[child];
+		heapIndex[heap[index]] = index;
+		index = child;
+	}
+	heap[index] = var;
+	heapIndex[var] = index;
+}
+
+void SatSolver::heapInsert(int var) {
+	if (heapIndex[var] != -1) return;
+	heap.push_back(var);
+	siftUp((int)heap.size() - 1);
+}
+
+int SatSolver::heapPop() {
+	int top = heap[0];
+	heapIndex[top] = -1;
+	int last = heap.back();
+	heap.pop_back();
+	if (!heap.empty()) {
+		heap[0] = last;
+		heapIndex[last] = 0;
+		siftDown(0);
+	}
+	return top;
+}
+
+void SatSolver::bump(int var) {
+	activity[var] += activityStep;
+	if (activity[var] > 1e100) {
+		for (size_t v = 0; v < activity.size(); v++) activity[v] *= 1e-100;
+		activityStep *= 1e-100;
+	}
+	if (heapIndex[var] != -1) siftUp(heapIndex[var]);
+}
+
+void SatSolver::enqueue(int lit, int reason) {
+	int var = lit >> 1;
+	values[var] = (signed char)((lit & 1) ^ 1);
+	levels[var] = decisionLevel();
+	reasons[var] = reason;
+	trail.push_back(lit);
+}
+
+void SatSolver::cancelUntil(int level) {
+	if (decisionLevel() <= level) return;
+	for (size_t k = trail.size(); k-- > (size_t)trailLimits[level];) {
+		int var = trail[k] >> 1;
+		phases[var] = values[var];
+		values[var] = -1;
+		reasons[var] = -1;
+		heapInsert(var);
+	}
+	trail.resize(trailLimits[level]);
+	trailLimits.resize(level);
+	propagated = trail.size();
+}
+
+void SatSolver::watch(int ref) {
+	Watch first = { ref, arena[ref + HEADER + 1] };
+	Watch second = { ref, arena[ref + HEADER] };
+	watches[arena[ref + HEADER]].push_back(first);
+	watches[arena[ref + HEADER + 1]].push_back(second);
+}
+
+int SatSolver::store(const vector<int>& lits, bool isLearnt, int lbd) {
+	int ref = (int)arena.size();
+	arena.push_back((int)lits.size());
+	arena.push_back((lbd << 1) | (isLearnt ? 1 : 0));
+	arena.insert(arena.end(), lits.begin(), lits.end());
+	if (isLearnt) learnts.push_back(ref);
+	else originals.push_back(ref);
+	watch(ref);
+	return ref;
+}
+
+int SatSolver::propagate() {
+	int conflict = -1;
+	while (propagated < trail.size() && conflict == -1) {
+		int falseLit = trail[propagated++] ^ 1;
+		propagations++;
+		vector<Watch>& list = watches[falseLit];
+		size_t i = 0, j = 0;
+		while (i < list.size()) {
+			Watch w = list[i++];
+			if (valueOf(w.blocker) == 1) {
+				list[j++] = w;
+				continue;
+			}
+			int* lits = &arena[w.clause + HEADER];
+			int size = arena[w.clause];
+			if (lits[0] == falseLit) {
+				lits[0] = lits[1];
+				lits[1] = falseLit;
+			}
+			Watch kept = { w.clause, lits[0] };
+			if (lits[0] != w.blocker && valueOf(lits[0]) == 1) {
+				list[j++] = kept;
+				continue;
+			}
+
+			bool moved = false;
+			for (int k = 2; k < size; k++) {
+				if (valueOf(lits[k]) != 0) {
+					lits[1] = lits[k];
+					lits[k] = falseLit;
+					Watch moving = { w.clause, lits[0] };
+					watches[lits[1]].push_back(moving);
+					moved = true;
+					break;
+				}
+			}
+			if (moved) continue;
+
+			list[j++] = kept;
+			if (valueOf(lits[0]) == 0) {
+				conflict = w.clause;
+				while (i < list.size()) list[j++] = list[i++];
+			}
+			else {
+				enqueue(lits[0], w.clause);
+			}
+		}
+		list.resize(j);
+	}
+	return conflict;
+}
+
+bool SatSolver::redundant(int lit) {
+	int reason = reasons[lit >> 1];
+	if (reason == -1) return false;
+	for (int k = 1; k < arena[reason]; k++) {
+		int var = arena[reason + HEADER + k] >> 1;
+		if (!seen[var] && levels[var] > 0) return false;
+	}
+	return true;
+}
+
+void SatSolver::analyze(int conflict, int& backtrackLevel, int& lbd) {
+	learnt.clear();
+	learnt.push_back(-1);
+	toClear.clear();
+	int pending = 0;
+	int lit = -1;
+	size_t index = trail.size();
+	int ref = conflict;
+	do {
+		int* lits = &arena[ref + HEADER];
+		for (int k = lit == -1 ? 0 : 1; k < arena[ref]; k++) {
+			int var = lits[k] >> 1;
+			if (seen[var] || levels[var] == 0) continue;
+			seen[var] = 1;
+			toClear.push_back(var);
+			bump(var);
+			if (levels[var] >= decisionLevel()) pending++;
+			else learnt.push_back(lits[k]);
+		}
+		while (!seen[trail[--index] >> 1]);
+		lit = trail[index];
+		ref = reasons[lit >> 1];
+		seen[lit >> 1] = 0;
+		pending--;
+	} while (pending > 0);
+	learnt[0] = lit ^ 1;
+
+	size_t kept = 1;
+	for (size_t k = 1; k < learnt.size(); k++) {
+		if (!redundant(learnt[k])) learnt[kept++] = learnt[k];
+	}
+	learnt.resize(kept);
+	for (size_t k = 0; k < toClear.size(); k++) seen[toClear[k]] = 0;
+
+	backtrackLevel = 0;
+	for (size_t k = 1; k < learnt.size(); k++) {
+		if (levels[learnt[k] >> 1] > backtrackLevel) {
+			backtrackLevel = levels[learnt[k] >> 1];
+			int temp = learnt[1];
+			learnt[1] = learnt[k];
+			learnt[k] = temp;
+		}
+	}
+
+	stampCounter++;
+	lbd = 0;
+	for (size_t k = 0; k < learnt.size(); k++) {
+		int level = levels[learnt[k] >> 1];
+		if (levelStamp[level] != stampCounter) {
+			levelStamp[level] = stampCounter;
+			lbd++;
+		}
+	}
+}
+
+void SatSolver::reduce() {
+	vector<pair<int, int> > ranked;
+	for (size_t k = 0; k < learnts.size(); k++) {
+		ranked.push_back(make_pair(arena[learnts[k] + 1] >> 1, learnts[k]));
+	}
+	stable_sort(ranked.begin(), ranked.end(), higherLbd);
+	vector<char> drop(ranked.size(), 0);
+	for (size_t k = 0; k < ranked.size() / 2; k++) {
+		if (ranked[k].first > 2 && !locked(ranked[k].second)) drop[k] = 1;
+	}
+
+	vector<int> compacted;
+	compacted.reserve(arena.size());
+	vector<int> moved(arena.size(), -1);
+	for (size_t k = 0; k < originals.size(); k++) {
+		int ref = originals[k];
+		moved[ref] = (int)compacted.size();
+		compacted.insert(compacted.end(), arena.begin() + ref, arena.begin() + ref + HEADER + arena[ref]);
+		originals[k] = moved[ref];
+	}
+	learnts.clear();
+	for (size_t k = 0; k < ranked.size(); k++) {
+		if (drop[k]) continue;
+		int ref = ranked[k].second;
+		moved[ref] = (int)compacted.size();
+		compacted.insert(compacted.end(), arena.begin() + ref, arena.begin() + ref + HEADER + arena[ref]);
+		learnts.push_back(moved[ref]);
+	}
+	for (size_t k = 0; k < trail.size(); k++) {
+		int var = trail[k] >> 1;
+		if (reasons[var] != -1) reasons[var] = moved[reasons[var]];
+	}
+	arena.swap(compacted);
+	for (size_t l = 0; l < watches.size(); l++) watches[l].clear();
+	for (size_t k = 0; k < originals.size(); k++) watch(originals[k]);
+	for (size_t k = 0; k < learnts.size(); k++) watch(learnts[k]);
+}
+
+long long SatSolver::luby(int index) {
+	long long size = 1;
+	int levelsUp = 0;
+	while (size < index + 1) {
+		levelsUp++;
+		size = 2 * size + 1;
+	}
+	while (size - 1 != index) {
+		size = (size - 1) / 2;
+		levelsUp--;
+		index %= (int)size;
+	}
+	return 1LL << levelsUp;
+}
+
+SatResult SatSolver::search(long long budget, long long stopAt) {
+	long long found = 0;
+	while (true) {
+		int conflict = propagate();
+		if (conflict != -1) {
+			conflicts++;
+			found++;
+			if (decisionLevel() == 0) {
+				broken = true;
+				return SAT_UNSATISFIABLE;
+			}
+			int backtrackLevel, lbd;
+			analyze(conflict, backtrackLevel, lbd);
+			cancelUntil(backtrackLevel);
+			if (learnt.size() == 1) enqueue(learnt[0], -1);
+			else enqueue(learnt[0], store(learnt, true, lbd));
+			activityStep /= 0.95;
+			continue;
+		}
+
+		if (found >= budget || (stopAt >= 0 && conflicts >= stopAt)) {
+			cancelUntil(0);
+			return SAT_UNKNOWN;
+		}
+		if (learnts.size() >= learntLimit + originals.size() / 3) {
+			reduce();
+			learntLimit += learntLimit / 10;
+		}
+
+		int var = -1;
+		while (!heap.empty()) {
+			var = heapPop();
+			if (values[var] == -1) break;
+			var = -1;
+		}
+		if (var == -1) {
+			model.assign(values.begin(), values.end());
+			cancelUntil(0);
+			return SAT_SATISFIABLE;
+		}
+		decisions++;
+		trailLimits.push_back((int)trail.size());
+		enqueue(2 * var + (phases[var] == 1 ? 0 : 1), -1);
+	}
+}
+
+SatSolver::SatSolver() {
+	stampCounter = 0;
+	levelStamp.push_back(0);
+	propagated = 0;
+	activityStep = 1;
+	learntLimit = 2000;
+	broken = false;
+	conflicts = 0;
+	decisions = 0;
+	propagations = 0;
+}
+
+int SatSolver::newVar(bool preferTrue) {
+	int var = (int)values.size();
+	values.push_back(-1);
+	phases.push_back(preferTrue ? 1 : 0);
+	levels.push_back(0);
+	reasons.push_back(-1);
+	activity.push_back(0);
+	heapIndex.push_back(-1);
+	seen.push_back(0);
+	levelStamp.push_back(0);
+	watches.resize(2 * values.size());
+	heapInsert(var);
+	return var;
+}
+
+bool SatSolver::addClause(vector<int> lits) {
+	if (broken) return false;
+	cancelUntil(0);
+	sort(lits.begin(), lits.end());
+	size_t kept = 0;
+	for (size_t k = 0; k < lits.size(); k++) {
+		int value = valueOf(lits[k]);
+		if (value == 1 || (kept > 0 && lits[kept - 1] == (lits[k] ^ 1))) return true;
+		if (value == 0 || (kept > 0 && lits[kept - 1] == lits[k])) continue;
+		lits[kept++] = lits[k];
+	}
+	lits.resize(kept);
+	if (lits.empty()) {
+		broken = true;
+		return false;
+	}
+	if (lits.size() == 1) enqueue(lits[0], -1);
+	else store(lits, false, 0);
+	return true;
+}
+
+SatResult SatSolver::solve(long long conflictLimit) {
+	model.clear();
+	if (broken) return SAT_UNSATISFIABLE;
+	if (propagate() != -1) {
+		broken = true;
+		return SAT_UNSATISFIABLE;
+	}
+	long long stopAt = conflictLimit < 0 ? -1 : conflicts + conflictLimit;
+	for (int restart = 0; ; restart++) {
+		SatResult result = search(luby(restart) * RESTART_BASE, stopAt);
+		if (result != SAT_UNKNOWN) return result;
+		if (stopAt >= 0 && conflicts >= stopAt) return SAT_UNKNOWN;
+	}
+}
+
+void QueensEncoding::addBinary(int a, int b) {
+	clause.assign(1, a);
+	clause.push_back(b);
+	sat.addClause(clause);
+}
+
+void QueensEncoding::exactlyOne(const vector<int>& cells) {
+	clause.clear();
+	for (size_t k = 0; k < cells.size(); k++) clause.push_back(2 * cells[k]);
+	sat.addClause(clause);
+
+	int k = (int)cells.size();
+	if (k <= 4) {
+		for (int a = 0; a < k; a++) {
+			for (int b = a + 1; b < k; b++) addBinary(2 * cells[a] + 1, 2 * cells[b] + 1);
+		}
+		return;
+	}
+	int previous = sat.newVar();
+	addBinary(2 * cells[0] + 1, 2 * previous);
+	for (int i = 1; i < k - 1; i++) {
+		int counter = sat.newVar();
+		addBinary(2 * cells[i] + 1, 2 * counter);
+		addBinary(2 * previous + 1, 2 * counter);
+		addBinary(2 * cells[i] + 1, 2 * previous + 1);
+		previous = counter;
+	}
+	addBinary(2 * cells[k - 1] + 1, 2 * previous + 1);
+}
+
+QueensEncoding::QueensEncoding(int n, const vector<int>& regionOf) {
+	size = n;
+	for (int cell = 0; cell < n * n; cell++) sat.newVar();
+
+	vector<vector<int> > regions(n);
+	for (int cell = 0; cell < n * n; cell++) regions[regionOf[cell]].push_back(cell);
+	// Start with cells of small regions, like the MRV search does.
+	for (int cell = 0; cell < n * n; cell++) sat.prioritize(cell, 1.0 / regions[regionOf[cell]].size());
+	vector<int> line(n);
+	for (int r = 0; r < n; r++) {
+		for (int c = 0; c < n; c++) line[c] = r * n + c;
+		exactlyOne(line);
+	}
+	for (int c = 0; c < n; c++) {
+		for (int r = 0; r < n; r++) line[r] = r * n + c;
+		exactlyOne(line);
+	}
+	for (int g = 0; g < n; g++) exactlyOne(regions[g]);
+
+	for (int r = 0; r + 1 < n; r++) {
+		for (int c = 0; c < n; c++) {
+			if (c > 0) addBinary(2 * (r * n + c) + 1, 2 * ((r + 1) * n + c - 1) + 1);
+			if (c + 1 < n) addBinary(2 * (r * n + c) + 1, 2 * ((r + 1) * n + c + 1) + 1);
+		}
+	}
+}
+
+SatResult QueensEncoding::solve(long long conflictLimit, vector<int>& cols) {
+	SatResult result = sat.solve(conflictLimit);
+	if (result != SAT_SATISFIABLE) return result;
+	cols.assign(size, -1);
+	for (int cell = 0; cell < size * size; cell++) {
+		if (sat.model[cell] == 1) cols[cell / size] = cell % size;
+	}
+	return result;
+}
+
+SatResult QueensEncoding::findAnother(const vector<int>& cols, long long conflictLimit, vector<int>& other) {
+	clause.clear();
+	for (int r = 0; r < size; r++) clause.push_back(2 * (r * size + cols[r]) + 1);
+	sat.addClause(clause);
+	return solve(conflictLimit, other);
+}
+
+void LargeBoard::removeCandidate(int row, int col) {
+	if (!isCandidate(row, col)) return;
+	rowCandidates[row * words + col / 64] &= ~(1ULL << (col % 64));
+	colCandidates[col * words + row / 64] &= ~(1ULL << (row % 64));
+	int region = regionOf[row * size + col];
+	if (--rowCount[row] == 0 && queenInRow[row] == -1) deadEnd = true;
+	if (--colCount[col] == 0 && queenInCol[col] == -1) deadEnd = true;
+	if (--regionCount[region] == 0 && queenInRegion[region] == -1) deadEnd = true;
+	trail.push_back(row * size + col);
+}
+
+void LargeBoard::restoreIfFree(int row, int col) {
+	if (isCandidate(row, col)) return;
+	int region = regionOf[row * size + col];
+	if (queenInRow[row] != -1 || queenInCol[col] != -1 || queenInRegion[region] != -1) return;
+	for (int dr = -1; dr <= 1; dr += 2) {
+		if (row + dr < 0 || row + dr >= size) continue;
+		int other = queenInRow[row + dr];
+		if (other != -1 && (other == col - 1 || other == col + 1)) return;
+	}
+	rowCandidates[row * words + col / 64] |= 1ULL << (col % 64);
+	colCandidates[col * words + row / 64] |= 1ULL << (row % 64);
+	rowCount[row]++;
+	colCount[col]++;
+	regionCount[region]++;
+}
+
+void LargeBoard::restoreTo(int mark) {
+	while ((int)trail.size() > mark) {
+		int cell = trail.back();
+		trail.pop_back();
+		int row = cell / size;
+		int col = cell % size;
+		rowCandidates[row * words + col / 64] |= 1ULL << (col % 64);
+		colCandidates[col * words + row / 64] |= 1ULL << (row % 64);
+		rowCount[row]++;
+		colCount[col]++;
+		regionCount[regionOf[cell]]++;
+	}
+}
+
+void LargeBoard::assign(int row, int col) {
+	int region = regionOf[row * size + col];
+	queenInRow[row] = col;
+	queenInCol[col] = row;
+	queenInRegion[region] = row * size + col;
+	placed.push_back(row * size + col);
+	queenCount++;
+
+	for (int w = 0; w < words; w++) {
+		while (rowCandidates[row * words + w] != 0) {
+			unsigned long long bits = rowCandidates[row * words + w];
+			removeCandidate(row, w * 64 + LatencyHistogram::highestBit(bits));
+		}
+		while (colCandidates[col * words + w] != 0) {
+			unsigned long long bits = colCandidates[col * words + w];
+			removeCandidate(w * 64 + LatencyHistogram::highestBit(bits), col);
+		}
+	}
+	for (size_t k = 0; k < regionCells[region].size(); k++) {
+		int cell = regionCells[region][k];
+		removeCandidate(cell / size, cell % size);
+	}
+	int dr[] = { -1, -1, 1, 1 };
+	int dc[] = { -1, 1, -1, 1 };
+	for (int d = 0; d < 4; d++) {
+		if (isInside(row + dr[d], col + dc[d])) {
+			removeCandidate(row + dr[d], col + dc[d]);
+		}
+	}
+}
+
+void LargeBoard::unassign(int trailMark) {
+	int cell = placed.back();
+	placed.pop_back();
+	queenInRow[cell / size] = -1;
+	queenInCol[cell % size] = -1;
+	queenInRegion[regionOf[cell]] = -1;
+	queenCount--;
+	restoreTo(trailMark);
+	deadEnd = false;
+}
+
+bool LargeBoard::buildSolution(vector<int>& cols, int row) {
+	if (row == size) return true;
+	vector<int> order(size);
+	for (int c = 0; c < size; c++) order[c] = c;
+	for (int c = size - 1; c > 0; c--) {
+		int j = random(c + 1);
+		int temp = order[c];
+		order[c] = order[j];
+		order[j] = temp;
+	}
+	for (int k = 0; k < size; k++) {
+		int c = order[k];
+		if (queenInCol[c] != -1) continue;
+		if (row > 0 && (cols[row - 1] == c - 1 || cols[row - 1] == c + 1)) continue;
+		cols[row] = c;
+		queenInCol[c] = row;
+		if (buildSolution(cols, row + 1)) return true;
+		queenInCol[c] = -1;
+	}
+	return false;
+}
+
+void LargeBoard::rebuildCandidates() {
+	trail.clear();
+	placed.clear();
+	queenCount = 0;
+	deadEnd = false;
+	for (int i = 0; i < size; i++) {
+		queenInRow[i] = -1;
+		queenInCol[i] = -1;
+		queenInRegion[i] = -1;
+		rowCount[i] = size;
+		colCount[i] = size;
+		regionCount[i] = (int)regionCells[i].size();
+	}
+	for (size_t k = 0; k < rowCandidates.size(); k++) {
+		rowCandidates[k] = ~0ULL;
+		colCandidates[k] = ~0ULL;
+	}
+	if (size % 64 != 0) {
+		for (int i = 0; i < size; i++) {
+			rowCandidates[i * words + words - 1] = (1ULL << (size % 64)) - 1;
+			colCandidates[i * words + words - 1] = (1ULL << (size % 64)) - 1;
+		}
+	}
+	trail.clear();
+}
+
+bool LargeBoard::search(long long nodeLimit) {
+	if (queenCount == size) return true;
+	if (++solverNodes > nodeLimit) return false;
+
+	int best = -1;
+	for (int g = 0; g < size; g++) {
+		if (queenInRegion[g] != -1) continue;
+		if (best == -1 || regionCount[g] < regionCount[best]) best = g;
+	}
+	if (best == -1 || regionCount[best] == 0) return false;
+
+	vector<int> options;
+	for (size_t k = 0; k < regionCells[best].size(); k++) {
+		int cell = regionCells[best][k];
+		if (isCandidate(cell / size, cell % size)) options.push_back(cell);
+	}
+	for (size_t k = 0; k < options.size(); k++) {
+		int mark = (int)trail.size();
+		assign(options[k] / size, options[k] % size);
+		if (!deadEnd && search(nodeLimit)) return true;
+		unassign(mark);
+	}
+	return false;
+}
+
+LargeBoard::LargeBoard(int n, unsigned long long seed) {
+	size = n;
+	words = (n + 63) / 64;
+	rng = seed;
+	regionOf.assign(n * n, 0);
+	regionCells.assign(n, vector<int>());
+	rowCandidates.assign(n * words, 0);
+	colCandidates.assign(n * words, 0);
+	rowCount.assign(n, 0);
+	colCount.assign(n, 0);
+	regionCount.assign(n, 0);
+	queenInRow.assign(n, -1);
+	queenInCol.assign(n, -1);
+	queenInRegion.assign(n, -1);
+	solverNodes = 0;
+	satConflicts = 0;
+	generate();
+}
+
+void LargeBoard::generate() {
+	vector<int> solution(size, -1);
+	for (int i = 0; i < size; i++) queenInCol[i] = -1;
+	buildSolution(solution, 0);
+
+	vector<int> frontier;
+	for (int i = 0; i < size * size; i++) regionOf[i] = 0xFFFF;
+	for (int g = 0; g < size; g++) {
+		regionCells[g].clear();
+		int cell = g * size + solution[g];
+		regionOf[cell] = (unsigned short)g;
+		regionCells[g].push_back(cell);
+		frontier.push_back(cell);
+	}
+	while (!frontier.empty()) {
+		int pick = random((int)frontier.size());
+		int cell = frontier[pick];
+		int row = cell / size;
+		int col = cell % size;
+		int dr[] = { -1, 1, 0, 0 };
+		int dc[] = { 0, 0, -1, 1 };
+		int open[4];
+		int openCount = 0;
+		for (int d = 0; d < 4; d++) {
+			if (isInside(row + dr[d], col + dc[d]) && regionOf[(row + dr[d]) * size + col + dc[d]] == 0xFFFF) {
+				open[openCount++] = (row + dr[d]) * size + col + dc[d];
+			}
+		}
+		if (openCount == 0) {
+			frontier[pick] = frontier.back();
+			frontier.pop_back();
+			continue;
+		}
+		int next = open[random(openCount)];
+		regionOf[next] = regionOf[cell];
+		regionCells[regionOf[cell]].push_back(next);
+		frontier.push_back(next);
+	}
+	rebuildCandidates();
+}
+
+MoveStatus LargeBoard::placeQueen(int row, int col) {
+	if (!isInside(row, col)) return STATUS_OUT_OF_RANGE;
+	if (!isCandidate(row, col)) return STATUS_BLOCKED;
+	assign(row, col);
+	return STATUS_OK;
+}
+
+MoveStatus LargeBoard::removeQueen(int row, int col) {
+	if (!isInside(row, col)) return STATUS_OUT_OF_RANGE;
+	if (queenInRow[row] != col) return STATUS_NO_QUEEN;
+
+	// Only cells this queen ruled out can come back: its row, column, region and diagonal
+	// neighbours, each checked against the queens that stay.
+	int region = regionOf[row * size + col];
+	placed.erase(find(placed.begin(), placed.end(), row * size + col));
+	queenInRow[row] = -1;
+	queenInCol[col] = -1;
+	queenInRegion[region] = -1;
+	queenCount--;
+	for (int k = 0; k < size; k++) {
+		restoreIfFree(row, k);
+		restoreIfFree(k, col);
+	}
+	for (size_t k = 0; k < regionCells[region].size(); k++) {
+		restoreIfFree(regionCells[region][k] / size, regionCells[region][k] % size);
+	}
+	int dr[] = { -1, -1, 1, 1 };
+	int dc[] = { -1, 1, -1, 1 };
+	for (int d = 0; d < 4; d++) {
+		if (isInside(row + dr[d], col + dc[d])) restoreIfFree(row + dr[d], col + dc[d]);
+	}
+
+	deadEnd = false;
+	for (int i = 0; i < size; i++) {
+		if ((queenInRow[i] == -1 && rowCount[i] == 0) || (queenInCol[i] == -1 && colCount[i] == 0) || (queenInRegion[i] == -1 && regionCount[i] == 0)) deadEnd = true;
+	}
+	// Trail entries from before the removal no longer undo cleanly.
+	trail.clear();
+	return STATUS_OK;
+}
+
+bool LargeBoard::solve(long long nodeLimit) {
+	solverNodes = 0;
+	int mark = (int)trail.size();
+	int placedBefore = (int)placed.size();
+	if (!deadEnd && search(nodeLimit)) return true;
+	while ((int)placed.size() > placedBefore) {
+		unassign(mark);
+	}
+	restoreTo(mark);
+	return false;
+}
+
+SatResult LargeBoard::solveSat(long long conflictLimit) {
+	QueensEncoding encoding(size, regionList());
+	for (size_t k = 0; k < placed.size(); k++) {
+		encoding.fixQueen(placed[k] / size, placed[k] % size);
+	}
+	vector<int> cols;
+	SatResult result = encoding.solve(conflictLimit, cols);
+	satConflicts = encoding.getSolver().conflicts;
+	if (result != SAT_SATISFIABLE) return result;
+	for (int r = 0; r < size; r++) {
+		if (queenInRow[r] == -1) assign(r, cols[r]);
+	}
+	trail.clear();
+	return result;
+}
+
+SatResult LargeBoard::findSecondSolution(long long conflictLimit, vector<int>& first, vector<int>& second) {
+	QueensEncoding encoding(size, regionList());
+	first.clear();
+	second.clear();
+	SatResult result = encoding.solve(conflictLimit, first);
+	if (result == SAT_SATISFIABLE) result = encoding.findAnother(first, conflictLimit, second);
+	satConflicts = encoding.getSolver().conflicts;
+	return result;
+}
+
+size_t LargeBoard::memoryBytes() {
+	size_t bytes = regionOf.size() * sizeof(unsigned short);
+	bytes += (rowCandidates.size() + colCandidates.size()) * sizeof(unsigned long long);
+	for (int g = 0; g < size; g++) bytes += regionCells[g].size() * sizeof(int);
+	return bytes + 6 * size * sizeof(int);
+}
+
+bool HintWorker::compute(BoardSnapshot& snapshot, HintResult& result, atomic<unsigned int>& latest, unsigned int generation) {
+	TableEntry entry;
+	bool hit = sharedTable.probe(snapshot.positionHash, entry) && entry.markMask == snapshot.markMask;
+	if (hit && (entry.data & ENTRY_HAS_HINT)) {
+		TranspositionTable::getHint(entry, result);
+		return true;
+	}
+	bool done = snapshot.findHint(result, latest, generation);
+	if (done && hit) {
+		TranspositionTable::setHint(entry, result);
+		sharedTable.store(snapshot.positionHash, entry);
+	}
+	return done;
+}
+
+void HintWorker::run() {
+	unique_lock<mutex> guard(lock);
+	unsigned int computed = 0;
+	while (true) {
+		while (!stopping && latest.load() == computed) {
+			changed.wait(guard);
+		}
+		if (stopping) return;
+
+		unsigned int generation = latest.load();
+		BoardSnapshot snapshot = pending;
+		computed = generation;
+		guard.unlock();
+
+		HintResult result;
+		bool done = compute(snapshot, result, latest, generation);
+
+		guard.lock();
+		if (done && latest.load() == generation) {
+			cached = result;
+			cachedGeneration = generation;
+			finished.notify_all();
+		}
+	}
+}
+
+void HintWorker::stop() {
+	if (!running) return;
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+	}
+	changed.notify_all();
+	worker.join();
+	running = false;
+}
+
+HintWorker::HintWorker() {
+	latest = 0;
+	cachedGeneration = 0;
+	stopping = false;
+	background = true;
+	running = false;
+}
+
+void HintWorker::submit(int board[BOARD_SIZE][BOARD_SIZE], int colorGrid[BOARD_SIZE][BOARD_SIZE], ConflictGraph& conflicts, unsigned long long positionHash, unsigned long long markMask) {
+	lock_guard<mutex> guard(lock);
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			pending.board[i][j] = board[i][j];
+			pending.colorGrid[i][j] = colorGrid[i][j];
+		}
+	}
+	pending.conflicts = conflicts;
+	pending.positionHash = positionHash;
+	pending.markMask = markMask;
+	latest++;
+	if (!background) return;
+	if (!running) {
+		stopping = false;
+		running = true;
+		worker = thread(&HintWorker::run, this);
+	}
+	changed.notify_one();
+}
+
+HintResult HintWorker::getHint() {
+	unique_lock<mutex> guard(lock);
+	if (!running && cachedGeneration != latest.load()) {
+		compute(pending, cached, latest, latest.load());
+		cachedGeneration = latest.load();
+	}
+	while (cachedGeneration != latest.load()) {
+		finished.wait(guard);
+	}
+	return cached;
+}
+
+EventRing::EventRing() {
+	head = 0;
+	tail = 0;
+	dropped = 0;
+}
+
+bool EventRing::push(const TelemetryEvent& event) {
+	unsigned int h = head.load(memory_order_relaxed);
+	if (h - tail.load(memory_order_acquire) == CAPACITY) {
+		dropped.fetch_add(1, memory_order_relaxed);
+		return false;
+	}
+	events[h & (CAPACITY - 1)] = event;
+	head.store(h + 1, memory_order_release);
+	return true;
+}
+
+bool EventRing::pop(TelemetryEvent& event) {
+	unsigned int t = tail.load(memory_order_relaxed);
+	if (t == head.load(memory_order_acquire)) return false;
+	event = events[t & (CAPACITY - 1)];
+	tail.store(t + 1, memory_order_release);
+	return true;
+}
+
+TelemetrySession::TelemetrySession(unsigned int sessionId) {
+	id = sessionId;
+	closed = false;
+	puzzle = 0;
+	startTime = 0;
+	lastTime = 0;
+	won = true;
+}
+
+void TelemetrySession::record(int type, int row, int col, int flags, unsigned long long puzzleKey) {
+	TelemetryEvent event;
+	event.time = (unsigned long long)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+	event.puzzle = puzzleKey;
+	event.session = id;
+	event.type = (unsigned char)type;
+	event.cell = row < 0 ? 0xFF : (unsigned char)(row * BOARD_SIZE + col);
+	event.flags = (unsigned char)flags;
+	ring.push(event);
+}
+
+PuzzleAggregate::PuzzleAggregate() {
+	games = 0;
+	wins = 0;
+	for (int b = 0; b < LatencyHistogram::BUCKETS; b++) solveTimes.buckets[b] = 0;
+}
+
+double Telemetry::percentileOf(LatencyHistogram& histogram, double fraction) {
+	unsigned long long totals[LatencyHistogram::BUCKETS];
+	unsigned long long count = 0;
+	for (int b = 0; b < LatencyHistogram::BUCKETS; b++) {
+		totals[b] = histogram.buckets[b].load(memory_order_relaxed);
+		count += totals[b];
+	}
+	return OperationStats::percentile(totals, count, fraction) / 1e9;
+}
+
+void Telemetry::fold(TelemetrySession* session, const TelemetryEvent& event) {
+	eventCount++;
+	if (event.type == EVENT_START) {
+		session->puzzle = event.puzzle;
+		session->startTime = event.time;
+		session->won = false;
+		puzzles[event.puzzle].games++;
+		gameCount++;
+	}
+	else if (event.type == EVENT_WIN && !session->won) {
+		PuzzleAggregate& aggregate = puzzles[session->puzzle];
+		aggregate.wins++;
+		aggregate.solveTimes.record(event.time - session->startTime);
+		session->won = true;
+		winCount++;
+	}
+	else if (event.type < EVENT_HINT) {
+		moveCount++;
+		if (event.flags & EVENT_HINTED) hintedMoves++;
+		if (session->lastTime != 0) thinkTimes.record(event.time - session->lastTime);
+	}
+	session->lastTime = event.time;
+}
+
+void Telemetry::encode(unsigned int session) {
+	block.clear();
+	block.push_back('B');
+	putVarint(block, session);
+	putVarint(block, batch.size());
+	putVarint(block, batch[0].time);
+	for (size_t k = 0; k < batch.size(); k++) {
+		block.push_back((unsigned char)(batch[k].type | (batch[k].flags << 4)));
+	}
+	for (size_t k = 0; k < batch.size(); k++) {
+		block.push_back(batch[k].cell);
+	}
+	for (size_t k = 1; k < batch.size(); k++) {
+		putVarint(block, batch[k].time - batch[k - 1].time);
+	}
+	for (size_t k = 0; k < batch.size(); k++) {
+		if (batch[k].type != EVENT_START) continue;
+		for (int shift = 0; shift < 64; shift += 8) {
+			block.push_back((unsigned char)(batch[k].puzzle >> shift));
+		}
+	}
+	if (log != NULL) fwrite(&block[0], 1, block.size(), log);
+}
+
+void Telemetry::drain() {
+	bool wrote = false;
+	size_t kept = 0;
+	for (size_t s = 0; s < sessions.size(); s++) {
+		TelemetrySession* session = sessions[s];
+		bool closing = session->closed.load();
+		batch.clear();
+		TelemetryEvent event;
+		while (session->ring.pop(event)) {
+			fold(session, event);
+			batch.push_back(event);
+		}
+		if (!batch.empty()) {
+			encode(session->id);
+			wrote = true;
+		}
+		if (closing) {
+			droppedClosed += (long long)session->ring.dropped.load();
+			delete session;
+		}
+		else {
+			sessions[kept++] = session;
+		}
+	}
+	sessions.resize(kept);
+	if (wrote && log != NULL) fflush(log);
+}
+
+// chrono::milliseconds takes it by reference, so it needs a definition.
+const int Telemetry::DRAIN_MILLISECONDS;
+
+void Telemetry::run() {
+	unique_lock<mutex> guard(lock);
+	while (!stopping) {
+		wake.wait_for(guard, chrono::milliseconds(DRAIN_MILLISECONDS));
+		drain();
+	}
+}
+
+Telemetry::Telemetry(const string& path) {
+	log = path.empty() ? NULL : fopen(path.c_str(), "ab");
+	if (log != NULL) {
+		vector<unsigned char> header;
+		header.push_back('Q');
+		header.push_back('T');
+		header.push_back('E');
+		header.push_back('L');
+		header.push_back((unsigned char)LOG_VERSION);
+		putVarint(header, (unsigned long long)time(NULL));
+		putVarint(header, (unsigned long long)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+		fwrite(&header[0], 1, header.size(), log);
+	}
+	for (int b = 0; b < LatencyHistogram::BUCKETS; b++) thinkTimes.buckets[b] = 0;
+	nextSession = 0;
+	sessionCount = 0;
+	eventCount = 0;
+	droppedClosed = 0;
+	moveCount = 0;
+	hintedMoves = 0;
+	gameCount = 0;
+	winCount = 0;
+	stopping = false;
+	worker = thread(&Telemetry::run, this);
+}
+
+Telemetry::~Telemetry() {
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+	}
+	wake.notify_all();
+	worker.join();
+	drain();
+	if (log != NULL) fclose(log);
+}
+
+TelemetrySession* Telemetry::openSession() {
+	lock_guard<mutex> guard(lock);
+	TelemetrySession* session = new TelemetrySession(++nextSession);
+	sessions.push_back(session);
+	sessionCount++;
+	return session;
+}
+
+TelemetrySummary Telemetry::getSummary() {
+	lock_guard<mutex> guard(lock);
+	TelemetrySummary summary;
+	summary.sessions = sessionCount;
+	summary.events = eventCount;
+	summary.dropped = droppedClosed;
+	for (size_t s = 0; s < sessions.size(); s++) {
+		summary.dropped += (long long)sessions[s]->ring.dropped.load();
+	}
+	summary.moves = moveCount;
+	summary.hintedMoves = hintedMoves;
+	summary.games = gameCount;
+	summary.wins = winCount;
+	summary.thinkP50Seconds = percentileOf(thinkTimes, 0.5);
+	summary.thinkP99Seconds = percentileOf(thinkTimes, 0.99);
+	return summary;
+}
+
+bool Telemetry::getPuzzle(unsigned long long key, PuzzleTelemetry& result) {
+	lock_guard<mutex> guard(lock);
+	unordered_map<unsigned long long, PuzzleAggregate>::iterator found = puzzles.find(key);
+	if (found == puzzles.end()) return false;
+	result.games = found->second.games;
+	result.wins = found->second.wins;
+	result.medianSolveSeconds = percentileOf(found->second.solveTimes, 0.5);
+	return true;
+}
+
+bool Telemetry::decode(const vector<unsigned char>& in, vector<TelemetryEvent>& events) {
+	events.clear();
+	size_t pos = 0;
+	unsigned long long value;
+	while (pos < in.size()) {
+		if (in[pos] == 'Q') {
+			if (in.size() - pos < 5 || in[pos + 1] != 'T' || in[pos + 2] != 'E' || in[pos + 3] != 'L' || in[pos + 4] != LOG_VERSION) return false;
+			pos += 5;
+			if (!getVarint(in, pos, value) || !getVarint(in, pos, value)) return false;
+			continue;
+		}
+		if (in[pos++] != 'B') return false;
+
+		unsigned long long session, count, time;
+		if (!getVarint(in, pos, session) || !getVarint(in, pos, count) || !getVarint(in, pos, time)) return false;
+		if (count == 0 || count > (in.size() - pos) / 2) return false;
+		size_t first = events.size();
+		for (unsigned long long k = 0; k < count; k++) {
+			TelemetryEvent event;
+			event.session = (unsigned int)session;
+			event.type = in[pos + k] & 0xF;
+			event.flags = in[pos + k] >> 4;
+			event.cell = in[pos + count + k];
+			event.puzzle = 0;
+			event.time = time;
+			events.push_back(event);
+		}
+		pos += 2 * count;
+		for (unsigned long long k = 1; k < count; k++) {
+			if (!getVarint(in, pos, value)) return false;
+			time += value;
+			events[first + k].time = time;
+		}
+		for (size_t k = first; k < events.size(); k++) {
+			if (events[k].type != EVENT_START) continue;
+			if (in.size() - pos < 8) return false;
+			for (int shift = 0; shift < 64; shift += 8) {
+				events[k].puzzle |= (unsigned long long)in[pos++] << shift;
+			}
+		}
+	}
+	return true;
+}
+
+void QueensGame::loadVariation(VariationNode* node) {
+	unsigned long long changed = queenBits ^ node->queens;
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		int row = cell / BOARD_SIZE;
+		int col = cell % BOARD_SIZE;
+		if ((changed >> cell) & 1) {
+			if ((node->queens >> cell) & 1) {
+				conflicts.addQueen(row, col);
+				queenCount++;
+			}
+			else {
+				conflicts.removeQueen(row, col);
+				queenCount--;
+			}
+			toggleQueenBits(row, col);
+		}
+		if ((node->queens >> cell) & 1) board[row][col] = 1;
+		else if ((node->marks >> cell) & 1) board[row][col] = 2;
+		else board[row][col] = 0;
+	}
+	manualMarks = node->manualMarks;
+}
+
+unsigned long long QueensGame::getMarkMask() {
+	unsigned long long mask = 0;
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			if (board[i][j] == 2) mask |= 1ULL << (i * BOARD_SIZE + j);
+		}
+	}
+	return mask;
+}
+
+void QueensGame::logMove(int type, int row, int col) {
+	if (telemetry == NULL) return;
+	int flags = type == 1 && row * BOARD_SIZE + col == hintCell ? EVENT_HINTED : 0;
+	hintCell = -1;
+	telemetry->record(type, row, col, flags, puzzleKey);
+	if (checkWin() && !winLogged) {
+		telemetry->record(EVENT_WIN, -1, -1, 0, puzzleKey);
+		winLogged = true;
+	}
+}
+
+void QueensGame::fillAllowed(int allowed[BOARD_SIZE]) {
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		allowed[i] = ((1 << BOARD_SIZE) - 1) & ~(int)((manualMarks >> (i * BOARD_SIZE)) & 0xFF);
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			if (board[i][j] == 1) allowed[i] = 1 << j;
+		}
+	}
+}
+
+void QueensGame::applyColorGrid() {
+	puzzleHash = 0;
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			puzzleHash ^= zobrist.colorKeys[i * BOARD_SIZE + j][colorGrid[i][j]];
+		}
+	}
+	positionHash = puzzleHash;
+
+	CanonicalForm form;
+	form.compute(colorGrid);
+	puzzleKey = form.key;
+	puzzleTransform = form.transform;
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			puzzleLabels[i][j] = form.labels[i][j];
+		}
+	}
+	hintCell = -1;
+	winLogged = false;
+	if (telemetry != NULL) telemetry->record(EVENT_START, -1, -1, 0, puzzleKey);
+
+	conflicts.setColorGrid(colorGrid);
+	solver.setColorGrid(colorGrid);
+	rules.setRegions(colorGrid);
+}
+
+QueensGame::QueensGame(GameRecordsBST* rec, bool backgroundHints) {
+	hints.setBackground(backgroundHints);
+	rng = (unsigned long long)time(NULL);
+	records = rec;
+	telemetry = NULL;
+	queenCount = 0;
+	moveCount = 0;
+	initBoard();
+	generateColorRegions();
+	conflicts.setColorGrid(colorGrid);
+}
+
+void QueensGame::initBoard() {
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			board[i][j] = 0;
+		}
+	}
+	queenCount = 0;
+	moveCount = 0;
+	queenBits = 0;
+	manualMarks = 0;
+	history.clear();
+	variations.reset(0, 0);
+	conflicts.reset();
+}
+
+void QueensGame::generateColorRegions() {
+	PROFILE_OPERATION(OP_GENERATE_REGIONS);
+	int boardIndex = random(BASE_MAP_COUNT);
+
+	int shuffle[8];
+	for (int i = 0; i < 8; i++) shuffle[i] = i;
+	for (int i = 7; i > 0; i--) {
+		int j = random(i + 1);
+		int temp = shuffle[i];
+		shuffle[i] = shuffle[j];
+		shuffle[j] = temp;
+	}
+
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			colorGrid[i][j] = shuffle[BASE_MAPS[boardIndex][i][j]];
+		}
+	}
+
+	int transform = random(8);
+	if (transform >= 4) {
+		for (int i = 0; i < BOARD_SIZE; i++) {
+			for (int j = i + 1; j < BOARD_SIZE; j++) {
+				int temp = colorGrid[i][j];
+				colorGrid[i][j] = colorGrid[j][i];
+				colorGrid[j][i] = temp;
+			}
+		}
+	}
+	if (transform % 4 >= 2) {
+		for (int i = 0; i < BOARD_SIZE / 2; i++) {
+			for (int j = 0; j < BOARD_SIZE; j++) {
+				int temp = colorGrid[i][j];
+				colorGrid[i][j] = colorGrid[BOARD_SIZE - 1 - i][j];
+				colorGrid[BOARD_SIZE - 1 - i][j] = temp;
+			}
+		}
+	}
+	if (transform % 2 == 1) {
+		for (int i = 0; i < BOARD_SIZE; i++) {
+			for (int j = 0; j < BOARD_SIZE / 2; j++) {
+				int temp = colorGrid[i][j];
+				colorGrid[i][j] = colorGrid[i][BOARD_SIZE - 1 - j];
+				colorGrid[i][BOARD_SIZE - 1 - j] = temp;
+			}
+		}
+	}
+
+	applyColorGrid();
+	boardChanged();
+}
+
+bool QueensGame::canPlaceQueen(int row, int col) {
+	if (!isValidPosition(row, col)) return false;
+	if (board[row][col] != 0) return false;
+	if (conflicts.hasRowConflict(row)) return false;
+	if (conflicts.hasColConflict(col)) return false;
+	if (conflicts.hasColorConflict(row, col)) return false;
+	if (hasDiagonalTouch(row, col)) return false;
+	return true;
+}
+
+void QueensGame::recalculateInvalidMarks() {
+	PROFILE_OPERATION(OP_RECALCULATE_MARKS);
+	manualMarks = 0;
+	TableEntry entry;
+	if (sharedTable.probe(positionHash, entry)) {
+		for (int i = 0; i < BOARD_SIZE; i++) {
+			for (int j = 0; j < BOARD_SIZE; j++) {
+				if (board[i][j] != 1) {
+					board[i][j] = (entry.markMask >> (i * BOARD_SIZE + j)) & 1 ? 2 : 0;
+				}
+			}
+		}
+		return;
+	}
+
+	unsigned long long marks = deriveMarks(queenBits);
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			if (board[i][j] != 1) {
+				board[i][j] = (marks >> (i * BOARD_SIZE + j)) & 1 ? 2 : 0;
+			}
+		}
+	}
+
+	entry.markMask = getMarkMask();
+	entry.data = 0;
+	sharedTable.store(positionHash, entry);
+}
+
+int QueensGame::countSolutions() {
+	unsigned long long marks = getMarkMask();
+	TableEntry entry;
+	bool hit = sharedTable.probe(positionHash, entry) && entry.markMask == marks;
+	if (hit && (entry.data & ENTRY_HAS_COUNT)) {
+		return TranspositionTable::getCount(entry);
+	}
+
+	int allowed[BOARD_SIZE];
+	fillAllowed(allowed);
+
+	int count = solver.countSolutions(allowed);
+	if (hit) {
+		TranspositionTable::setCount(entry, count);
+		sharedTable.store(positionHash, entry);
+	}
+	return count;
+}
+
+MoveStatus QueensGame::placeQueen(int row, int col) {
+	PROFILE_OPERATION(OP_PLACE_QUEEN);
+	if (!isValidPosition(row, col)) {
+		return STATUS_OUT_OF_RANGE;
+	}
+
+	if (board[row][col] == 1) {
+		return STATUS_OCCUPIED;
+	}
+
+	if (board[row][col] == 2) {
+		return STATUS_MARKED;
+	}
+
+	if (conflicts.hasRowConflict(row)) {
+		return STATUS_ROW_CONFLICT;
+	}
+
+	if (conflicts.hasColConflict(col)) {
+		return STATUS_COL_CONFLICT;
+	}
+
+	if (conflicts.hasColorConflict(row, col)) {
+		return STATUS_REGION_CONFLICT;
+	}
+
+	if (hasDiagonalTouch(row, col)) {
+		return STATUS_DIAGONAL_TOUCH;
+	}
+
+	int prevState = board[row][col];
+	board[row][col] = 1;
+	queenCount++;
+	moveCount++;
+
+	conflicts.addQueen(row, col);
+	toggleQueenBits(row, col);
+
+	recalculateInvalidMarks();
+	recordVariation(row, col, prevState, 1);
+
+	boardChanged();
+	history.addMove(row, col, 1, solutionsLeft, variations.getCurrent()->id);
+	logMove(1, row, col);
+
+	return STATUS_OK;
+}
+
+MoveStatus QueensGame::removeQueen(int row, int col) {
+	PROFILE_OPERATION(OP_REMOVE_QUEEN);
+	if (!isValidPosition(row, col)) {
+		return STATUS_OUT_OF_RANGE;
+	}
+
+	if (board[row][col] != 1) {
+		return STATUS_NO_QUEEN;
+	}
+
+	int prevState = board[row][col];
+	board[row][col] = 0;
+	queenCount--;
+	moveCount++;
+
+	conflicts.removeQueen(row, col);
+	toggleQueenBits(row, col);
+
+	recalculateInvalidMarks();
+	recordVariation(row, col, prevState, 0);
+
+	boardChanged();
+	history.addMove(row, col, 2, solutionsLeft, variations.getCurrent()->id);
+	logMove(2, row, col);
+
+	return STATUS_OK;
+}
+
+MoveStatus QueensGame::markX(int row, int col) {
+	PROFILE_OPERATION(OP_MARK_X);
+	if (!isValidPosition(row, col)) {
+		return STATUS_OUT_OF_RANGE;
+	}
+
+	if (board[row][col] == 1) {
+		return STATUS_IS_QUEEN;
+	}
+
+	if (board[row][col] == 2) {
+		return STATUS_ALREADY_MARKED;
+	}
+
+	int prevState = board[row][col];
+	board[row][col] = 2;
+	manualMarks |= 1ULL << (row * BOARD_SIZE + col);
+	moveCount++;
+
+	recordVariation(row, col, prevState, 2);
+
+	boardChanged();
+	history.addMove(row, col, 3, solutionsLeft, variations.getCurrent()->id);
+	logMove(3, row, col);
+
+	return STATUS_OK;
+}
+
+MoveStatus QueensGame::clearCell(int row, int col) {
+	PROFILE_OPERATION(OP_CLEAR_CELL);
+	if (!isValidPosition(row, col)) {
+		return STATUS_OUT_OF_RANGE;
+	}
+
+	if (board[row][col] == 0) {
+		return STATUS_ALREADY_EMPTY;
+	}
+
+	int prevState = board[row][col];
+
+	if (board[row][col] == 1) {
+		conflicts.removeQueen(row, col);
+		toggleQueenBits(row, col);
+		queenCount--;
+	}
+
+	board[row][col] = 0;
+	moveCount++;
+
+	recalculateInvalidMarks();
+	recordVariation(row, col, prevState, 0);
+
+	boardChanged();
+	history.addMove(row, col, 4, solutionsLeft, variations.getCurrent()->id);
+	logMove(4, row, col);
+
+	return STATUS_OK;
+}
+
+MoveStatus QueensGame::undo() {
+	PROFILE_OPERATION(OP_UNDO);
+	if (!variations.canUndo()) {
+		return STATUS_NOTHING_TO_UNDO;
+	}
+
+	VariationNode* action = variations.undo();
+	if (action == NULL) return STATUS_NOTHING_TO_UNDO;
+
+	loadVariation(variations.getCurrent());
+
+	boardChanged();
+	history.addMove(action->row, action->col, 5, solutionsLeft, variations.getCurrent()->id);
+	logMove(5, action->row, action->col);
+
+	return STATUS_OK;
+}
+
+MoveStatus QueensGame::redo() {
+	PROFILE_OPERATION(OP_REDO);
+	if (!variations.canRedo()) {
+		return STATUS_NOTHING_TO_REDO;
+	}
+
+	VariationNode* action = variations.redo();
+	if (action == NULL) return STATUS_NOTHING_TO_REDO;
+
+	loadVariation(action);
+
+	boardChanged();
+	history.addMove(action->row, action->col, 6, solutionsLeft, action->id);
+	logMove(6, action->row, action->col);
+
+	return STATUS_OK;
+}
+
+MoveStatus QueensGame::jumpToVariation(int id) {
+	if (id == variations.getCurrent()->id) {
+		return STATUS_SAME_POSITION;
+	}
+
+	VariationNode* target = variations.jumpTo(id);
+	if (target == NULL) {
+		return STATUS_NO_SUCH_POSITION;
+	}
+
+	loadVariation(target);
+
+	boardChanged();
+	history.addMove(target->row, target->col, 7, solutionsLeft, target->id);
+	logMove(7, target->row, target->col);
+
+	return STATUS_OK;
+}
+
+void QueensGame::restart() {
+	if (moveCount > 0 && records != NULL) {
+		records->addRecord(moveCount, checkWin());
+	}
+
+	initBoard();
+	generateColorRegions();
+	conflicts.setColorGrid(colorGrid);
+}
+
+vector<unsigned char> QueensGame::saveSession() {
+	vector<unsigned char> out;
+	out.push_back('Q');
+	out.push_back('S');
+	out.push_back('A');
+	out.push_back('V');
+	out.push_back((unsigned char)SAVE_VERSION);
+	out.push_back((unsigned char)BOARD_SIZE);
+
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell += 2) {
+		int first = colorGrid[cell / BOARD_SIZE][cell % BOARD_SIZE];
+		int second = colorGrid[(cell + 1) / BOARD_SIZE][(cell + 1) % BOARD_SIZE];
+		out.push_back((unsigned char)(first | (second << 4)));
+	}
+	putVarint(out, moveCount);
+
+	putVarint(out, variations.getNodeCount());
+	for (int id = 1; id < variations.getNodeCount(); id++) {
+		VariationNode* node = variations.getNode(id);
+		putVarint(out, node->parent->id);
+		int packed = (node->row * BOARD_SIZE + node->col) | (node->prevState << 6) | (node->newState << 8);
+		out.push_back((unsigned char)(packed & 0xFF));
+		out.push_back((unsigned char)(packed >> 8));
+	}
+	putVarint(out, variations.getCurrent()->id);
+
+	vector<MoveNode*> moves;
+	for (MoveNode* temp = history.getLastMove(); temp != NULL; temp = temp->next) {
+		moves.push_back(temp);
+	}
+	putVarint(out, moves.size());
+	for (int m = (int)moves.size() - 1; m >= 0; m--) {
+		int packed = moves[m]->row < 0 ? SAVE_NO_CELL : moves[m]->row * BOARD_SIZE + moves[m]->col;
+		packed |= moves[m]->actionType << 6;
+		out.push_back((unsigned char)(packed & 0xFF));
+		out.push_back((unsigned char)(packed >> 8));
+		putVarint(out, moves[m]->nodeId);
+		putVarint(out, moves[m]->solutionsLeft);
+	}
+	for (int id = 0; id < variations.getNodeCount(); id++) {
+		VariationNode* next = variations.getNode(id)->lastVisited;
+		putVarint(out, next == NULL ? 0 : next->id);
+	}
+	return out;
+}
+
+bool QueensGame::loadSession(const vector<unsigned char>& in) {
+	size_t headerSize = 6 + BOARD_SIZE * BOARD_SIZE / 2;
+	if (in.size() < headerSize || in[0] != 'Q' || in[1] != 'S' || in[2] != 'A' || in[3] != 'V') return false;
+	if (in[4] < 1 || in[4] > SAVE_VERSION || in[5] != BOARD_SIZE) return false;
+
+	int grid[BOARD_SIZE][BOARD_SIZE];
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		unsigned char packed = in[6 + cell / 2];
+		grid[cell / BOARD_SIZE][cell % BOARD_SIZE] = cell % 2 == 0 ? (packed & 0xF) : (packed >> 4);
+		if (grid[cell / BOARD_SIZE][cell % BOARD_SIZE] >= BOARD_SIZE) return false;
+	}
+
+	size_t pos = headerSize;
+	unsigned long long moves, nodeCount, value;
+	if (!getVarint(in, pos, moves) || moves > INT_MAX || !getVarint(in, pos, nodeCount) || nodeCount == 0) return false;
+	// Every node after the root takes at least 3 bytes.
+	if (nodeCount - 1 > (in.size() - pos) / 3) return false;
+
+	RuleBoard<ClassicRules> savedRules;
+	savedRules.setRegions(grid);
+	vector<int> parents(1, -1), nodeCells(1, 0);
+	vector<unsigned long long> queens(1, 0), marks(1, 0), manual(1, 0);
+	for (unsigned long long id = 1; id < nodeCount; id++) {
+		unsigned long long parentId;
+		if (!getVarint(in, pos, parentId) || parentId >= id || pos + 2 > in.size()) return false;
+		int packed = in[pos] | (in[pos + 1] << 8);
+		pos += 2;
+		int cell = packed & 0x3F;
+		int prevState = (packed >> 6) & 0x3;
+		int newState = (packed >> 8) & 0x3;
+		if (prevState > 2 || newState > 2 || prevState == newState || packed >> 10) return false;
+		unsigned long long bit = 1ULL << cell;
+		parents.push_back((int)parentId);
+		nodeCells.push_back(packed);
+		queens.push_back(newState == 1 ? queens[parentId] | bit : queens[parentId] & ~bit);
+		if (newState == 2) {
+			marks.push_back(marks[parentId] | bit);
+			manual.push_back(manual[parentId] | bit);
+		}
+		else {
+			marks.push_back(savedRules.blocked(queens.back()) & ~queens.back());
+			manual.push_back(0);
+		}
+	}
+
+	unsigned long long currentId, historySize;
+	if (!getVarint(in, pos, currentId) || currentId >= nodeCount || !getVarint(in, pos, historySize)) return false;
+	if (historySize > (in.size() - pos) / 4) return false;
+	vector<int> logCells, logNodes, logSolutions;
+	for (unsigned long long m = 0; m < historySize; m++) {
+		unsigned long long nodeId;
+		if (pos + 2 > in.size()) return false;
+		int packed = in[pos] | (in[pos + 1] << 8);
+		pos += 2;
+		// Version 1 wrote a jump to the start as cell -1, which came out as 0xFFF7.
+		if (in[4] < 2 && packed == 0xFFF7) packed = SAVE_NO_CELL | (7 << 6);
+		if (!getVarint(in, pos, nodeId) || nodeId >= nodeCount || !getVarint(in, pos, value) || value > INT_MAX) return false;
+		int actionType = (packed >> 6) & 0x7;
+		if (actionType < 1 || actionType > 7 || (packed & ~(SAVE_NO_CELL | 0x1FF))) return false;
+		logCells.push_back(packed);
+		logNodes.push_back((int)nodeId);
+		logSolutions.push_back((int)value);
+	}
+
+	vector<int> redo;
+	for (unsigned long long id = 0; id < nodeCount && in[4] >= 2; id++) {
+		if (!getVarint(in, pos, value) || value >= nodeCount || (value != 0 && parents[value] != (int)id)) return false;
+		redo.push_back((int)value);
+	}
+	if (pos != in.size()) return false;
+
+	initBoard();
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			colorGrid[i][j] = grid[i][j];
+		}
+	}
+	applyColorGrid();
+	moveCount = (int)moves;
+	for (size_t id = 1; id < parents.size(); id++) {
+		int cell = nodeCells[id] & 0x3F;
+		variations.restoreNode(parents[id], cell / BOARD_SIZE, cell % BOARD_SIZE, (nodeCells[id] >> 6) & 0x3, (nodeCells[id] >> 8) & 0x3, queens[id], marks[id], manual[id]);
+	}
+	for (size_t m = 0; m < logCells.size(); m++) {
+		int cell = logCells[m] & 0x3F;
+		if (logCells[m] & SAVE_NO_CELL) history.addMove(-1, -1, (logCells[m] >> 6) & 0x7, logSolutions[m], logNodes[m]);
+		else history.addMove(cell / BOARD_SIZE, cell % BOARD_SIZE, (logCells[m] >> 6) & 0x7, logSolutions[m], logNodes[m]);
+	}
+	for (size_t id = 0; id < redo.size(); id++) {
+		variations.setLastVisited((int)id, redo[id]);
+	}
+
+	VariationNode* current = variations.jumpTo((int)currentId);
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		int row = cell / BOARD_SIZE;
+		int col = cell % BOARD_SIZE;
+		if ((current->queens >> cell) & 1) {
+			board[row][col] = 1;
+			conflicts.addQueen(row, col);
+			toggleQueenBits(row, col);
+			queenCount++;
+		}
+		else if ((current->marks >> cell) & 1) {
+			board[row][col] = 2;
+		}
+	}
+	manualMarks = current->manualMarks;
+	boardChanged();
+	return true;
+}
+
+MoveStatus QueensGame::setPuzzle(const int grid[BOARD_SIZE][BOARD_SIZE]) {
+	int seen = 0;
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			if (grid[i][j] < 0 || grid[i][j] >= BOARD_SIZE) return STATUS_OUT_OF_RANGE;
+			seen |= 1 << grid[i][j];
+		}
+	}
+	if (seen != (1 << BOARD_SIZE) - 1) return STATUS_OUT_OF_RANGE;
+
+	initBoard();
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			colorGrid[i][j] = grid[i][j];
+		}
+	}
+	applyColorGrid();
+	boardChanged();
+	return STATUS_OK;
+}
+
+void QueensGame::setTelemetry(Telemetry* sink) {
+	if (telemetry != NULL) telemetry->close();
+	telemetry = NULL;
+	if (sink == NULL) return;
+	telemetry = sink->openSession();
+	hintCell = -1;
+	winLogged = checkWin();
+	telemetry->record(EVENT_START, -1, -1, 0, puzzleKey);
+}
+
+MoveStatus QueensGame::requestHint(HintResult& hint) {
+	PROFILE_OPERATION(OP_SHOW_HINT);
+	if (queenCount >= 8) {
+		return STATUS_ALREADY_SOLVED;
+	}
+
+	if (!isSolvable()) {
+		return STATUS_UNSOLVABLE;
+	}
+
+	hint = hints.getHint();
+	if (hint.row == -1) {
+		return STATUS_NO_MOVES;
+	}
+	if (telemetry != NULL) {
+		hintCell = hint.row * BOARD_SIZE + hint.col;
+		telemetry->record(EVENT_HINT, hint.row, hint.col, 0, puzzleKey);
+	}
+	return STATUS_OK;
+}
+
+MoveStatus QueensGame::solve(int cols[BOARD_SIZE]) {
+	int allowed[BOARD_SIZE];
+	fillAllowed(allowed);
+
+	const SolutionSet* known = solutionIndex.find(puzzleKey, puzzleLabels);
+	if (known != NULL) {
+		for (size_t k = 0; k < known->solutions.size(); k++) {
+			unsigned int mapped;
+			PuzzleSymmetry::mapSolution(puzzleTransform, known->solutions[k], mapped, true);
+			bool fits = true;
+			for (int i = 0; i < BOARD_SIZE && fits; i++) {
+				fits = (allowed[i] >> ((mapped >> (3 * i)) & 7)) & 1;
+			}
+			if (!fits) continue;
+			for (int i = 0; i < BOARD_SIZE; i++) {
+				cols[i] = (mapped >> (3 * i)) & 7;
+			}
+			return STATUS_OK;
+		}
+		return STATUS_UNSOLVABLE;
+	}
+
+	if (solver.countSolutions(allowed) == 0) return STATUS_UNSOLVABLE;
+
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		int options = allowed[i];
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			if (!(options & (1 << j))) continue;
+			allowed[i] = 1 << j;
+			if (solver.countSolutions(allowed) > 0) break;
+		}
+		cols[i] = LatencyHistogram::highestBit((unsigned long long)allowed[i]);
+	}
+	return STATUS_OK;
+}
+
+bool QueensGame::verify(const int cols[BOARD_SIZE]) {
+	const SolutionSet* known = solutionIndex.find(puzzleKey, puzzleLabels);
+	if (known != NULL) {
+		unsigned int packed = 0, mapped;
+		for (int i = 0; i < BOARD_SIZE; i++) {
+			if (cols[i] < 0 || cols[i] >= BOARD_SIZE) return false;
+			packed |= (unsigned int)cols[i] << (3 * i);
+		}
+		if (!PuzzleSymmetry::mapSolution(puzzleTransform, packed, mapped, false)) return false;
+		return binary_search(known->solutions.begin(), known->solutions.end(), mapped);
+	}
+
+	int regions[BOARD_SIZE * BOARD_SIZE];
+	unsigned char rows[BOARD_SIZE];
+	unsigned char queenCols[BOARD_SIZE];
+	int puzzleId = 0;
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			regions[i * BOARD_SIZE + j] = colorGrid[i][j];
+		}
+		rows[i] = (unsigned char)i;
+		queenCols[i] = cols[i] < 0 || cols[i] >= BOARD_SIZE ? BOARD_SIZE : (unsigned char)cols[i];
+	}
+
+	SolutionBatch batch;
+	batch.count = 1;
+	batch.puzzleIds = &puzzleId;
+	batch.regionMaps = regions;
+	for (int k = 0; k < BOARD_SIZE; k++) {
+		batch.queenRows[k] = &rows[k];
+		batch.queenCols[k] = &queenCols[k];
+	}
+	unsigned long long verdict;
+	BatchVerifier::verify(batch, &verdict);
+	return (verdict & 1) != 0;
+}
+
+int QueensGame::solutionsAfter(int row, int col) {
+	if (!canPlaceQueen(row, col)) return 0;
+	int allowed[BOARD_SIZE];
+	fillAllowed(allowed);
+	allowed[row] = 1 << col;
+	return solver.countSolutions(allowed);
+}
+
+int AgentPolicy::takeHintCount() {
+	int count = hintsTaken;
+	hintsTaken = 0;
+	return count;
+}
+
+bool HintAgent::chooseMove(QueensGame& game, int& row, int& col) {
+	hintsTaken++;
+	HintResult hint;
+	if (game.requestHint(hint) != STATUS_OK) return false;
+	row = hint.row;
+	col = hint.col;
+	return true;
+}
+
+bool SolverAgent::chooseMove(QueensGame& game, int& row, int& col) {
+	int colors[BOARD_SIZE][BOARD_SIZE];
+	int allowed[BOARD_SIZE];
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			colors[i][j] = game.getColor(i, j);
+		}
+	}
+	game.getAllowed(allowed);
+	solver.setColorGrid(colors);
+	solver.listSolutions(allowed, solutions);
+
+	int through[BOARD_SIZE * BOARD_SIZE] = { 0 };
+	for (size_t k = 0; k < solutions.size(); k++) {
+		for (int i = 0; i < BOARD_SIZE; i++) {
+			through[i * BOARD_SIZE + ((solutions[k] >> (3 * i)) & 7)]++;
+		}
+	}
+	int best = 0;
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		if (through[cell] > best && game.canPlaceQueen(cell / BOARD_SIZE, cell % BOARD_SIZE)) {
+			best = through[cell];
+			row = cell / BOARD_SIZE;
+			col = cell % BOARD_SIZE;
+		}
+	}
+	return best > 0;
+}
+
+bool RandomAgent::chooseMove(QueensGame& game, int& row, int& col) {
+	int options[BOARD_SIZE * BOARD_SIZE];
+	int count = 0;
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			if (game.canPlaceQueen(i, j)) options[count++] = i * BOARD_SIZE + j;
+		}
+	}
+	if (count == 0) return false;
+	int pick = options[ZobristKeys::next(rng) % count];
+	row = pick / BOARD_SIZE;
+	col = pick % BOARD_SIZE;
+	return true;
+}
+
+void SelfPlayTournament::playGame(QueensGame& game, AgentPolicy& agent, GameRecordsBST& records) {
+	vector<int> placed;
+	int deadEnds = 0;
+	int row, col;
+
+	agent.takeHintCount();
+	while (!game.checkWin() && game.getMoveCount() < MOVE_LIMIT) {
+		if (agent.chooseMove(game, row, col)) {
+			if (game.placeQueen(row, col) != STATUS_OK) break;
+			placed.push_back(row * BOARD_SIZE + col);
+			continue;
+		}
+
+		deadEnds++;
+		if (placed.empty()) break;
+		int queens = game.getQueenCount();
+		while (game.getQueenCount() >= queens && game.undo() == STATUS_OK) {}
+		game.markX(placed.back() / BOARD_SIZE, placed.back() % BOARD_SIZE);
+		placed.pop_back();
+	}
+
+	bool won = game.checkWin();
+	records.addResults(game.getMoveCount(), 1, won ? 1 : 0, agent.takeHintCount(), deadEnds);
+}
+
+void SelfPlayTournament::worker() {
+	QueensGame game(NULL, false);
+	HintAgent hintAgent;
+	SolverAgent solverAgent;
+	RandomAgent randomAgent;
+	AgentPolicy* agents[POLICY_COUNT] = { &hintAgent, &solverAgent, &randomAgent };
+	GameRecordsBST local[POLICY_COUNT];
+
+	while (true) {
+		long long first = nextGame.fetch_add(BATCH_SIZE);
+		if (first >= totalGames) break;
+		long long last = min(first + BATCH_SIZE, totalGames);
+		for (long long index = first; index < last; index++) {
+			int policy = (int)(index % POLICY_COUNT);
+			unsigned long long state = baseSeed + (unsigned long long)index;
+			game.seed(ZobristKeys::next(state));
+			randomAgent.seed(ZobristKeys::next(state));
+			game.restart();
+			playGame(game, *agents[policy], local[policy]);
+		}
+	}
+
+	lock_guard<mutex> guard(resultsLock);
+	for (int p = 0; p < POLICY_COUNT; p++) {
+		results[p].merge(local[p]);
+	}
+}
+
+SelfPlayTournament::SelfPlayTournament(unsigned long long seed) {
+	baseSeed = seed;
+	nextGame = 0;
+	totalGames = 0;
+}
+
+void SelfPlayTournament::run(long long games, int threads) {
+	totalGames = games;
+	nextGame = 0;
+	vector<thread> pool;
+	for (int t = 0; t < threads; t++) {
+		pool.push_back(thread(&SelfPlayTournament::worker, this));
+	}
+	for (size_t t = 0; t < pool.size(); t++) {
+		pool[t].join();
+	}
+}
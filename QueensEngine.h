@@ -0,0 +1,2211 @@
+#ifndef QUEENS_ENGINE_H
+#define QUEENS_ENGINE_H
+
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <unordered_map>
+#include <type_traits>
+#include <climits>
+#include "QueensTables.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#ifndef QUEENS_PROFILING
+#define QUEENS_PROFILING 1
+#endif
+
+// AVX2 paths are compiled into every x86 build and chosen at run time, so a default build
+// still uses them on CPUs that have AVX2. Define QUEENS_AVX2=0 to leave them out.
+#ifndef QUEENS_AVX2
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define QUEENS_AVX2 1
+#else
+#define QUEENS_AVX2 0
+#endif
+#endif
+
+#if QUEENS_AVX2
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define QUEENS_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define QUEENS_AVX2_TARGET
+#endif
+#endif
+
+inline bool cpuHasAvx2() {
+#if QUEENS_AVX2 && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) return false;
+	__cpuid(info, 1);
+	bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+	__cpuidex(info, 7, 0);
+	return osSavesYmm && (info[1] & (1 << 5));
+#elif QUEENS_AVX2
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+// Whether the AVX2 paths run. Starts as cpuHasAvx2(); clear it to force the scalar paths.
+extern bool avx2Enabled;
+
+const int BOARD_SIZE = 8;
+
+// Result of every engine operation. The engine never prints; front ends turn these into messages.
+enum MoveStatus {
+	STATUS_OK,
+	STATUS_OUT_OF_RANGE,
+	STATUS_OCCUPIED,
+	STATUS_MARKED,
+	STATUS_ROW_CONFLICT,
+	STATUS_COL_CONFLICT,
+	STATUS_REGION_CONFLICT,
+	STATUS_DIAGONAL_TOUCH,
+	STATUS_BLOCKED,
+	STATUS_NO_QUEEN,
+	STATUS_IS_QUEEN,
+	STATUS_ALREADY_MARKED,
+	STATUS_ALREADY_EMPTY,
+	STATUS_NOTHING_TO_UNDO,
+	STATUS_NOTHING_TO_REDO,
+	STATUS_SAME_POSITION,
+	STATUS_NO_SUCH_POSITION,
+	STATUS_ALREADY_SOLVED,
+	STATUS_UNSOLVABLE,
+	STATUS_NO_MOVES,
+	STATUS_BAD_SAVE,
+	STATUS_COUNT
+};
+
+enum ProfiledOperation {
+	OP_PLACE_QUEEN,
+	OP_REMOVE_QUEEN,
+	OP_MARK_X,
+	OP_CLEAR_CELL,
+	OP_UNDO,
+	OP_REDO,
+	OP_RECALCULATE_MARKS,
+	OP_SHOW_HINT,
+	OP_DISPLAY_BOARD,
+	OP_GENERATE_REGIONS,
+	OP_COUNT
+};
+
+const char* const operationNames[OP_COUNT] = {
+	"placeQueen", "removeQueen", "markX", "clearCell", "undo", "redo",
+	"recalculateInvalidMarks", "showHint", "displayBoard", "generateColorRegions"
+};
+
+class LatencyHistogram {
+public:
+	static const int SUB_BITS = 3;
+	static const int SUB_BUCKETS = 1 << SUB_BITS;
+	static const int BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+	std::atomic<unsigned long long> buckets[BUCKETS];
+
+	static int highestBit(unsigned long long value) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse64(&index, value);
+		return (int)index;
+#else
+		return 63 - __builtin_clzll(value);
+#endif
+	}
+
+	static int bucketOf(unsigned long long value) {
+		if (value < SUB_BUCKETS) return (int)value;
+		int top = highestBit(value);
+		int sub = (int)((value >> (top - SUB_BITS)) & (SUB_BUCKETS - 1));
+		return (top - SUB_BITS + 1) * SUB_BUCKETS + sub;
+	}
+
+	static unsigned long long bucketUpperBound(int bucket) {
+		if (bucket < SUB_BUCKETS) return bucket;
+		int top = bucket / SUB_BUCKETS + SUB_BITS - 1;
+		unsigned long long width = 1ULL << (top - SUB_BITS);
+		return ((unsigned long long)(SUB_BUCKETS + bucket % SUB_BUCKETS) << (top - SUB_BITS)) + width - 1;
+	}
+
+	void record(unsigned long long nanos) {
+		buckets[bucketOf(nanos)].fetch_add(1, std::memory_order_relaxed);
+	}
+};
+
+class OperationStats {
+private:
+	static const int MAX_THREADS = 32;
+
+	LatencyHistogram histograms[MAX_THREADS][OP_COUNT];
+	std::atomic<int> threadsSeen;
+
+public:
+	void merge(int op, unsigned long long totals[LatencyHistogram::BUCKETS], unsigned long long& count);
+
+	static double percentile(unsigned long long totals[LatencyHistogram::BUCKETS], unsigned long long count, double fraction);
+
+	void record(int op, unsigned long long nanos);
+
+};
+
+extern OperationStats operationStats;
+
+class ScopedTimer {
+private:
+	int op;
+	std::chrono::steady_clock::time_point start;
+public:
+	ScopedTimer(int operation) {
+		op = operation;
+		start = std::chrono::steady_clock::now();
+	}
+
+	~ScopedTimer() {
+		operationStats.record(op, (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	}
+};
+
+#if QUEENS_PROFILING
+#define PROFILE_OPERATION(op) ScopedTimer operationTimer(op)
+#else
+#define PROFILE_OPERATION(op)
+#endif
+
+struct MoveNode {
+	int row;
+	int col;
+	int actionType;
+	int solutionsLeft;
+	int nodeId;
+	MoveNode* next;
+};
+
+class MoveHistory {
+private:
+	MoveNode* head;
+	int count;
+public:
+	MoveHistory() {
+		head = NULL;
+		count = 0;
+	}
+
+	~MoveHistory() {
+		clear();
+	}
+
+	void addMove(int row, int col, int actionType, int solutionsLeft, int nodeId);
+
+	MoveNode* getLastMove() {
+		return head;
+	}
+
+	void removeLastMove();
+
+	int getCount() {
+		return count;
+	}
+
+	void clear();
+
+};
+
+struct VariationNode {
+	int id;
+	int depth;
+	int row;
+	int col;
+	int prevState;
+	int newState;
+	unsigned long long queens;
+	unsigned long long marks;
+	unsigned long long manualMarks;
+	VariationNode* parent;
+	VariationNode* firstChild;
+	VariationNode* nextSibling;
+	VariationNode* lastVisited;
+};
+
+class VariationTree {
+private:
+	std::vector<VariationNode*> nodes;
+	VariationNode* current;
+
+	VariationNode* createNode(VariationNode* parent, int row, int col, int prevState, int newState);
+
+public:
+	VariationTree() {
+		current = NULL;
+	}
+
+	~VariationTree() {
+		clear();
+	}
+
+	void reset(unsigned long long queens, unsigned long long marks);
+
+	VariationNode* addMove(int row, int col, int prevState, int newState, unsigned long long queens, unsigned long long marks, unsigned long long manualMarks);
+
+	VariationNode* restoreNode(int parentId, int row, int col, int prevState, int newState, unsigned long long queens, unsigned long long marks, unsigned long long manualMarks);
+
+	// Points a position's redo at one of its children, or clears it when childId is 0.
+	bool setLastVisited(int id, int childId);
+
+	VariationNode* undo();
+
+	VariationNode* redo();
+
+	VariationNode* jumpTo(int id);
+
+	bool canUndo() {
+		return current != NULL && current->parent != NULL;
+	}
+
+	bool canRedo() {
+		return current != NULL && current->lastVisited != NULL;
+	}
+
+	VariationNode* getCurrent() {
+		return current;
+	}
+
+	VariationNode* getNode(int id) {
+		if (id < 0 || id >= (int)nodes.size()) return NULL;
+		return nodes[id];
+	}
+
+	int getNodeCount() {
+		return (int)nodes.size();
+	}
+
+	void clear();
+};
+
+struct RecordNode {
+	int moveCount;
+	int gameId;
+	bool won;
+	int games;
+	int wins;
+	long long hintsUsed;
+	long long deadEnds;
+	RecordNode* left;
+	RecordNode* right;
+};
+
+struct RecordSummary {
+	long long games;
+	long long wins;
+	long long totalMoves;
+	long long hintsUsed;
+	long long deadEnds;
+	int medianMoves;
+};
+
+class GameRecordsBST {
+private:
+	RecordNode* root;
+	int gameCounter;
+
+	RecordNode* insert(RecordNode* node, int moves, int id, bool won);
+
+	// Finds or creates the node for this move count, so a run of millions of games keeps one node per key.
+	RecordNode* findOrInsert(int moves);
+
+	void mergeFrom(RecordNode* node);
+
+	void summarize(RecordNode* node, RecordSummary& summary, int median);
+
+	int countWins(RecordNode* node) {
+		if (node == NULL) return 0;
+		return countWins(node->left) + node->wins + countWins(node->right);
+	}
+
+	int winsBelow(RecordNode* node, int moves);
+
+	RecordNode* findMin(RecordNode* node);
+
+	void destroyTree(RecordNode* node);
+
+public:
+	GameRecordsBST() {
+		root = NULL;
+		gameCounter = 0;
+	}
+
+	~GameRecordsBST() {
+		destroyTree(root);
+	}
+
+	void addRecord(int moves, bool won) {
+		gameCounter++;
+		root = insert(root, moves, gameCounter, won);
+	}
+
+	void addResults(int moves, int games, int wins, long long hintsUsed, long long deadEnds);
+
+	void merge(GameRecordsBST& other) {
+		mergeFrom(other.root);
+	}
+
+	RecordSummary getSummary();
+
+	RecordNode* getRoot() {
+		return root;
+	}
+
+	RecordNode* getBestGame() {
+		return findMin(root);
+	}
+
+	// Wins that took fewer than moves moves; a winner's rank is this plus one.
+	int countWinsBelow(int moves) {
+		return winsBelow(root, moves);
+	}
+
+	int getTotalGames() {
+		return gameCounter;
+	}
+};
+
+class ConflictGraph {
+private:
+	int rowConflicts[BOARD_SIZE];
+	int colConflicts[BOARD_SIZE];
+	int colorConflicts[BOARD_SIZE];
+	int colorGrid[BOARD_SIZE][BOARD_SIZE];
+
+public:
+	ConflictGraph();
+
+	void setColorGrid(int grid[BOARD_SIZE][BOARD_SIZE]);
+
+	void addQueen(int row, int col);
+
+	void removeQueen(int row, int col);
+
+	bool hasRowConflict(int row) {
+		return rowConflicts[row] > 0;
+	}
+
+	bool hasColConflict(int col) {
+		return colConflicts[col] > 0;
+	}
+
+	bool hasColorConflict(int row, int col) {
+		return colorConflicts[colorGrid[row][col]] > 0;
+	}
+
+	int getRowCount(int row) { return rowConflicts[row]; }
+	int getColCount(int col) { return colConflicts[col]; }
+	int getColorCount(int color) { return colorConflicts[color]; }
+
+	void reset();
+};
+
+struct HintResult {
+	int row;
+	int col;
+	int reason;
+};
+
+class BoardSnapshot {
+public:
+	int board[BOARD_SIZE][BOARD_SIZE];
+	int colorGrid[BOARD_SIZE][BOARD_SIZE];
+	ConflictGraph conflicts;
+	unsigned long long positionHash;
+	unsigned long long markMask;
+
+	bool isValidPosition(int row, int col) {
+		return row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE;
+	}
+
+	bool hasDiagonalTouch(int row, int col);
+
+	bool canPlaceQueen(int row, int col);
+
+	bool findHint(HintResult& result, std::atomic<unsigned int>& latest, unsigned int generation);
+};
+
+class ZobristKeys {
+public:
+	unsigned long long queenKeys[BOARD_SIZE * BOARD_SIZE];
+	unsigned long long colorKeys[BOARD_SIZE * BOARD_SIZE][BOARD_SIZE];
+
+	ZobristKeys();
+
+	static unsigned long long next(unsigned long long& state) {
+		state += 0x9E3779B97F4A7C15ULL;
+		unsigned long long z = state;
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+};
+
+extern const ZobristKeys zobrist;
+
+const unsigned long long ENTRY_HAS_COUNT = 1ULL << 32;
+const unsigned long long ENTRY_HAS_HINT = 1ULL << 33;
+
+struct TableEntry {
+	unsigned long long markMask;
+	unsigned long long data;
+};
+
+class TranspositionTable {
+private:
+	static const int TABLE_SIZE = 1 << 16;
+
+	struct Slot {
+		std::atomic<unsigned long long> check;
+		std::atomic<unsigned long long> markMask;
+		std::atomic<unsigned long long> data;
+	};
+
+	Slot slots[TABLE_SIZE];
+
+public:
+	bool probe(unsigned long long key, TableEntry& entry);
+
+	void store(unsigned long long key, TableEntry& entry);
+
+	static int getCount(TableEntry& entry) {
+		return (int)(entry.data & 0xFFFFFFFFULL);
+	}
+
+	static void setCount(TableEntry& entry, int count) {
+		entry.data = (entry.data & ~0xFFFFFFFFULL) | (unsigned int)count | ENTRY_HAS_COUNT;
+	}
+
+	static void getHint(TableEntry& entry, HintResult& hint);
+
+	static void setHint(TableEntry& entry, HintResult& hint) {
+		unsigned long long packed = hint.row == -1 ? 0xF : (unsigned long long)(hint.row | (hint.col << 4) | (hint.reason << 8));
+		entry.data = (entry.data & ~(0xFFFULL << 40)) | (packed << 40) | ENTRY_HAS_HINT;
+	}
+};
+
+extern TranspositionTable sharedTable;
+
+template <int N>
+class BasicPuzzleSolver {
+public:
+	// Bits per column in a packed solution, and the type that holds N of them.
+	static const int COL_BITS = N <= 8 ? 3 : 4;
+	typedef typename std::conditional<N * COL_BITS <= 32, unsigned int, unsigned long long>::type Packed;
+
+private:
+	// The memo key is usedCols | usedColors << N | (prevCol + 1) << 2N, which needs N <= 13.
+	static const int MEMO_BITS = N <= 8 ? 10 : 15;
+	static const int MEMO_SIZE = 1 << MEMO_BITS;
+	static const int MEMO_LIMIT = MEMO_SIZE * 3 / 4;
+
+	int colors[N][N];
+	int allowed[N];
+	// Regions with an allowed cell in this row or below; any other region still unused is a dead end.
+	int colorsFrom[N + 1];
+	std::vector<unsigned int> memoKeys;
+	std::vector<unsigned int> memoStamps;
+	std::vector<int> memoValues;
+	unsigned int stamp[N];
+	int memoUsed[N];
+
+	void clearLayer(int row) {
+		stamp[row]++;
+		memoUsed[row] = 0;
+		if (stamp[row] == 0) {
+			for (int k = 0; k < MEMO_SIZE; k++) memoStamps[row * MEMO_SIZE + k] = 0;
+			stamp[row] = 1;
+		}
+	}
+
+	void setAllowed(int rowAllowed[N]) {
+		int changed = -1;
+		for (int i = 0; i < N; i++) {
+			if (rowAllowed[i] != allowed[i]) {
+				allowed[i] = rowAllowed[i];
+				changed = i;
+			}
+		}
+		for (int i = 0; i <= changed; i++) {
+			clearLayer(i);
+		}
+		updateColorsFrom();
+	}
+
+	void updateColorsFrom() {
+		colorsFrom[N] = 0;
+		for (int i = N - 1; i >= 0; i--) {
+			colorsFrom[i] = colorsFrom[i + 1];
+			for (int c = 0; c < N; c++) {
+				if ((allowed[i] >> c) & 1) colorsFrom[i] |= 1 << colors[i][c];
+			}
+		}
+	}
+
+	void collect(int row, int usedCols, int usedColors, int prevCol, Packed packed, std::vector<Packed>& out) {
+		if (row == N) {
+			out.push_back(packed);
+			return;
+		}
+		int candidates = allowed[row] & ~usedCols;
+		if (prevCol != -1) candidates &= ~((1 << (prevCol + 1)) | (prevCol > 0 ? 1 << (prevCol - 1) : 0));
+		for (int c = 0; c < N; c++) {
+			if (!(candidates & (1 << c))) continue;
+			if (usedColors & (1 << colors[row][c])) continue;
+			collect(row + 1, usedCols | (1 << c), usedColors | (1 << colors[row][c]), c, packed | ((Packed)c << (COL_BITS * row)), out);
+		}
+	}
+
+	long long search(int row, int usedCols, int usedColors, int prevCol) {
+		if (row == N) return 1;
+		if (~(usedColors | colorsFrom[row]) & ((1 << N) - 1)) return 0;
+		unsigned int key = usedCols | (usedColors << N) | ((prevCol + 1) << (2 * N));
+		unsigned int slot = (key * 2654435761U) >> (32 - MEMO_BITS);
+		unsigned int* keys = &memoKeys[row * MEMO_SIZE];
+		unsigned int* stamps = &memoStamps[row * MEMO_SIZE];
+		while (stamps[slot] == stamp[row]) {
+			if (keys[slot] == key) return memoValues[row * MEMO_SIZE + slot];
+			slot = (slot + 1) & (MEMO_SIZE - 1);
+		}
+
+		long long total = 0;
+		int candidates = allowed[row] & ~usedCols;
+		if (prevCol != -1) candidates &= ~((1 << (prevCol + 1)) | (prevCol > 0 ? 1 << (prevCol - 1) : 0));
+		for (int c = 0; c < N; c++) {
+			if (!(candidates & (1 << c))) continue;
+			if (usedColors & (1 << colors[row][c])) continue;
+			total += search(row + 1, usedCols | (1 << c), usedColors | (1 << colors[row][c]), c);
+		}
+
+		if (memoUsed[row] < MEMO_LIMIT) {
+			while (stamps[slot] == stamp[row]) {
+				slot = (slot + 1) & (MEMO_SIZE - 1);
+			}
+			stamps[slot] = stamp[row];
+			keys[slot] = key;
+			memoValues[row * MEMO_SIZE + slot] = (int)std::min(total, (long long)INT_MAX);
+			memoUsed[row]++;
+		}
+		return total;
+	}
+
+public:
+	BasicPuzzleSolver() : memoKeys(N * MEMO_SIZE), memoStamps(N * MEMO_SIZE, 0), memoValues(N * MEMO_SIZE) {
+		for (int i = 0; i < N; i++) {
+			allowed[i] = -1;
+			stamp[i] = 1;
+			memoUsed[i] = 0;
+		}
+	}
+
+	void setColorGrid(int grid[N][N]) {
+		for (int i = 0; i < N; i++) {
+			for (int j = 0; j < N; j++) {
+				colors[i][j] = grid[i][j];
+			}
+			allowed[i] = -1;
+			clearLayer(i);
+		}
+	}
+
+	// rowAllowed[i] has bit c set if column c of row i may take a queen. Counts past INT_MAX
+	// are clamped.
+	int countSolutions(int rowAllowed[N]) {
+		setAllowed(rowAllowed);
+		return (int)std::min(search(0, 0, 0, -1), (long long)INT_MAX);
+	}
+
+	// Lists every solution as COL_BITS-bit column numbers packed row by row, row 0 in the low bits.
+	void listSolutions(int rowAllowed[N], std::vector<Packed>& out) {
+		setAllowed(rowAllowed);
+		out.clear();
+		collect(0, 0, 0, -1, 0, out);
+	}
+};
+
+// The solver for the game's board.
+typedef BasicPuzzleSolver<BOARD_SIZE> PuzzleSolver;
+
+inline void putVarint(std::vector<unsigned char>& out, unsigned long long value) {
+	while (value >= 0x80) {
+		out.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((unsigned char)value);
+}
+
+inline bool getVarint(const std::vector<unsigned char>& in, size_t& pos, unsigned long long& value) {
+	value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		if (pos >= in.size()) return false;
+		unsigned char byte = in[pos++];
+		value |= (unsigned long long)(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) return true;
+	}
+	return false;
+}
+
+// The 8 board symmetries generateColorRegions() uses: transpose (4-7), then flip rows (2-3, 6-7), then flip columns (odd).
+class PuzzleSymmetry {
+public:
+	static void forward(int transform, int& row, int& col);
+
+	static void inverse(int transform, int& row, int& col);
+
+	// Moves a packed solution (3 bits per row) through a symmetry. Returns false if the queens no longer fill every row.
+	static bool mapSolution(int transform, unsigned int packed, unsigned int& result, bool backward);
+};
+
+// A region map brought to a fixed orientation and color numbering, so every symmetric or
+// relabeled copy of a puzzle gets the same key.
+struct CanonicalForm {
+	unsigned long long key;
+	int transform;
+	int labels[BOARD_SIZE][BOARD_SIZE];
+
+	void compute(const int grid[BOARD_SIZE][BOARD_SIZE]);
+};
+
+inline int popcount64(unsigned long long value) {
+#if defined(_MSC_VER)
+	return (int)__popcnt64(value);
+#else
+	return __builtin_popcountll(value);
+#endif
+}
+
+// A proof that a region map has exactly one solution, checked without a search. It is a search
+// tree written depth first, one byte per node. A node names a row (0-7), column (8-15) or region
+// (16-23) without a queen and is followed by one subtree per open cell of that unit, in cell
+// order; with DEAD set it names such a unit with no open cell left. A line that has placed all
+// eight queens is the solution and takes no byte. The prover branches on the unit with the
+// fewest open cells (the first such unit, or the first with none left), so forced moves cost one
+// byte and most refutations end within a few nodes. The checker accepts no other choice, so each
+// map has exactly one certificate and a byte naming an equivalent unit is still caught.
+class UniquenessCertificate {
+private:
+	static const int UNITS = 3 * BOARD_SIZE;
+	unsigned long long units[UNITS];
+	// Every cell a queen here rules out, itself included.
+	unsigned long long peers[BOARD_SIZE * BOARD_SIZE];
+	// The row, column and region bits (one per unit) of each cell.
+	unsigned int unitsOf[BOARD_SIZE * BOARD_SIZE];
+	int solutions;
+	unsigned long long solution;
+
+	explicit UniquenessCertificate(const int grid[BOARD_SIZE][BOARD_SIZE]);
+
+
+	// Returns false as soon as a second solution turns up.
+	bool prove(unsigned long long queens, unsigned long long open, std::vector<unsigned char>& out);
+
+	// Constant work per byte; the depth is at most one per queen. live has a bit for every unit
+	// still without a queen.
+	bool check(const std::vector<unsigned char>& data, size_t& pos, unsigned long long queens, unsigned long long open, unsigned int live);
+
+public:
+	static const int DEAD = 0x80;
+
+	// A queen bitboard with one queen per row, packed as 3 bits per row like SolutionSet.
+	static unsigned int packSolution(unsigned long long queens);
+
+	// Writes the certificate and the solution it proves unique. Returns false, leaving the
+	// certificate empty, if the map has no solution or more than one.
+	static bool build(const int grid[BOARD_SIZE][BOARD_SIZE], std::vector<unsigned char>& certificate, unsigned int& packed);
+
+	// True if the certificate covers every line of play exactly, with no bytes left over, and
+	// its only solution is packed. Runs in time linear in the certificate size.
+	static bool verify(const int grid[BOARD_SIZE][BOARD_SIZE], const std::vector<unsigned char>& certificate, unsigned int packed);
+};
+
+struct SolutionSet {
+	unsigned long long key;
+	int labels[BOARD_SIZE][BOARD_SIZE];
+	std::vector<unsigned int> solutions;
+	// Proof that solutions[0] is the only one, over labels; empty if there is none.
+	std::vector<unsigned char> certificate;
+};
+
+// Solutions of known puzzles, keyed by canonical hash. Lookups go through a hash-and-displace
+// perfect hash: each key's bucket stores a displacement that sends every key in the bucket to
+// its own slot, so a lookup is two hashes, a key compare and a map compare. Distinct maps that
+// share a key sit next to each other in key order, and the slot names the first of them.
+class SolutionIndex {
+private:
+	// A bucket that finds no free slots within this many displacements restarts the whole
+	// hash with the next seed instead of searching on.
+	static const unsigned int MAX_DISPLACEMENT = 1 << 16;
+
+	std::vector<SolutionSet> sets;
+	std::vector<unsigned int> displacements;
+	std::vector<int> slots;
+	unsigned long long hashSeed;
+
+	unsigned long long mix(unsigned long long key, unsigned long long displacement) const {
+		unsigned long long state = key ^ hashSeed ^ (displacement * 0xD6E8FEB86659FD93ULL);
+		return ZobristKeys::next(state);
+	}
+
+	// Orders canonical maps cell by cell: negative, zero or positive like strcmp.
+	static int compareLabels(const int a[BOARD_SIZE][BOARD_SIZE], const int b[BOARD_SIZE][BOARD_SIZE]) {
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			int diff = a[cell / BOARD_SIZE][cell % BOARD_SIZE] - b[cell / BOARD_SIZE][cell % BOARD_SIZE];
+			if (diff != 0) return diff;
+		}
+		return 0;
+	}
+
+	// Key order, then map order, with a certified copy of a puzzle ahead of uncertified ones so
+	// rebuild() keeps it.
+	static bool byKey(const SolutionSet& a, const SolutionSet& b) {
+		if (a.key != b.key) return a.key < b.key;
+		int order = compareLabels(a.labels, b.labels);
+		if (order != 0) return order < 0;
+		return !a.certificate.empty() && b.certificate.empty();
+	}
+
+	// (size, bucket) pairs, largest bucket first.
+	static bool largerBucket(const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+		return a.first > b.first || (a.first == b.first && a.second < b.second);
+	}
+
+	void insert(const int grid[BOARD_SIZE][BOARD_SIZE], const std::vector<unsigned int>& solutions);
+
+	// True if every packed solution is a legal placement on grid and the certificate, if there
+	// is one, proves that the single stored solution is the only one.
+	static bool checkPuzzle(const int grid[BOARD_SIZE][BOARD_SIZE], const std::vector<unsigned int>& solutions, const std::vector<unsigned char>& certificate);
+
+	// Places every set with the current hashSeed; false if some bucket hit MAX_DISPLACEMENT.
+	bool buildHash();
+
+public:
+	static const int PACK_VERSION = 2;
+
+	SolutionIndex() {
+		hashSeed = 0;
+	}
+
+	// Sorts, drops duplicate maps and rebuilds the perfect hash. Call after adding puzzles.
+	void rebuild();
+
+	// Fills the index from the compile-time table of shipped base maps.
+	void addShipped();
+
+	// Adds a puzzle by solving it, with a certificate if it is unique; used when writing packs.
+	// Takes effect at the next rebuild().
+	void addPuzzle(const int grid[BOARD_SIZE][BOARD_SIZE], PuzzleSolver& solver);
+
+	// The set for a canonical map (CanonicalForm::labels) and its key, or NULL if it is not indexed.
+	const SolutionSet* find(unsigned long long key, const int labels[BOARD_SIZE][BOARD_SIZE]) const;
+
+	int size() const {
+		return (int)sets.size();
+	}
+
+	const SolutionSet& get(int index) const {
+		return sets[index];
+	}
+
+	// Pack layout: "QPAK", version, puzzle count, then per puzzle the canonical region map
+	// (two cells per byte), a solution count, 3 bytes per packed solution, and the certificate's
+	// length and bytes (length 0 if there is none). Version 1 packs have no certificates.
+	std::vector<unsigned char> savePack() const;
+
+	// Adds every puzzle in a pack. Keys are recomputed from the maps rather than trusted, and
+	// each puzzle goes through checkPuzzle(); one failure rejects the whole pack and leaves the
+	// index unchanged. With checkPuzzles = false the puzzles are taken as they are, for callers
+	// such as farm audit that check and report each one themselves.
+	// When merging many packs, pass rebuildNow = false and call rebuild() once at the end.
+	bool loadPack(const std::vector<unsigned char>& in, bool rebuildNow = true, bool checkPuzzles = true);
+};
+
+extern SolutionIndex solutionIndex;
+
+// Rule policies. Each names how many queens every row, column and region takes (PER_UNIT) and
+// which other cells a queen rules out (attacks). attacks() is only read once per policy, to
+// build its AttackTable; the checks themselves are plain mask operations.
+struct ClassicRules {
+	static const int PER_UNIT = 1;
+	static bool attacks(int dr, int dc) {
+		return (dr == 1 || dr == -1) && (dc == 1 || dc == -1);
+	}
+	static const char* name() {
+		return "Classic";
+	}
+};
+
+// Whole diagonals, as a chess queen attacks.
+struct ChessDiagonalRules {
+	static const int PER_UNIT = 1;
+	static bool attacks(int dr, int dc) {
+		return dr != 0 && (dr == dc || dr == -dc);
+	}
+	static const char* name() {
+		return "Chess diagonals";
+	}
+};
+
+// K stars per row, column and region; stars may not touch, even sideways.
+template <int K>
+struct StarBattleRules {
+	static const int PER_UNIT = K;
+	static bool attacks(int dr, int dc) {
+		return (dr != 0 || dc != 0) && dr >= -1 && dr <= 1 && dc >= -1 && dc <= 1;
+	}
+	static const char* name() {
+		return "Star Battle";
+	}
+};
+
+// Classic touching rule plus no two queens a knight's move apart.
+struct KnightExclusionRules {
+	static const int PER_UNIT = 1;
+	static bool attacks(int dr, int dc) {
+		return ClassicRules::attacks(dr, dc) || dr * dr + dc * dc == 5;
+	}
+	static const char* name() {
+		return "Knight exclusion";
+	}
+};
+
+template <class Rules>
+struct AttackTable {
+	unsigned long long masks[BOARD_SIZE * BOARD_SIZE];
+
+	AttackTable() {
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			masks[cell] = 0;
+			for (int other = 0; other < BOARD_SIZE * BOARD_SIZE; other++) {
+				if (Rules::attacks(other / BOARD_SIZE - cell / BOARD_SIZE, other % BOARD_SIZE - cell % BOARD_SIZE)) {
+					masks[cell] |= 1ULL << other;
+				}
+			}
+		}
+	}
+
+	static const AttackTable instance;
+};
+
+template <class Rules>
+const AttackTable<Rules> AttackTable<Rules>::instance;
+
+// An 8x8 board as bitboards, with every check, the propagation and the solver compiled once per
+// rule policy. A unit (row, column or region) that already holds PER_UNIT queens is blocked with
+// a mask built from the comparison, so no check branches on the rules.
+template <class Rules>
+class RuleBoard {
+private:
+	unsigned long long regionMasks[BOARD_SIZE];
+
+	static unsigned long long rowMask(int row) {
+		return 0xFFULL << (BOARD_SIZE * row);
+	}
+
+	static unsigned long long colMask(int col) {
+		return 0x0101010101010101ULL << col;
+	}
+
+	static unsigned long long ifFull(unsigned long long placed, unsigned long long unit) {
+		return unit & (0ULL - (unsigned long long)(popcount64(placed & unit) >= Rules::PER_UNIT));
+	}
+
+	int fillRow(int row, unsigned long long placed, int need, unsigned long long from, int limit, std::vector<unsigned long long>& found) {
+		if (need == 0) return search(row + 1, placed, limit, found);
+		int total = 0;
+		unsigned long long open = ~blocked(placed) & rowMask(row) & from;
+		while (open && (int)found.size() < limit) {
+			unsigned long long bit = open & (0ULL - open);
+			open ^= bit;
+			total += fillRow(row, placed | bit, need - 1, ~((bit << 1) - 1), limit, found);
+		}
+		return total;
+	}
+
+	int search(int row, unsigned long long placed, int limit, std::vector<unsigned long long>& found) {
+		if (row == BOARD_SIZE) {
+			found.push_back(placed);
+			return 1;
+		}
+		int need = Rules::PER_UNIT - popcount64(placed & rowMask(row));
+		return fillRow(row, placed, need, ~0ULL, limit, found);
+	}
+
+public:
+	RuleBoard() {
+		for (int g = 0; g < BOARD_SIZE; g++) regionMasks[g] = 0;
+	}
+
+	// Until regions are set, only rows, columns and attacks constrain placements.
+	void setRegions(const int grid[BOARD_SIZE][BOARD_SIZE]) {
+		for (int g = 0; g < BOARD_SIZE; g++) regionMasks[g] = 0;
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			regionMasks[grid[cell / BOARD_SIZE][cell % BOARD_SIZE]] |= 1ULL << cell;
+		}
+	}
+
+	static bool attacked(unsigned long long placed, int cell) {
+		return (AttackTable<Rules>::instance.masks[cell] & placed) != 0;
+	}
+
+	unsigned long long getRegionMask(int region) const {
+		return regionMasks[region];
+	}
+
+	// Every cell where no further queen may go: occupied, attacked, or in a full unit.
+	unsigned long long blocked(unsigned long long placed) const {
+		unsigned long long mask = placed;
+		for (unsigned long long rest = placed; rest; rest &= rest - 1) {
+			mask |= AttackTable<Rules>::instance.masks[LatencyHistogram::highestBit(rest & (0ULL - rest))];
+		}
+		for (int u = 0; u < BOARD_SIZE; u++) {
+			mask |= ifFull(placed, rowMask(u)) | ifFull(placed, colMask(u)) | ifFull(placed, regionMasks[u]);
+		}
+		return mask;
+	}
+
+	bool canPlace(unsigned long long placed, int row, int col) const {
+		return !((blocked(placed) >> (row * BOARD_SIZE + col)) & 1);
+	}
+
+	static bool isSolved(unsigned long long placed) {
+		return popcount64(placed) == Rules::PER_UNIT * BOARD_SIZE;
+	}
+
+	// Completions of placed, found row by row; stops once limit solutions are in found.
+	int listSolutions(unsigned long long placed, int limit, std::vector<unsigned long long>& found) {
+		found.clear();
+		return search(0, placed, limit, found);
+	}
+};
+
+// Builds fresh 8x8 region maps from a seed: a random placement that obeys the rules seeds one
+// region per row (the segment between that row's queens), regions grow by random flood fill,
+// and the map is kept only if that placement is its single solution. The same seed always
+// gives the same result.
+template <class Rules>
+class BasicPuzzleGenerator {
+private:
+	unsigned long long rng;
+	RuleBoard<Rules> open;
+	RuleBoard<Rules> regions;
+	std::vector<unsigned long long> solutions;
+
+	int random(int bound) {
+		return (int)(ZobristKeys::next(rng) % (unsigned long long)bound);
+	}
+
+	bool plant(unsigned long long& placed, int row, int need) {
+		if (row == BOARD_SIZE) return true;
+		if (need == 0) return plant(placed, row + 1, Rules::PER_UNIT);
+		int order[BOARD_SIZE];
+		for (int c = 0; c < BOARD_SIZE; c++) order[c] = c;
+		for (int c = BOARD_SIZE - 1; c > 0; c--) {
+			int j = random(c + 1);
+			int temp = order[c];
+			order[c] = order[j];
+			order[j] = temp;
+		}
+		for (int k = 0; k < BOARD_SIZE; k++) {
+			if (!open.canPlace(placed, row, order[k])) continue;
+			unsigned long long bit = 1ULL << (row * BOARD_SIZE + order[k]);
+			placed |= bit;
+			if (plant(placed, row, need - 1)) return true;
+			placed &= ~bit;
+		}
+		return false;
+	}
+
+	void growRegions(int grid[BOARD_SIZE][BOARD_SIZE], unsigned long long planted) {
+		int frontier[BOARD_SIZE * BOARD_SIZE];
+		int frontierSize = 0;
+		for (int i = 0; i < BOARD_SIZE; i++) {
+			for (int j = 0; j < BOARD_SIZE; j++) {
+				grid[i][j] = -1;
+			}
+		}
+		for (int r = 0; r < BOARD_SIZE; r++) {
+			int first = BOARD_SIZE, last = -1;
+			for (int c = 0; c < BOARD_SIZE; c++) {
+				if (!((planted >> (r * BOARD_SIZE + c)) & 1)) continue;
+				first = std::min(first, c);
+				last = c;
+			}
+			for (int c = first; c <= last; c++) {
+				grid[r][c] = r;
+				frontier[frontierSize++] = r * BOARD_SIZE + c;
+			}
+		}
+		int dr[] = { -1, 1, 0, 0 };
+		int dc[] = { 0, 0, -1, 1 };
+		while (frontierSize > 0) {
+			int pick = random(frontierSize);
+			int row = frontier[pick] / BOARD_SIZE;
+			int col = frontier[pick] % BOARD_SIZE;
+			int open[4];
+			int openCount = 0;
+			for (int d = 0; d < 4; d++) {
+				int r = row + dr[d];
+				int c = col + dc[d];
+				if (r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE && grid[r][c] == -1) {
+					open[openCount++] = r * BOARD_SIZE + c;
+				}
+			}
+			if (openCount == 0) {
+				frontier[pick] = frontier[--frontierSize];
+				continue;
+			}
+			int next = open[random(openCount)];
+			grid[next / BOARD_SIZE][next % BOARD_SIZE] = grid[row][col];
+			frontier[frontierSize++] = next;
+		}
+	}
+
+	bool staysConnected(int grid[BOARD_SIZE][BOARD_SIZE], int row, int col) {
+		int region = grid[row][col];
+		int stack[BOARD_SIZE * BOARD_SIZE];
+		int stackSize = 0;
+		unsigned long long seen = 1ULL << (row * BOARD_SIZE + col);
+		int total = 0;
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			if (grid[cell / BOARD_SIZE][cell % BOARD_SIZE] != region || ((seen >> cell) & 1)) continue;
+			if (total++ == 0) {
+				stack[stackSize++] = cell;
+				seen |= 1ULL << cell;
+			}
+		}
+		int reached = stackSize;
+		int dr[] = { -1, 1, 0, 0 };
+		int dc[] = { 0, 0, -1, 1 };
+		while (stackSize > 0) {
+			int cell = stack[--stackSize];
+			for (int d = 0; d < 4; d++) {
+				int r = cell / BOARD_SIZE + dr[d];
+				int c = cell % BOARD_SIZE + dc[d];
+				if (r < 0 || r >= BOARD_SIZE || c < 0 || c >= BOARD_SIZE || grid[r][c] != region) continue;
+				if ((seen >> (r * BOARD_SIZE + c)) & 1) continue;
+				seen |= 1ULL << (r * BOARD_SIZE + c);
+				stack[stackSize++] = r * BOARD_SIZE + c;
+				reached++;
+			}
+		}
+		return reached == total;
+	}
+
+	// Breaks a second solution by handing one of its queen cells to a neighbouring region. The
+	// planted queens never move, so the planted solution survives every step.
+	bool breakSolution(int grid[BOARD_SIZE][BOARD_SIZE], unsigned long long planted, unsigned long long other) {
+		int moves[BOARD_SIZE * BOARD_SIZE * 4];
+		int moveCount = 0;
+		int dr[] = { -1, 1, 0, 0 };
+		int dc[] = { 0, 0, -1, 1 };
+		for (unsigned long long rest = other & ~planted; rest; rest &= rest - 1) {
+			int cell = LatencyHistogram::highestBit(rest & (0ULL - rest));
+			int row = cell / BOARD_SIZE;
+			int col = cell % BOARD_SIZE;
+			if (!staysConnected(grid, row, col)) continue;
+			for (int d = 0; d < 4; d++) {
+				int r = row + dr[d];
+				int c = col + dc[d];
+				if (r < 0 || r >= BOARD_SIZE || c < 0 || c >= BOARD_SIZE || grid[r][c] == grid[row][col]) continue;
+				moves[moveCount++] = cell * 4 + d;
+			}
+		}
+		if (moveCount == 0) return false;
+		int move = moves[random(moveCount)];
+		int row = move / 4 / BOARD_SIZE;
+		int col = move / 4 % BOARD_SIZE;
+		grid[row][col] = grid[row + dr[move % 4]][col + dc[move % 4]];
+		return true;
+	}
+
+public:
+	static const int REPAIR_LIMIT = 24;
+
+	long long attempts;
+	unsigned long long planted;
+
+	BasicPuzzleGenerator() {
+		rng = 0;
+		attempts = 0;
+		planted = 0;
+	}
+
+	// Tries up to maxAttempts maps for this seed. Returns false if none had a unique solution;
+	// planted then holds the last map's solution.
+	bool generate(unsigned long long seed, int grid[BOARD_SIZE][BOARD_SIZE], int maxAttempts) {
+		rng = seed;
+		for (int a = 0; a < maxAttempts; a++) {
+			attempts++;
+			planted = 0;
+			if (!plant(planted, 0, Rules::PER_UNIT)) return false;
+			growRegions(grid, planted);
+			for (int step = 0; step <= REPAIR_LIMIT; step++) {
+				regions.setRegions(grid);
+				regions.listSolutions(0, 2, solutions);
+				if (solutions.size() == 1) return true;
+				unsigned long long other = solutions[0] != planted ? solutions[0] : solutions[1];
+				if (step == REPAIR_LIMIT || !breakSolution(grid, planted, other)) break;
+			}
+		}
+		return false;
+	}
+};
+
+typedef BasicPuzzleGenerator<ClassicRules> PuzzleGenerator;
+
+// A puzzle shared read-only by every session playing it: the region map, the region masks, each
+// cell's peers, and the solution worked out once. PuzzleTable::intern() builds one per distinct
+// map; it is freed when the last reference is released.
+class Puzzle {
+private:
+	std::atomic<int> references;
+
+	friend class PuzzleTable;
+
+public:
+	unsigned long long key;
+	unsigned char regions[BOARD_SIZE * BOARD_SIZE];
+	RuleBoard<ClassicRules> rules;
+	// Every cell a queen here rules out: its row, column and region, and the touching diagonals.
+	unsigned long long peers[BOARD_SIZE * BOARD_SIZE];
+	unsigned long long solution;
+	// 0, 1, or 2 for two or more: the search stops at the second solution.
+	int solutionCount;
+
+	Puzzle(const int grid[BOARD_SIZE][BOARD_SIZE], unsigned long long mapKey);
+
+	int getColor(int row, int col) const {
+		return regions[row * BOARD_SIZE + col];
+	}
+
+	bool hasMap(const int grid[BOARD_SIZE][BOARD_SIZE]) const;
+};
+
+// Interns puzzles by region map, so every race on the same map shares one Puzzle. Maps are
+// filed under their Zobrist key but matched cell by cell, so two maps whose keys collide get
+// separate puzzles.
+class PuzzleTable {
+private:
+	typedef std::unordered_multimap<unsigned long long, Puzzle*> PuzzleMap;
+
+	std::mutex lock;
+	PuzzleMap puzzles;
+
+public:
+	~PuzzleTable();
+
+	// Returns the puzzle for this map, built on first use, holding one reference for the caller.
+	Puzzle* intern(const int grid[BOARD_SIZE][BOARD_SIZE]);
+
+	// Adds a reference for a caller that already holds one, so the count cannot reach zero here.
+	void acquire(Puzzle* puzzle) {
+		puzzle->references++;
+	}
+
+	// Drops a reference. The count only falls to zero under the lock, so intern() can never hand
+	// out a puzzle that is about to be deleted.
+	void release(Puzzle* puzzle);
+
+	int size() {
+		std::lock_guard<std::mutex> guard(lock);
+		return (int)puzzles.size();
+	}
+};
+
+extern PuzzleTable puzzleTable;
+
+// One player's mutable state in a race: queens, hand-placed X marks and moves, 32 bytes in all.
+// The rest is read from the shared Puzzle, which the session borrows from its RaceCoordinator.
+// Moves follow QueensGame: a cell that can't take a queen is marked, and placing, removing or
+// clearing recomputes the marks and drops the hand-placed ones.
+class RaceSession {
+private:
+	const Puzzle* puzzle;
+	unsigned long long queens;
+	unsigned long long manualMarks;
+	int moves;
+	unsigned int finishMillis;
+
+	static bool inside(int row, int col) {
+		return row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE;
+	}
+
+public:
+	RaceSession(const Puzzle* shared);
+
+	unsigned long long getMarks() const;
+
+	MoveStatus placeQueen(int row, int col);
+
+	MoveStatus removeQueen(int row, int col);
+
+	MoveStatus markX(int row, int col);
+
+	MoveStatus clearCell(int row, int col);
+
+	// 0 empty, 1 queen, 2 X, like QueensGame::getCell().
+	int getCell(int row, int col) const;
+
+	bool isSolved() const {
+		return popcount64(queens) == BOARD_SIZE;
+	}
+
+	unsigned long long getQueens() const {
+		return queens;
+	}
+
+	int getMoveCount() const {
+		return moves;
+	}
+
+	unsigned int getFinishMillis() const {
+		return finishMillis;
+	}
+
+	void setFinishMillis(unsigned int millis) {
+		finishMillis = millis;
+	}
+};
+
+struct RaceResult {
+	int player;
+	int moves;
+	unsigned int millis;
+	int rank;
+};
+
+// Runs one race: a single interned Puzzle, a contiguous array of sessions added in bulk, and
+// finishers ranked by move count through a GameRecordsBST. Moves on different players may come
+// from different threads; adding players may not overlap with moves.
+class RaceCoordinator {
+private:
+	Puzzle* puzzle;
+	std::vector<RaceSession> sessions;
+	std::vector<int> finishers;
+	GameRecordsBST results;
+	std::chrono::steady_clock::time_point start;
+	std::mutex lock;
+
+	static bool rankedFirst(const RaceResult& a, const RaceResult& b) {
+		return a.rank != b.rank ? a.rank < b.rank : a.millis < b.millis;
+	}
+
+public:
+	RaceCoordinator(const int grid[BOARD_SIZE][BOARD_SIZE]) {
+		puzzle = puzzleTable.intern(grid);
+		start = std::chrono::steady_clock::now();
+	}
+
+	~RaceCoordinator() {
+		puzzleTable.release(puzzle);
+	}
+
+	// Adds count players and returns the first new player id.
+	int addPlayers(int count);
+
+	// action is a MoveHistory code: 1 place, 2 remove, 3 mark, 4 clear.
+	MoveStatus move(int player, int action, int row, int col);
+
+	// 1 for the fewest moves so far, ties sharing a rank; 0 while the player hasn't finished.
+	int getRank(int player);
+
+	// Finishers by rank, then by finishing time.
+	void getStandings(std::vector<RaceResult>& out);
+
+	RaceSession& getSession(int player) {
+		return sessions[player];
+	}
+
+	const Puzzle* getPuzzle() {
+		return puzzle;
+	}
+
+	int getPlayerCount() {
+		return (int)sessions.size();
+	}
+
+	int getFinisherCount() {
+		std::lock_guard<std::mutex> guard(lock);
+		return (int)finishers.size();
+	}
+
+	GameRecordsBST& getResults() {
+		return results;
+	}
+};
+
+enum MoveQuality {
+	MOVE_FORCED,
+	MOVE_GOOD,
+	MOVE_NEUTRAL,
+	MOVE_MISTAKE,
+	MOVE_WASTED
+};
+
+struct MoveAnalysis {
+	int row;
+	int col;
+	int actionType;
+	int solutionsBefore;
+	int solutionsAfter;
+	MoveQuality quality;
+};
+
+class MoveAnalyzer {
+private:
+	PuzzleSolver solver;
+	std::vector<int> enteredBy;
+	std::vector<bool> undone;
+
+	int count(VariationNode* node);
+
+	void leave(VariationNode* node) {
+		if (enteredBy[node->id] != -1) undone[enteredBy[node->id]] = true;
+	}
+
+	void enter(VariationNode* node) {
+		if (enteredBy[node->id] != -1) undone[enteredBy[node->id]] = false;
+	}
+
+	void travel(VariationNode* from, VariationNode* to);
+
+public:
+	void analyze(MoveNode* lastMove, int colorGrid[BOARD_SIZE][BOARD_SIZE], VariationTree& tree, std::vector<MoveAnalysis>& result);
+};
+
+struct SolutionBatch {
+	int count;
+	const int* puzzleIds;
+	const int* regionMaps;
+	const unsigned char* queenRows[BOARD_SIZE];
+	const unsigned char* queenCols[BOARD_SIZE];
+};
+
+class BatchVerifier {
+private:
+	static const unsigned long long NOT_FIRST_COL = 0xFEFEFEFEFEFEFEFEULL;
+	static const unsigned long long NOT_LAST_COL = 0x7F7F7F7F7F7F7F7FULL;
+
+	static bool verifyOne(const SolutionBatch& batch, int s);
+
+#if QUEENS_AVX2
+	QUEENS_AVX2_TARGET static int verifyEight(const SolutionBatch& batch, int s);
+#endif
+
+public:
+	static void verify(const SolutionBatch& batch, unsigned long long* verdicts);
+};
+
+// Lists the solutions of many region maps at once, as packed columns (3 bits per row) like
+// PuzzleSolver::listSolutions(). With AVX2, eight maps run side by side, one per 32-bit lane,
+// each with its own depth-first search. A lane holds its row, the columns and regions in use,
+// the chosen columns, and the untried columns of every row (a byte per row, over two
+// registers). Every step moves each lane one node forward or back; a lane whose search is over
+// takes the next map. CPUs without AVX2 (see avx2Enabled), and calls with fewer than eight
+// maps, run the same search one map at a time.
+class BatchSolver {
+private:
+	// For each map row, one byte per column with the bit of that column's region. The low word
+	// holds columns 3..0 and the high word columns 7..4, in falling order, so the multiply in
+	// blockedColumns() packs them into a column mask.
+	static void buildRegionBits(const int* regions, unsigned int* bits);
+
+	static int searchOne(const int* regions, int row, int cols, int regs, int below, unsigned int chosen, int& left, std::vector<unsigned int>& found);
+
+#if QUEENS_AVX2
+	QUEENS_AVX2_TARGET static __m256i byteAt(__m256i words, __m256i shift) {
+		return _mm256_and_si256(_mm256_srlv_epi32(words, shift), _mm256_set1_epi32(0xFF));
+	}
+
+	QUEENS_AVX2_TARGET static __m256i withByte(__m256i words, __m256i shift, __m256i value) {
+		__m256i cleared = _mm256_andnot_si256(_mm256_sllv_epi32(_mm256_set1_epi32(0xFF), shift), words);
+		return _mm256_or_si256(cleared, _mm256_sllv_epi32(value, shift));
+	}
+
+	// Columns of a row whose region is taken: per column byte, (region bit & taken) is clamped
+	// to 0/1, and multiplying by 0x08040201 gathers the four bytes into the top byte.
+	QUEENS_AVX2_TARGET static __m256i blockedColumns(__m256i low, __m256i high, __m256i regs) {
+		__m256i spread = _mm256_mullo_epi32(regs, _mm256_set1_epi32(0x01010101));
+		__m256i one = _mm256_set1_epi8(1);
+		__m256i gather = _mm256_set1_epi32(0x08040201);
+		__m256i lowHits = _mm256_min_epu8(_mm256_and_si256(low, spread), one);
+		__m256i highHits = _mm256_min_epu8(_mm256_and_si256(high, spread), one);
+		lowHits = _mm256_srli_epi32(_mm256_mullo_epi32(lowHits, gather), 24);
+		highHits = _mm256_srli_epi32(_mm256_mullo_epi32(highHits, gather), 24);
+		return _mm256_or_si256(lowHits, _mm256_slli_epi32(highHits, 4));
+	}
+
+	// The region bit of column col, read from that row's region bytes.
+	QUEENS_AVX2_TARGET static __m256i regionOf(__m256i low, __m256i high, __m256i col) {
+		__m256i three = _mm256_set1_epi32(3);
+		__m256i words = _mm256_blendv_epi8(low, high, _mm256_cmpgt_epi32(col, three));
+		__m256i shift = _mm256_slli_epi32(_mm256_sub_epi32(three, _mm256_and_si256(col, three)), 3);
+		return byteAt(words, shift);
+	}
+
+	QUEENS_AVX2_TARGET static void solveLanes(const unsigned int* bits, int count, int limit, std::vector<unsigned int>& found, std::vector<int>& owners);
+#endif
+
+public:
+	// regionMaps holds count maps of 64 region ids. Solutions of map p end up in
+	// solutions[offsets[p]] .. solutions[offsets[p + 1] - 1], at most limit of them, in the
+	// same order as a row-by-row search from column 0.
+	static void solve(const int* regionMaps, int count, int limit, std::vector<unsigned int>& solutions, std::vector<int>& offsets);
+};
+
+enum SatResult { SAT_UNKNOWN, SAT_SATISFIABLE, SAT_UNSATISFIABLE };
+
+// Conflict-driven clause learning solver: two watched literals per clause, first-UIP learning
+// with clause minimization, VSIDS branching with phase saving, Luby restarts, and periodic
+// removal of learned clauses with a high LBD (number of decision levels they span).
+// A literal is 2 * variable, plus 1 when negated.
+class SatSolver {
+private:
+	static const int HEADER = 2;
+	static const int RESTART_BASE = 100;
+
+	struct Watch {
+		int clause;
+		int blocker;
+	};
+
+	// Per clause: size, LBD << 1 | learned, then the literals. The first two are watched.
+	std::vector<int> arena;
+	std::vector<int> originals;
+	std::vector<int> learnts;
+	std::vector<std::vector<Watch> > watches;
+	std::vector<signed char> values;
+	std::vector<signed char> phases;
+	std::vector<int> levels;
+	std::vector<int> reasons;
+	std::vector<double> activity;
+	std::vector<int> heap;
+	std::vector<int> heapIndex;
+	std::vector<char> seen;
+	std::vector<int> levelStamp;
+	int stampCounter;
+	std::vector<int> trail;
+	std::vector<int> trailLimits;
+	size_t propagated;
+	double activityStep;
+	size_t learntLimit;
+	bool broken;
+	std::vector<int> learnt;
+	std::vector<int> toClear;
+
+	int valueOf(int lit) {
+		int value = values[lit >> 1];
+		return value < 0 ? -1 : value ^ (lit & 1);
+	}
+
+	int decisionLevel() {
+		return (int)trailLimits.size();
+	}
+
+	bool before(int a, int b) {
+		return activity[a] > activity[b];
+	}
+
+	void siftUp(int index);
+
+	void siftDown(int index);
+
+	void heapInsert(int var);
+
+	int heapPop();
+
+	void bump(int var);
+
+	void enqueue(int lit, int reason);
+
+	void cancelUntil(int level);
+
+	void watch(int ref);
+
+	int store(const std::vector<int>& lits, bool isLearnt, int lbd);
+
+	// Returns the conflicting clause, or -1 once every implication is on the trail.
+	int propagate();
+
+	// A literal is redundant if its reason only contains literals already in the clause.
+	bool redundant(int lit);
+
+	void analyze(int conflict, int& backtrackLevel, int& lbd);
+
+	bool locked(int ref) {
+		int lit = arena[ref + HEADER];
+		return valueOf(lit) == 1 && reasons[lit >> 1] == ref;
+	}
+
+	static bool higherLbd(const std::pair<int, int>& a, const std::pair<int, int>& b) {
+		return a.first > b.first;
+	}
+
+	// Drops the worse half of the learned clauses, then compacts the arena and rebuilds the
+	// watch lists. Clauses that are the reason for a current assignment are kept.
+	void reduce();
+
+	static long long luby(int index);
+
+	SatResult search(long long budget, long long stopAt);
+
+public:
+	long long conflicts;
+	long long decisions;
+	long long propagations;
+	std::vector<signed char> model;
+
+	SatSolver();
+
+	// preferTrue sets the phase tried first when the variable is picked for a decision.
+	int newVar(bool preferTrue = false);
+
+	int varCount() {
+		return (int)values.size();
+	}
+
+	// Raises a variable's starting activity, so early decisions follow the caller's hint.
+	void prioritize(int var, double amount) {
+		activity[var] += amount;
+		if (heapIndex[var] != -1) siftUp(heapIndex[var]);
+	}
+
+	int clauseCount() {
+		return (int)(originals.size() + learnts.size());
+	}
+
+	// Adds a clause between solves. Returns false once the clauses are known to be unsatisfiable.
+	bool addClause(std::vector<int> lits);
+
+	// Runs until the clauses are solved or refuted, or conflictLimit more conflicts pass (-1 = no limit).
+	// On SAT_SATISFIABLE, model[var] holds 1 for true and 0 for false.
+	SatResult solve(long long conflictLimit);
+};
+
+// CNF for an n x n queens board. Cell (r, c) is variable r * n + c. Every row, column and region
+// gets one clause saying "at least one queen" plus a sequential-counter "at most one" (3k - 4
+// binary clauses and k - 1 helper variables for k cells). Each pair of diagonally touching cells
+// gets one binary clause.
+class QueensEncoding {
+private:
+	int size;
+	SatSolver sat;
+	std::vector<int> clause;
+
+	void addBinary(int a, int b);
+
+	void exactlyOne(const std::vector<int>& cells);
+
+public:
+	// regionOf[r * n + c] is the region of each cell, numbered 0 to n - 1.
+	QueensEncoding(int n, const std::vector<int>& regionOf);
+
+	void fixQueen(int row, int col) {
+		clause.assign(1, 2 * (row * size + col));
+		sat.addClause(clause);
+	}
+
+	// Fills cols[row] from the model when satisfiable.
+	SatResult solve(long long conflictLimit, std::vector<int>& cols);
+
+	// Forbids the solution in cols and searches again. SAT_UNSATISFIABLE proves cols was the only one.
+	SatResult findAnother(const std::vector<int>& cols, long long conflictLimit, std::vector<int>& other);
+
+	SatSolver& getSolver() {
+		return sat;
+	}
+};
+
+class LargeBoard {
+private:
+	int size;
+	int words;
+	std::vector<unsigned short> regionOf;
+	std::vector<std::vector<int> > regionCells;
+	std::vector<unsigned long long> rowCandidates;
+	std::vector<unsigned long long> colCandidates;
+	std::vector<int> rowCount;
+	std::vector<int> colCount;
+	std::vector<int> regionCount;
+	std::vector<int> queenInRow;
+	std::vector<int> queenInCol;
+	std::vector<int> queenInRegion;
+	std::vector<int> trail;
+	std::vector<int> placed;
+	int queenCount;
+	bool deadEnd;
+	unsigned long long rng;
+	long long solverNodes;
+	long long satConflicts;
+
+	int random(int bound) {
+		return (int)(ZobristKeys::next(rng) % (unsigned long long)bound);
+	}
+
+	void removeCandidate(int row, int col);
+
+	// Makes a cell a candidate again unless a queen still on the board rules it out.
+	void restoreIfFree(int row, int col);
+
+	void restoreTo(int mark);
+
+	void assign(int row, int col);
+
+	void unassign(int trailMark);
+
+	bool buildSolution(std::vector<int>& cols, int row);
+
+	void rebuildCandidates();
+
+	bool search(long long nodeLimit);
+
+public:
+	LargeBoard(int n, unsigned long long seed);
+
+	void generate();
+
+	int getSize() {
+		return size;
+	}
+
+	bool isInside(int row, int col) {
+		return row >= 0 && row < size && col >= 0 && col < size;
+	}
+
+	bool isCandidate(int row, int col) {
+		return (rowCandidates[row * words + col / 64] >> (col % 64)) & 1;
+	}
+
+	bool hasQueen(int row, int col) {
+		return queenInRow[row] == col;
+	}
+
+	int getRegion(int row, int col) {
+		return regionOf[row * size + col];
+	}
+
+	std::vector<int> regionList() {
+		return std::vector<int>(regionOf.begin(), regionOf.end());
+	}
+
+	MoveStatus placeQueen(int row, int col);
+
+	MoveStatus removeQueen(int row, int col);
+
+	bool solve(long long nodeLimit);
+
+	long long getSolverNodes() {
+		return solverNodes;
+	}
+
+	// Solves with the CDCL backend, keeping the queens already placed. satConflicts reports the work done.
+	SatResult solveSat(long long conflictLimit);
+
+	// Looks for two different solutions of the empty board. SAT_UNSATISFIABLE means the puzzle
+	// has exactly one; SAT_SATISFIABLE fills first and second. With no solution at all, first is empty.
+	SatResult findSecondSolution(long long conflictLimit, std::vector<int>& first, std::vector<int>& second);
+
+	long long getSatConflicts() {
+		return satConflicts;
+	}
+
+	int getQueenCount() {
+		return queenCount;
+	}
+
+	size_t memoryBytes();
+
+};
+
+class HintWorker {
+private:
+	std::thread worker;
+	std::mutex lock;
+	std::condition_variable changed;
+	std::condition_variable finished;
+	BoardSnapshot pending;
+	HintResult cached;
+	std::atomic<unsigned int> latest;
+	unsigned int cachedGeneration;
+	bool stopping;
+	bool background;
+	// The thread starts with the first submit() that wants it, so a worker that never runs in
+	// the background never starts one.
+	bool running;
+
+	static bool compute(BoardSnapshot& snapshot, HintResult& result, std::atomic<unsigned int>& latest, unsigned int generation);
+
+	void run();
+
+	void stop();
+
+public:
+	HintWorker();
+
+	~HintWorker() {
+		stop();
+	}
+
+	// With the background thread stopped, getHint() computes the hint on the caller's thread.
+	void setBackground(bool enabled) {
+		background = enabled;
+		if (!enabled) stop();
+	}
+
+	void submit(int board[BOARD_SIZE][BOARD_SIZE], int colorGrid[BOARD_SIZE][BOARD_SIZE], ConflictGraph& conflicts, unsigned long long positionHash, unsigned long long markMask);
+
+	HintResult getHint();
+};
+
+// Telemetry event types. 1-7 are the MoveHistory action codes; these follow them.
+const int EVENT_HINT = 8;
+const int EVENT_START = 9;
+const int EVENT_WIN = 10;
+
+// Event flag: the move went to the cell the last hint suggested.
+const int EVENT_HINTED = 1;
+
+struct TelemetryEvent {
+	unsigned long long time;
+	unsigned long long puzzle;
+	unsigned int session;
+	unsigned char type;
+	unsigned char cell;
+	unsigned char flags;
+};
+
+// Single-producer, single-consumer ring. The game thread pushes and the drain thread pops; when
+// the ring is full the event is counted as dropped instead of waiting.
+class EventRing {
+public:
+	static const unsigned int CAPACITY = 1024;
+
+private:
+	TelemetryEvent events[CAPACITY];
+	std::atomic<unsigned int> head;
+	char padding[64];
+	std::atomic<unsigned int> tail;
+
+public:
+	std::atomic<unsigned long long> dropped;
+
+	EventRing();
+
+	bool push(const TelemetryEvent& event);
+
+	bool pop(TelemetryEvent& event);
+};
+
+class TelemetrySession {
+public:
+	EventRing ring;
+	unsigned int id;
+	std::atomic<bool> closed;
+
+	// Drain-side state, only touched by the drain thread.
+	unsigned long long puzzle;
+	unsigned long long startTime;
+	unsigned long long lastTime;
+	bool won;
+
+	TelemetrySession(unsigned int sessionId);
+
+	void record(int type, int row, int col, int flags, unsigned long long puzzleKey);
+
+	// The drain thread frees the session after writing its last events.
+	void close() {
+		closed = true;
+	}
+};
+
+struct PuzzleTelemetry {
+	long long games;
+	long long wins;
+	double medianSolveSeconds;
+};
+
+struct TelemetrySummary {
+	long long sessions;
+	long long events;
+	long long dropped;
+	long long moves;
+	long long hintedMoves;
+	long long games;
+	long long wins;
+	double thinkP50Seconds;
+	double thinkP99Seconds;
+};
+
+// Streaming per-puzzle counters. The solve-time histogram is the median sketch.
+struct PuzzleAggregate {
+	long long games;
+	long long wins;
+	LatencyHistogram solveTimes;
+
+	PuzzleAggregate();
+};
+
+// Collects events from every session's ring on a background thread. Each drain appends one
+// columnar block per session to the log and folds the events into running aggregates, so
+// the move path only writes into its own ring.
+//
+// Log layout: "QTEL", version, wall-clock seconds and steady-clock nanoseconds at open, then
+// blocks of: 'B', session, event count, first timestamp, a type/flags byte column, a cell
+// column, timestamp deltas as varints, and 8 bytes of puzzle key for each start event.
+// Reopening the file appends a new header.
+class Telemetry {
+private:
+	static const int DRAIN_MILLISECONDS = 50;
+
+	std::thread worker;
+	std::mutex lock;
+	std::condition_variable wake;
+	bool stopping;
+	FILE* log;
+	std::vector<TelemetrySession*> sessions;
+	unsigned int nextSession;
+	std::vector<TelemetryEvent> batch;
+	std::vector<unsigned char> block;
+
+	std::unordered_map<unsigned long long, PuzzleAggregate> puzzles;
+	LatencyHistogram thinkTimes;
+	long long sessionCount;
+	long long eventCount;
+	long long droppedClosed;
+	long long moveCount;
+	long long hintedMoves;
+	long long gameCount;
+	long long winCount;
+
+	static double percentileOf(LatencyHistogram& histogram, double fraction);
+
+	void fold(TelemetrySession* session, const TelemetryEvent& event);
+
+	void encode(unsigned int session);
+
+	void drain();
+
+	void run();
+
+public:
+	static const int LOG_VERSION = 1;
+
+	// Pass an empty path to keep only the aggregates.
+	Telemetry(const std::string& path);
+
+	// Sessions must be closed first; whatever is still in their rings is written out here.
+	~Telemetry();
+
+	bool isLogging() {
+		return log != NULL;
+	}
+
+	TelemetrySession* openSession();
+
+	// Folds everything recorded so far, for callers that want an up-to-date answer.
+	void flush() {
+		std::lock_guard<std::mutex> guard(lock);
+		drain();
+	}
+
+	TelemetrySummary getSummary();
+
+	bool getPuzzle(unsigned long long key, PuzzleTelemetry& result);
+
+	// Reads a whole log back into events, in the order each session recorded them.
+	static bool decode(const std::vector<unsigned char>& in, std::vector<TelemetryEvent>& events);
+};
+
+class QueensGame {
+private:
+	int board[BOARD_SIZE][BOARD_SIZE];
+	int colorGrid[BOARD_SIZE][BOARD_SIZE];
+	int queenCount;
+	int moveCount;
+	MoveHistory history;
+	VariationTree variations;
+	ConflictGraph conflicts;
+	GameRecordsBST* records;
+	unsigned long long puzzleHash;
+	unsigned long long positionHash;
+	unsigned long long queenBits;
+	unsigned long long manualMarks;
+	int solutionsLeft;
+	PuzzleSolver solver;
+	RuleBoard<ClassicRules> rules;
+	MoveAnalyzer analyzer;
+	HintWorker hints;
+	unsigned long long rng;
+	unsigned long long puzzleKey;
+	int puzzleTransform;
+	int puzzleLabels[BOARD_SIZE][BOARD_SIZE];
+	TelemetrySession* telemetry;
+	int hintCell;
+	bool winLogged;
+
+	int random(int bound) {
+		return (int)(ZobristKeys::next(rng) % (unsigned long long)bound);
+	}
+
+	void toggleQueenBits(int row, int col) {
+		positionHash ^= zobrist.queenKeys[row * BOARD_SIZE + col];
+		queenBits ^= 1ULL << (row * BOARD_SIZE + col);
+	}
+
+	void recordVariation(int row, int col, int prevState, int newState) {
+		variations.addMove(row, col, prevState, newState, queenBits, getMarkMask(), manualMarks);
+	}
+
+	void loadVariation(VariationNode* node);
+
+	unsigned long long getMarkMask();
+
+	// Called after every move; costs one ring write when telemetry is attached.
+	void logMove(int type, int row, int col);
+
+	void boardChanged() {
+		solutionsLeft = countSolutions();
+		hints.submit(board, colorGrid, conflicts, positionHash, getMarkMask());
+	}
+
+	void fillAllowed(int allowed[BOARD_SIZE]);
+
+	void applyColorGrid();
+
+	unsigned long long deriveMarks(unsigned long long queens) {
+		return rules.blocked(queens) & ~queens;
+	}
+
+public:
+	// Without background hints no hint thread is started; requestHint() computes on the caller's thread.
+	QueensGame(GameRecordsBST* rec, bool backgroundHints = true);
+
+	~QueensGame() {
+		if (telemetry != NULL) telemetry->close();
+	}
+
+	void initBoard();
+
+	void generateColorRegions();
+
+	bool isValidPosition(int row, int col) {
+		return row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE;
+	}
+
+	bool hasDiagonalTouch(int row, int col) {
+		return RuleBoard<ClassicRules>::attacked(queenBits, row * BOARD_SIZE + col);
+	}
+
+	bool canPlaceQueen(int row, int col);
+
+	void recalculateInvalidMarks();
+
+	int countSolutions();
+
+	bool isSolvable() {
+		return countSolutions() > 0;
+	}
+
+	MoveStatus placeQueen(int row, int col);
+
+	MoveStatus removeQueen(int row, int col);
+
+	MoveStatus markX(int row, int col);
+
+	MoveStatus clearCell(int row, int col);
+
+	MoveStatus undo();
+
+	MoveStatus redo();
+
+	MoveStatus jumpToVariation(int id);
+
+	bool checkWin() {
+		return queenCount == 8;
+	}
+
+	void analyze(std::vector<MoveAnalysis>& moves) {
+		analyzer.analyze(history.getLastMove(), colorGrid, variations, moves);
+	}
+
+	void restart();
+
+	// Version 2 appends each position's redo target; version 1 saves still load.
+	static const int SAVE_VERSION = 2;
+	// Set in a move log entry instead of a cell for a jump back to the starting position.
+	static const int SAVE_NO_CELL = 1 << 9;
+
+	std::vector<unsigned char> saveSession();
+
+	// Parses and checks the whole blob before touching the game, so a corrupt or truncated save
+	// leaves the current game as it was.
+	bool loadSession(const std::vector<unsigned char>& in);
+
+	void seed(unsigned long long value) {
+		rng = value;
+	}
+
+	// Without background hints, requestHint() computes the hint on the calling thread.
+	void setBackgroundHints(bool enabled) {
+		hints.setBackground(enabled);
+	}
+
+	// Starts a new game on a given region map. Every color 0-7 must appear.
+	MoveStatus setPuzzle(const int grid[BOARD_SIZE][BOARD_SIZE]);
+
+	// Starts recording this game's events into sink; pass NULL to stop.
+	void setTelemetry(Telemetry* sink);
+
+	unsigned long long getPuzzleKey() {
+		return puzzleKey;
+	}
+
+	int getCell(int row, int col) {
+		return board[row][col];
+	}
+
+	int getColor(int row, int col) {
+		return colorGrid[row][col];
+	}
+
+	MoveHistory& getHistory() {
+		return history;
+	}
+
+	VariationTree& getVariations() {
+		return variations;
+	}
+
+	ConflictGraph& getConflicts() {
+		return conflicts;
+	}
+
+	int getQueenCount() {
+		return queenCount;
+	}
+
+	MoveStatus requestHint(HintResult& hint);
+
+	// Completes the current position to a full solution. Known puzzles are answered from the
+	// solution index; others are solved one row at a time.
+	MoveStatus solve(int cols[BOARD_SIZE]);
+
+	bool verify(const int cols[BOARD_SIZE]);
+
+	// Columns each row may still take: the queen's column, or every column not marked X by hand.
+	void getAllowed(int allowed[BOARD_SIZE]) {
+		fillAllowed(allowed);
+	}
+
+	int solutionsAfter(int row, int col);
+
+	int getMoveCount() {
+		return moveCount;
+	}
+
+	int getSolutionsLeft() {
+		return solutionsLeft;
+	}
+
+};
+
+enum AgentPolicyType {
+	POLICY_HINT,
+	POLICY_SOLVER,
+	POLICY_RANDOM,
+	POLICY_COUNT
+};
+
+const std::string policyNames[POLICY_COUNT] = { "Hint", "Solver", "Random" };
+
+class AgentPolicy {
+protected:
+	int hintsTaken;
+
+public:
+	AgentPolicy() {
+		hintsTaken = 0;
+	}
+
+	virtual ~AgentPolicy() {}
+
+	// Returns false when the agent sees no way forward from this position.
+	virtual bool chooseMove(QueensGame& game, int& row, int& col) = 0;
+
+	// Hints asked for since the last call.
+	int takeHintCount();
+};
+
+class HintAgent : public AgentPolicy {
+public:
+	bool chooseMove(QueensGame& game, int& row, int& col);
+};
+
+// Picks the cell that keeps the most solutions. The count after placing a queen on a cell is
+// the number of current solutions through it, so one listing per move covers every cell.
+class SolverAgent : public AgentPolicy {
+private:
+	PuzzleSolver solver;
+	std::vector<unsigned int> solutions;
+
+public:
+	bool chooseMove(QueensGame& game, int& row, int& col);
+};
+
+class RandomAgent : public AgentPolicy {
+private:
+	unsigned long long rng;
+
+public:
+	void seed(unsigned long long value) {
+		rng = value;
+	}
+
+	bool chooseMove(QueensGame& game, int& row, int& col);
+};
+
+class SelfPlayTournament {
+private:
+	static const int MOVE_LIMIT = 256;
+	static const int BATCH_SIZE = 64;
+
+	GameRecordsBST results[POLICY_COUNT];
+	std::mutex resultsLock;
+	std::atomic<long long> nextGame;
+	long long totalGames;
+	unsigned long long baseSeed;
+
+	// Plays one game to a win or the move limit. At a dead end the last queen is
+	// taken back and marked X, so the agent has to pick something else.
+	static void playGame(QueensGame& game, AgentPolicy& agent, GameRecordsBST& records);
+
+	void worker();
+
+public:
+	SelfPlayTournament(unsigned long long seed);
+
+	void run(long long games, int threads);
+
+	GameRecordsBST& getResults(int policy) {
+		return results[policy];
+	}
+};
+
+#endif
@@ -0,0 +1,403 @@
+#include "QueensFarm.h"
+#include "QueensEngine.h"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <direct.h>
+#include <process.h>
+#include <sys/utime.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#endif
+using namespace std;
+
+// Queue layout under the farm directory. A lease is a file named after its seed range and moves
+// todo/ -> active/ -> done/ by rename(), which is atomic on one filesystem, so exactly one
+// worker wins each claim. Workers touch their active file as a heartbeat; a lease whose file
+// has not been touched for the timeout goes back to todo/ and is generated again.
+const char* const farmQueues[4] = { "todo", "active", "done", "shards" };
+const int SEED_ATTEMPTS = 64;
+const int HEARTBEAT_SECONDS = 2;
+
+static bool makeDirectory(const string& path) {
+#ifdef _WIN32
+	return _mkdir(path.c_str()) == 0;
+#else
+	return mkdir(path.c_str(), 0777) == 0;
+#endif
+}
+
+// Names in a directory, sorted, skipping hidden entries (temporary files start with '.').
+static bool listDirectory(const string& path, vector<string>& names) {
+	names.clear();
+#ifdef _WIN32
+	WIN32_FIND_DATAA entry;
+	HANDLE search = FindFirstFileA((path + "\\*").c_str(), &entry);
+	if (search == INVALID_HANDLE_VALUE) return false;
+	do {
+		if (entry.cFileName[0] != '.') names.push_back(entry.cFileName);
+	} while (FindNextFileA(search, &entry));
+	FindClose(search);
+#else
+	DIR* dir = opendir(path.c_str());
+	if (dir == NULL) return false;
+	while (dirent* entry = readdir(dir)) {
+		if (entry->d_name[0] != '.') names.push_back(entry->d_name);
+	}
+	closedir(dir);
+#endif
+	sort(names.begin(), names.end());
+	return true;
+}
+
+static bool touchFile(const string& path) {
+	return utime(path.c_str(), NULL) == 0;
+}
+
+static long long modifiedTime(const string& path) {
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0) return -1;
+	return (long long)info.st_mtime;
+}
+
+// The current time on the clock that stamps files in the farm directory. Lease ages are taken
+// against this rather than time(NULL): heartbeats are stamped by whichever host (or file server)
+// wrote them, so a worker whose own clock is off would otherwise reclaim leases that are alive.
+// The probe is a hidden file per worker, so listDirectory() never returns it.
+static long long farmClock(const string& dir, const string& worker) {
+	string probe = dir + "/.clock-" + worker;
+	if (!touchFile(probe)) {
+		ofstream create(probe.c_str());
+	}
+	return modifiedTime(probe);
+}
+
+static string workerName() {
+	char host[256] = "local";
+#ifdef _WIN32
+	DWORD length = sizeof(host);
+	GetComputerNameA(host, &length);
+	long pid = _getpid();
+#else
+	gethostname(host, sizeof(host) - 1);
+	host[sizeof(host) - 1] = 0;
+	long pid = getpid();
+#endif
+	string name = host;
+	for (size_t i = 0; i < name.size(); i++) {
+		if (!isalnum((unsigned char)name[i]) && name[i] != '-') name[i] = '_';
+	}
+	char suffix[32];
+	snprintf(suffix, sizeof(suffix), "-%ld", pid);
+	return name + suffix;
+}
+
+static bool readBlob(const string& path, vector<unsigned char>& blob) {
+	ifstream in(path.c_str(), ios::binary);
+	if (!in) return false;
+	blob.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+	return true;
+}
+
+// Writes next to the target under a hidden name, then renames, so readers never see half a file.
+static bool writeBlob(const string& dir, const string& name, const string& owner, const vector<unsigned char>& blob) {
+	string temp = dir + "/." + name + "." + owner;
+	string path = dir + "/" + name;
+	ofstream out(temp.c_str(), ios::binary);
+	if (!out) return false;
+	if (!blob.empty()) out.write((const char*)&blob[0], blob.size());
+	out.close();
+	if (!out) return false;
+#ifdef _WIN32
+	remove(path.c_str());
+#endif
+	return rename(temp.c_str(), path.c_str()) == 0;
+}
+
+static string leaseName(unsigned long long first, unsigned long long count) {
+	char name[64];
+	snprintf(name, sizeof(name), "seeds-%020llu-%llu", first, count);
+	return name;
+}
+
+static bool parseLease(const string& name, unsigned long long& first, unsigned long long& count) {
+	return sscanf(name.c_str(), "seeds-%llu-%llu", &first, &count) == 2;
+}
+
+static bool parseSeed(const char* text, unsigned long long& value) {
+	char* end;
+	value = strtoull(text, &end, 10);
+	return *text != 0 && *end == 0;
+}
+
+static int farmInit(const string& dir, unsigned long long first, unsigned long long count, unsigned long long leaseSize) {
+	makeDirectory(dir);
+	for (int q = 0; q < 4; q++) {
+		if (!makeDirectory(dir + "/" + farmQueues[q])) {
+			cout << "Cannot create " << dir << "/" << farmQueues[q] << " (is the farm already set up?)\n";
+			return 1;
+		}
+	}
+	unsigned long long leases = 0;
+	for (unsigned long long seed = first; seed - first < count; seed += leaseSize) {
+		unsigned long long size = min(leaseSize, count - (seed - first));
+		if (!writeBlob(dir + "/todo", leaseName(seed, size), "init", vector<unsigned char>())) {
+			cout << "Cannot write lease " << leaseName(seed, size) << "\n";
+			return 1;
+		}
+		leases++;
+	}
+	cout << "Farm " << dir << ": " << count << " seeds in " << leases << " leases of " << leaseSize << "\n";
+	return 0;
+}
+
+// Claims the first lease this worker wins. Workers start at different offsets so they rarely race.
+static bool claimLease(const string& dir, const string& worker, string& lease) {
+	vector<string> todo;
+	if (!listDirectory(dir + "/todo", todo) || todo.empty()) return false;
+	unsigned long long state = 0;
+	for (size_t i = 0; i < worker.size(); i++) state = state * 131 + (unsigned char)worker[i];
+	size_t start = (size_t)(ZobristKeys::next(state) % todo.size());
+	for (size_t k = 0; k < todo.size(); k++) {
+		const string& name = todo[(start + k) % todo.size()];
+		if (rename((dir + "/todo/" + name).c_str(), (dir + "/active/" + name + "@" + worker).c_str()) == 0) {
+			lease = name;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Moves leases whose worker stopped heartbeating back to todo/. Returns the number still running.
+static int reclaimExpired(const string& dir, const string& worker, long long timeoutSeconds, int& reclaimed) {
+	vector<string> active;
+	listDirectory(dir + "/active", active);
+	int running = 0;
+	reclaimed = 0;
+	long long now = farmClock(dir, worker);
+	for (size_t k = 0; k < active.size(); k++) {
+		string path = dir + "/active/" + active[k];
+		long long touched = modifiedTime(path);
+		if (touched < 0) continue;
+		long long age = now - touched;
+		if (now < 0 || age <= timeoutSeconds) {
+			running++;
+			continue;
+		}
+		string lease = active[k].substr(0, active[k].find('@'));
+		if (rename(path.c_str(), (dir + "/todo/" + lease).c_str()) == 0) {
+			cout << "Reclaimed " << lease << " from " << active[k].substr(lease.size() + 1) << " (silent for " << age << "s)\n";
+			reclaimed++;
+		}
+	}
+	return running;
+}
+
+// Generates every seed in the lease into one shard. Returns false if the lease was taken away.
+static bool runLease(const string& dir, const string& worker, const string& lease) {
+	unsigned long long first, count;
+	string activePath = dir + "/active/" + lease + "@" + worker;
+	if (!parseLease(lease, first, count)) {
+		cout << "Skipping malformed lease " << lease << "\n";
+		rename(activePath.c_str(), (dir + "/done/" + lease).c_str());
+		return false;
+	}
+
+	PuzzleGenerator generator;
+	PuzzleSolver solver;
+	SolutionIndex shard;
+	int grid[BOARD_SIZE][BOARD_SIZE];
+	int failed = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	chrono::steady_clock::time_point heartbeat = start;
+	for (unsigned long long seed = first; seed - first < count; seed++) {
+		if (generator.generate(seed, grid, SEED_ATTEMPTS)) shard.addPuzzle(grid, solver);
+		else failed++;
+
+		chrono::steady_clock::time_point now = chrono::steady_clock::now();
+		if (now - heartbeat >= chrono::seconds(HEARTBEAT_SECONDS)) {
+			heartbeat = now;
+			if (!touchFile(activePath)) {
+				cout << "Lost " << lease << " to lease recovery, dropping it\n";
+				return false;
+			}
+		}
+	}
+	shard.rebuild();
+
+	if (!writeBlob(dir + "/shards", lease + ".qpak", worker, shard.savePack())) {
+		cout << "Cannot write shard for " << lease << "\n";
+		return false;
+	}
+	if (rename(activePath.c_str(), (dir + "/done/" + lease).c_str()) != 0) {
+		cout << "Lost " << lease << " to lease recovery after writing its shard\n";
+		return false;
+	}
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	cout << lease << ": " << shard.size() << " puzzles, " << failed << " seeds without one, "
+		<< (int)(count / max(seconds, 1e-3)) << " seeds/s\n";
+	return true;
+}
+
+static int farmWork(const string& dir, long long timeoutSeconds) {
+	string worker = workerName();
+	int leases = 0;
+	while (true) {
+		string lease;
+		if (claimLease(dir, worker, lease)) {
+			if (runLease(dir, worker, lease)) leases++;
+			continue;
+		}
+		int reclaimed;
+		int running = reclaimExpired(dir, worker, timeoutSeconds, reclaimed);
+		if (reclaimed > 0) continue;
+		if (running == 0) break;
+		this_thread::sleep_for(chrono::seconds(1));
+	}
+	remove((dir + "/.clock-" + worker).c_str());
+	cout << "Worker " << worker << " finished " << leases << " leases\n";
+	return 0;
+}
+
+static int farmStatus(const string& dir) {
+	string worker = workerName();
+	long long now = -1;
+	for (int q = 0; q < 4; q++) {
+		vector<string> names;
+		if (!listDirectory(dir + "/" + farmQueues[q], names)) {
+			cout << dir << " is not a farm directory\n";
+			return 1;
+		}
+		cout << farmQueues[q] << ": " << names.size() << "\n";
+		if (q != 1) continue;
+		if (!names.empty()) now = farmClock(dir, worker);
+		for (size_t k = 0; k < names.size(); k++) {
+			cout << "  " << names[k] << " (last heartbeat " << now - modifiedTime(dir + "/active/" + names[k]) << "s ago)\n";
+		}
+	}
+	if (now >= 0) remove((dir + "/.clock-" + worker).c_str());
+	return 0;
+}
+
+// Loads every shard into one index. rebuild() drops puzzles with the same canonical key, so a
+// puzzle found by two workers, or again after a rotation or recoloring, is kept once.
+static int farmMerge(const string& dir, const string& output) {
+	vector<string> shards, pending;
+	if (!listDirectory(dir + "/shards", shards)) {
+		cout << dir << " is not a farm directory\n";
+		return 1;
+	}
+	listDirectory(dir + "/todo", pending);
+	vector<string> running;
+	listDirectory(dir + "/active", running);
+	if (!pending.empty() || !running.empty()) {
+		cout << "Warning: " << pending.size() + running.size() << " leases are not finished yet\n";
+	}
+
+	SolutionIndex merged;
+	vector<unsigned char> blob;
+	for (size_t k = 0; k < shards.size(); k++) {
+		if (!readBlob(dir + "/shards/" + shards[k], blob) || !merged.loadPack(blob, false)) {
+			cout << "Skipping unreadable shard " << shards[k] << "\n";
+		}
+	}
+	int total = merged.size();
+	merged.rebuild();
+
+	size_t slash = output.find_last_of("/\\");
+	string outDir = slash == string::npos ? "." : output.substr(0, slash);
+	string outName = slash == string::npos ? output : output.substr(slash + 1);
+	if (!writeBlob(outDir, outName, workerName(), merged.savePack())) {
+		cout << "Cannot write " << output << "\n";
+		return 1;
+	}
+	cout << "Merged " << shards.size() << " shards: " << total << " puzzles, " << merged.size() << " unique -> " << output << "\n";
+	return 0;
+}
+
+// Checks that every puzzle in a pack has one solution, and that it is the solution the pack
+// stores. Certified puzzles are checked against their certificate; the rest, and any whose
+// certificate fails, are searched in full.
+static int farmAudit(const string& pack) {
+	vector<unsigned char> blob;
+	SolutionIndex index;
+	if (!readBlob(pack, blob) || !index.loadPack(blob, false, false)) {
+		cout << "Cannot read pack " << pack << "\n";
+		return 1;
+	}
+
+	int verified = 0, rejected = 0, searched = 0, ambiguous = 0, mismatched = 0;
+	double verifySeconds = 0, searchSeconds = 0;
+	size_t certificateBytes = 0;
+	RuleBoard<ClassicRules> board;
+	vector<unsigned long long> found;
+	for (int k = 0; k < index.size(); k++) {
+		const SolutionSet& set = index.get(k);
+		if (!set.certificate.empty()) {
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			// A certificate proves exactly one stored solution; a pack storing none or several is corrupt.
+			bool valid = set.solutions.size() == 1 && UniquenessCertificate::verify(set.labels, set.certificate, set.solutions[0]);
+			verifySeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+			certificateBytes += set.certificate.size();
+			if (valid) {
+				verified++;
+				continue;
+			}
+			rejected++;
+			cout << "Puzzle " << k << ": certificate rejected\n";
+		}
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		board.setRegions(set.labels);
+		int count = board.listSolutions(0, 2, found);
+		searchSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		searched++;
+		if (count != 1) {
+			ambiguous++;
+			cout << "Puzzle " << k << ": " << (count == 0 ? "no solution" : "more than one solution") << "\n";
+		}
+		else if (set.solutions.size() != 1 || set.solutions[0] != UniquenessCertificate::packSolution(found[0])) {
+			mismatched++;
+			cout << "Puzzle " << k << ": stored solution is not the one the search finds\n";
+		}
+	}
+
+	cout << index.size() << " puzzles: " << verified << " verified by certificate";
+	if (verified > 0) {
+		cout << " (" << certificateBytes / verified << " bytes, " << (int)(verifySeconds * 1e9 / verified) << "ns each)";
+	}
+	cout << ", " << rejected << " rejected, " << searched << " searched";
+	if (searched > 0) cout << " (" << (int)(searchSeconds * 1e9 / searched) << "ns each)";
+	cout << ", " << ambiguous << " not unique, " << mismatched << " with a wrong stored solution\n";
+	return rejected > 0 || ambiguous > 0 || mismatched > 0 ? 1 : 0;
+}
+
+int runFarm(int argc, char** argv) {
+	string command = argc > 0 ? argv[0] : "";
+	unsigned long long first, count, leaseSize = 1000, timeout = 60;
+	if (command == "init" && (argc == 4 || argc == 5) && parseSeed(argv[2], first) && parseSeed(argv[3], count)
+		&& (argc == 4 || parseSeed(argv[4], leaseSize)) && leaseSize > 0) {
+		return farmInit(argv[1], first, count, leaseSize);
+	}
+	if (command == "work" && (argc == 2 || (argc == 3 && parseSeed(argv[2], timeout)))) {
+		return farmWork(argv[1], (long long)timeout);
+	}
+	if (command == "status" && argc == 2) return farmStatus(argv[1]);
+	if (command == "merge" && argc == 3) return farmMerge(argv[1], argv[2]);
+	if (command == "audit" && argc == 2) return farmAudit(argv[1]);
+
+	cout << "Usage:\n"
+		<< "  Queens farm init <dir> <first seed> <seed count> [lease size]\n"
+		<< "  Queens farm work <dir> [lease timeout seconds]\n"
+		<< "  Queens farm status <dir>\n"
+		<< "  Queens farm merge <dir> <output pack>\n"
+		<< "  Queens farm audit <pack>\n";
+	return 2;
+}
@@ -0,0 +1,16 @@
+#ifndef QUEENS_FARM_H
+#define QUEENS_FARM_H
+
+/*
+ * Puzzle farm: generates uniquely solvable puzzles across several processes or
+ * machines that share only a directory. Run as "Queens farm <command> ...".
+ *
+ *   init <dir> <first seed> <seed count> [lease size]   split the seeds into leases
+ *   work <dir> [lease timeout seconds]                   claim leases and write shards
+ *   status <dir>                                         count leases in each state
+ *   merge <dir> <output pack>                            dedupe all shards into one pack
+ *   audit <pack>                                         check every puzzle is unique
+ */
+int runFarm(int argc, char** argv);
+
+#endif
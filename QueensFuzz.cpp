@@ -0,0 +1,561 @@
+#include "QueensFuzz.h"
+#include "QueensEngine.h"
+#include <iostream>
+#include <sstream>
+#include <map>
+using namespace std;
+
+enum FuzzOpType {
+	FUZZ_PLACE,
+	FUZZ_REMOVE,
+	FUZZ_MARK,
+	FUZZ_CLEAR,
+	FUZZ_UNDO,
+	FUZZ_REDO,
+	FUZZ_JUMP,
+	FUZZ_RELOAD,
+	FUZZ_OP_COUNT
+};
+
+// Out of 100: how often each operation is drawn. Placing dominates so games get deep; undo
+// followed by a different move is what grows side branches in the variation tree.
+const int fuzzWeights[FUZZ_OP_COUNT] = { 34, 10, 14, 10, 16, 8, 6, 2 };
+
+struct FuzzOp {
+	int type;
+	int row;
+	int col;
+};
+
+// The game rules written out directly: one mask per cell for its row, column, region and
+// diagonal neighbours, built by plain loops when a puzzle starts, and a position is three
+// bitboards. Marks are the union of the queens' masks and solution counts come from a row-by-row
+// search, so nothing is shared with QueensGame's ConflictGraph, solver or variation tree, and a
+// bookkeeping slip in either one shows up as a difference.
+class ReferenceGame {
+private:
+	struct Position {
+		int parent;
+		int lastVisited;
+		int row;
+		int col;
+		int newState;
+		unsigned long long queens;
+		unsigned long long marks;
+		unsigned long long manual;
+		vector<int> children;
+	};
+
+	int regions[BOARD_SIZE * BOARD_SIZE];
+	unsigned long long rowMask[BOARD_SIZE * BOARD_SIZE];
+	unsigned long long colMask[BOARD_SIZE * BOARD_SIZE];
+	unsigned long long regionMask[BOARD_SIZE * BOARD_SIZE];
+	unsigned long long touchMask[BOARD_SIZE * BOARD_SIZE];
+	unsigned long long queens;
+	unsigned long long marks;
+	vector<Position> positions;
+	map<pair<unsigned long long, unsigned long long>, int> counts;
+
+	static bool inside(int row, int col) {
+		return row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE;
+	}
+
+	void setCell(int cell, int state) {
+		unsigned long long bit = 1ULL << cell;
+		cells[cell] = state;
+		queens = state == 1 ? queens | bit : queens & ~bit;
+		marks = state == 2 ? marks | bit : marks & ~bit;
+	}
+
+	MoveStatus placeCheck(int row, int col) {
+		int cell = row * BOARD_SIZE + col;
+		if (cells[cell] == 1) return STATUS_OCCUPIED;
+		if (cells[cell] == 2) return STATUS_MARKED;
+		if (queens & rowMask[cell]) return STATUS_ROW_CONFLICT;
+		if (queens & colMask[cell]) return STATUS_COL_CONFLICT;
+		if (queens & regionMask[cell]) return STATUS_REGION_CONFLICT;
+		if (queens & touchMask[cell]) return STATUS_DIAGONAL_TOUCH;
+		return STATUS_OK;
+	}
+
+	// Recomputes every X from the queens: hand-placed marks are dropped, as QueensGame does.
+	void remark() {
+		manual = 0;
+		unsigned long long ruled = 0;
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			if ((queens >> cell) & 1) ruled |= rowMask[cell] | colMask[cell] | regionMask[cell] | touchMask[cell];
+		}
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			if (cells[cell] != 1) setCell(cell, (ruled >> cell) & 1 ? 2 : 0);
+		}
+	}
+
+	// Completions of the queens on the board, row by row, skipping cells the player marked by
+	// hand. cols and used hold the columns and regions already taken, prev the column above.
+	int countFrom(int row, int cols, int used, int prev) {
+		if (row == BOARD_SIZE) return 1;
+		int rowQueens = (int)((queens >> (row * BOARD_SIZE)) & ((1 << BOARD_SIZE) - 1));
+		if (rowQueens != 0) {
+			int col = 0;
+			while (!((rowQueens >> col) & 1)) col++;
+			return col == prev - 1 || col == prev + 1 ? 0 : countFrom(row + 1, cols, used, col);
+		}
+		int open = ~(int)(manual >> (row * BOARD_SIZE)) & ~cols & ((1 << BOARD_SIZE) - 1);
+		if (prev >= 0) open &= ~((2 << prev) | (1 << prev >> 1));
+		int total = 0;
+		for (int col = 0; col < BOARD_SIZE; col++) {
+			if (!((open >> col) & 1)) continue;
+			int region = regions[row * BOARD_SIZE + col];
+			if (!((used >> region) & 1)) total += countFrom(row + 1, cols | 1 << col, used | 1 << region, col);
+		}
+		return total;
+	}
+
+	int countSolutions() {
+		pair<unsigned long long, unsigned long long> key(queens, manual);
+		map<pair<unsigned long long, unsigned long long>, int>::iterator found = counts.find(key);
+		if (found != counts.end()) return found->second;
+		int cols = 0, used = 0;
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			if (cells[cell] != 1) continue;
+			cols |= 1 << (cell % BOARD_SIZE);
+			used |= 1 << regions[cell];
+		}
+		int count = countFrom(0, cols, used, -2);
+		counts[key] = count;
+		return count;
+	}
+
+	void record(int row, int col, int newState) {
+		Position& parent = positions[current];
+		for (size_t k = 0; k < parent.children.size(); k++) {
+			Position& child = positions[parent.children[k]];
+			if (child.row == row && child.col == col && child.newState == newState && child.manual == manual
+				&& child.queens == queens && child.marks == marks) {
+				parent.lastVisited = parent.children[k];
+				current = parent.children[k];
+				return;
+			}
+		}
+		Position next;
+		next.parent = current;
+		next.lastVisited = -1;
+		next.row = row;
+		next.col = col;
+		next.newState = newState;
+		next.queens = queens;
+		next.marks = marks;
+		next.manual = manual;
+		int id = (int)positions.size();
+		positions[current].children.push_back(id);
+		positions[current].lastVisited = id;
+		positions.push_back(next);
+		current = id;
+	}
+
+	MoveStatus finish(int type, int row, int col) {
+		solutionsLeft = countSolutions();
+		lastType = type;
+		lastRow = row;
+		lastCol = col;
+		return STATUS_OK;
+	}
+
+	void load(int id) {
+		current = id;
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			setCell(cell, (positions[id].queens >> cell) & 1 ? 1 : (positions[id].marks >> cell) & 1 ? 2 : 0);
+		}
+		manual = positions[id].manual;
+	}
+
+public:
+	int cells[BOARD_SIZE * BOARD_SIZE];
+	unsigned long long manual;
+	int current;
+	int moveCount;
+	int solutionsLeft;
+	int lastType;
+	int lastRow;
+	int lastCol;
+
+	void reset(const int grid[BOARD_SIZE][BOARD_SIZE]) {
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			regions[cell] = grid[cell / BOARD_SIZE][cell % BOARD_SIZE];
+			cells[cell] = 0;
+		}
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			int row = cell / BOARD_SIZE;
+			int col = cell % BOARD_SIZE;
+			rowMask[cell] = colMask[cell] = regionMask[cell] = touchMask[cell] = 0;
+			for (int other = 0; other < BOARD_SIZE * BOARD_SIZE; other++) {
+				if (other == cell) continue;
+				int dr = other / BOARD_SIZE - row;
+				int dc = other % BOARD_SIZE - col;
+				if (dr == 0) rowMask[cell] |= 1ULL << other;
+				if (dc == 0) colMask[cell] |= 1ULL << other;
+				if (regions[other] == regions[cell]) regionMask[cell] |= 1ULL << other;
+				if ((dr == 1 || dr == -1) && (dc == 1 || dc == -1)) touchMask[cell] |= 1ULL << other;
+			}
+		}
+		queens = 0;
+		marks = 0;
+		manual = 0;
+		moveCount = 0;
+		counts.clear();
+		positions.assign(1, Position());
+		positions[0].parent = -1;
+		positions[0].lastVisited = -1;
+		positions[0].row = -1;
+		positions[0].col = -1;
+		positions[0].newState = 0;
+		positions[0].queens = 0;
+		positions[0].marks = 0;
+		positions[0].manual = 0;
+		current = 0;
+		solutionsLeft = countSolutions();
+		lastType = 0;
+		lastRow = -1;
+		lastCol = -1;
+	}
+
+	int getPositionCount() {
+		return (int)positions.size();
+	}
+
+	int getParent(int id) {
+		return positions[id].parent;
+	}
+
+	int getLastVisited(int id) {
+		return positions[id].lastVisited;
+	}
+
+	int getRegion(int cell) {
+		return regions[cell];
+	}
+
+	MoveStatus place(int row, int col) {
+		if (!inside(row, col)) return STATUS_OUT_OF_RANGE;
+		MoveStatus status = placeCheck(row, col);
+		if (status != STATUS_OK) return status;
+		setCell(row * BOARD_SIZE + col, 1);
+		moveCount++;
+		remark();
+		record(row, col, 1);
+		return finish(1, row, col);
+	}
+
+	MoveStatus remove(int row, int col) {
+		if (!inside(row, col)) return STATUS_OUT_OF_RANGE;
+		if (cells[row * BOARD_SIZE + col] != 1) return STATUS_NO_QUEEN;
+		setCell(row * BOARD_SIZE + col, 0);
+		moveCount++;
+		remark();
+		record(row, col, 0);
+		return finish(2, row, col);
+	}
+
+	MoveStatus mark(int row, int col) {
+		if (!inside(row, col)) return STATUS_OUT_OF_RANGE;
+		int cell = row * BOARD_SIZE + col;
+		if (cells[cell] == 1) return STATUS_IS_QUEEN;
+		if (cells[cell] == 2) return STATUS_ALREADY_MARKED;
+		setCell(cell, 2);
+		manual |= 1ULL << cell;
+		moveCount++;
+		record(row, col, 2);
+		return finish(3, row, col);
+	}
+
+	MoveStatus clear(int row, int col) {
+		if (!inside(row, col)) return STATUS_OUT_OF_RANGE;
+		if (cells[row * BOARD_SIZE + col] == 0) return STATUS_ALREADY_EMPTY;
+		setCell(row * BOARD_SIZE + col, 0);
+		moveCount++;
+		remark();
+		record(row, col, 0);
+		return finish(4, row, col);
+	}
+
+	MoveStatus undo() {
+		if (positions[current].parent < 0) return STATUS_NOTHING_TO_UNDO;
+		int undone = current;
+		load(positions[current].parent);
+		return finish(5, positions[undone].row, positions[undone].col);
+	}
+
+	MoveStatus redo() {
+		if (positions[current].lastVisited < 0) return STATUS_NOTHING_TO_REDO;
+		load(positions[current].lastVisited);
+		return finish(6, positions[current].row, positions[current].col);
+	}
+
+	MoveStatus jump(int id) {
+		if (id == current) return STATUS_SAME_POSITION;
+		if (id < 0 || id >= (int)positions.size()) return STATUS_NO_SUCH_POSITION;
+		for (int node = id; positions[node].parent >= 0; node = positions[node].parent) {
+			positions[positions[node].parent].lastVisited = node;
+		}
+		load(id);
+		return finish(7, positions[id].row, positions[id].col);
+	}
+};
+
+static unsigned long long fuzzNext(unsigned long long& rng, unsigned long long bound) {
+	return ZobristKeys::next(rng) % bound;
+}
+
+// Mostly aims at cells where the operation can succeed, sometimes anywhere, and now and then
+// just off the board.
+static FuzzOp randomOp(ReferenceGame& model, unsigned long long& rng) {
+	FuzzOp op;
+	int pick = (int)fuzzNext(rng, 100);
+	op.type = 0;
+	while (pick >= fuzzWeights[op.type]) {
+		pick -= fuzzWeights[op.type];
+		op.type++;
+	}
+	op.row = (int)fuzzNext(rng, BOARD_SIZE);
+	op.col = (int)fuzzNext(rng, BOARD_SIZE);
+	if (op.type == FUZZ_JUMP) {
+		op.row = (int)fuzzNext(rng, model.getPositionCount() + 1);
+		op.col = 0;
+	}
+	if (op.type > FUZZ_CLEAR) return op;
+
+	int want = op.type == FUZZ_PLACE || op.type == FUZZ_MARK ? 0 : op.type == FUZZ_REMOVE ? 1 : -1;
+	if (fuzzNext(rng, 4) != 0) {
+		int start = (int)fuzzNext(rng, BOARD_SIZE * BOARD_SIZE);
+		for (int k = 0; k < BOARD_SIZE * BOARD_SIZE; k++) {
+			int cell = (start + k) % (BOARD_SIZE * BOARD_SIZE);
+			if (want < 0 ? model.cells[cell] == 0 : model.cells[cell] != want) continue;
+			op.row = cell / BOARD_SIZE;
+			op.col = cell % BOARD_SIZE;
+			break;
+		}
+	}
+	if (fuzzNext(rng, 64) == 0) op.row = fuzzNext(rng, 2) == 0 ? -1 : BOARD_SIZE;
+	return op;
+}
+
+static string describeOp(const FuzzOp& op) {
+	const char* const letters = "qdxcurj";
+	ostringstream text;
+	if (op.type == FUZZ_RELOAD) text << "save+load";
+	else text << letters[op.type];
+	if (op.type <= FUZZ_CLEAR) text << op.row << "," << op.col;
+	if (op.type == FUZZ_JUMP) text << op.row;
+	return text.str();
+}
+
+// Compares everything QueensGame exposes with the reference. Returns "" when they agree.
+static string compareState(QueensGame& game, ReferenceGame& model) {
+	ostringstream diff;
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		int row = cell / BOARD_SIZE;
+		int col = cell % BOARD_SIZE;
+		if (game.getCell(row, col) != model.cells[cell]) {
+			diff << "cell (" << row << ", " << col << ") is " << game.getCell(row, col) << ", expected " << model.cells[cell];
+			return diff.str();
+		}
+	}
+
+	int queens = 0, rows[BOARD_SIZE] = { 0 }, cols[BOARD_SIZE] = { 0 }, colors[BOARD_SIZE] = { 0 };
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		if (model.cells[cell] != 1) continue;
+		queens++;
+		rows[cell / BOARD_SIZE]++;
+		cols[cell % BOARD_SIZE]++;
+		colors[model.getRegion(cell)]++;
+	}
+	ConflictGraph& conflicts = game.getConflicts();
+	for (int k = 0; k < BOARD_SIZE; k++) {
+		if (conflicts.getRowCount(k) != rows[k]) diff << "row " << k << " conflict count " << conflicts.getRowCount(k) << ", expected " << rows[k];
+		else if (conflicts.getColCount(k) != cols[k]) diff << "column " << k << " conflict count " << conflicts.getColCount(k) << ", expected " << cols[k];
+		else if (conflicts.getColorCount(k) != colors[k]) diff << "region " << k << " conflict count " << conflicts.getColorCount(k) << ", expected " << colors[k];
+		else continue;
+		return diff.str();
+	}
+
+	if (game.getQueenCount() != queens) diff << "queen count " << game.getQueenCount() << ", expected " << queens;
+	else if (game.getMoveCount() != model.moveCount) diff << "move count " << game.getMoveCount() << ", expected " << model.moveCount;
+	else if (game.getSolutionsLeft() != model.solutionsLeft) diff << "solutions left " << game.getSolutionsLeft() << ", expected " << model.solutionsLeft;
+	if (!diff.str().empty()) return diff.str();
+
+	VariationTree& variations = game.getVariations();
+	VariationNode* current = variations.getCurrent();
+	int parent = current->parent == NULL ? -1 : current->parent->id;
+	int lastVisited = current->lastVisited == NULL ? -1 : current->lastVisited->id;
+	if (variations.getNodeCount() != model.getPositionCount()) diff << "position count " << variations.getNodeCount() << ", expected " << model.getPositionCount();
+	else if (current->id != model.current) diff << "current position #" << current->id << ", expected #" << model.current;
+	else if (parent != model.getParent(model.current)) diff << "undo goes to #" << parent << ", expected #" << model.getParent(model.current);
+	else if (lastVisited != model.getLastVisited(model.current)) diff << "redo goes to #" << lastVisited << ", expected #" << model.getLastVisited(model.current);
+	else if (current->manualMarks != model.manual) diff << "manual marks " << hex << current->manualMarks << ", expected " << model.manual << dec;
+	if (!diff.str().empty()) return diff.str();
+
+	MoveNode* last = game.getHistory().getLastMove();
+	if (model.lastType == 0) {
+		if (last != NULL) diff << "history has a move before any move was made";
+	}
+	else if (last == NULL) diff << "history is empty";
+	else if (last->actionType != model.lastType || last->row != model.lastRow || last->col != model.lastCol
+		|| last->nodeId != model.current || last->solutionsLeft != model.solutionsLeft) {
+		diff << "last history entry is action " << last->actionType << " at (" << last->row << ", " << last->col
+			<< ") #" << last->nodeId << ", expected action " << model.lastType << " at (" << model.lastRow << ", "
+			<< model.lastCol << ") #" << model.current;
+	}
+	return diff.str();
+}
+
+// Applies op to both sides and compares them. Returns "" when they still agree.
+static string applyOp(QueensGame& game, ReferenceGame& model, const FuzzOp& op) {
+	MoveStatus got = STATUS_OK, expected = STATUS_OK;
+	switch (op.type) {
+	case FUZZ_PLACE:
+		got = game.placeQueen(op.row, op.col);
+		expected = model.place(op.row, op.col);
+		break;
+	case FUZZ_REMOVE:
+		got = game.removeQueen(op.row, op.col);
+		expected = model.remove(op.row, op.col);
+		break;
+	case FUZZ_MARK:
+		got = game.markX(op.row, op.col);
+		expected = model.mark(op.row, op.col);
+		break;
+	case FUZZ_CLEAR:
+		got = game.clearCell(op.row, op.col);
+		expected = model.clear(op.row, op.col);
+		break;
+	case FUZZ_UNDO:
+		got = game.undo();
+		expected = model.undo();
+		break;
+	case FUZZ_REDO:
+		got = game.redo();
+		expected = model.redo();
+		break;
+	case FUZZ_JUMP:
+		got = game.jumpToVariation(op.row);
+		expected = model.jump(op.row);
+		break;
+	case FUZZ_RELOAD:
+		if (!game.loadSession(game.saveSession())) return "saved session did not load";
+		break;
+	}
+	if (got != expected) {
+		ostringstream diff;
+		diff << "returned status " << got << ", expected " << expected;
+		return diff.str();
+	}
+	return compareState(game, model);
+}
+
+// Replays ops on a fresh game. Returns the index of the first op after which the two sides
+// differ, or -1 if they agree throughout.
+static int replayOps(QueensGame& game, ReferenceGame& model, const int grid[BOARD_SIZE][BOARD_SIZE], const vector<FuzzOp>& ops, string& failure) {
+	game.setPuzzle(grid);
+	model.reset(grid);
+	failure = compareState(game, model);
+	if (!failure.empty()) return 0;
+	for (size_t i = 0; i < ops.size(); i++) {
+		failure = applyOp(game, model, ops[i]);
+		if (!failure.empty()) return (int)i;
+	}
+	return -1;
+}
+
+// Delta debugging: drops ever smaller chunks of the sequence while it keeps failing, then cuts
+// everything after the first difference. Any failure counts, not only the original one.
+static void shrinkOps(QueensGame& game, ReferenceGame& model, const int grid[BOARD_SIZE][BOARD_SIZE], vector<FuzzOp>& ops, string& failure) {
+	int failed = replayOps(game, model, grid, ops, failure);
+	ops.resize(failed + 1);
+	for (size_t chunk = ops.size() / 2; chunk >= 1; chunk /= 2) {
+		bool progress = true;
+		while (progress) {
+			progress = false;
+			for (size_t start = 0; start < ops.size() && ops.size() > 1;) {
+				vector<FuzzOp> candidate(ops.begin(), ops.begin() + start);
+				candidate.insert(candidate.end(), ops.begin() + min(ops.size(), start + chunk), ops.end());
+				string reason;
+				failed = replayOps(game, model, grid, candidate, reason);
+				if (failed < 0) {
+					start += chunk;
+					continue;
+				}
+				candidate.resize(failed + 1);
+				ops = candidate;
+				failure = reason;
+				progress = true;
+			}
+		}
+	}
+	replayOps(game, model, grid, ops, failure);
+}
+
+static bool parseFuzzNumber(const char* text, unsigned long long& value) {
+	char* end;
+	value = strtoull(text, &end, 10);
+	return *text != '\0' && *end == '\0';
+}
+
+int runFuzz(int argc, char** argv) {
+	unsigned long long seed = (unsigned long long)time(NULL), operations = 1000000, steps = 200;
+	if (argc > 3 || (argc > 0 && !parseFuzzNumber(argv[0], seed)) || (argc > 1 && !parseFuzzNumber(argv[1], operations))
+		|| (argc > 2 && (!parseFuzzNumber(argv[2], steps) || steps == 0))) {
+		cout << "Usage: Queens fuzz [seed] [operations] [steps per game]\n";
+		return 2;
+	}
+
+	QueensGame game(NULL, false);
+	ReferenceGame model;
+	PuzzleGenerator generator;
+	vector<FuzzOp> ops;
+	int grid[BOARD_SIZE][BOARD_SIZE];
+	unsigned long long rng = seed, done = 0, games = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	while (done < operations) {
+		// Alternate shipped maps, which have hundreds of solutions, with generated ones, which
+		// mostly have exactly one.
+		if (games % 2 == 0) {
+			int map = (int)fuzzNext(rng, BASE_MAP_COUNT);
+			for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+				grid[cell / BOARD_SIZE][cell % BOARD_SIZE] = BASE_MAPS[map][cell / BOARD_SIZE][cell % BOARD_SIZE];
+			}
+		}
+		else {
+			generator.generate(ZobristKeys::next(rng), grid, 1);
+		}
+		games++;
+
+		string failure;
+		ops.clear();
+		game.setPuzzle(grid);
+		model.reset(grid);
+		for (unsigned long long s = 0; s < steps && done < operations && failure.empty(); s++, done++) {
+			ops.push_back(randomOp(model, rng));
+			failure = applyOp(game, model, ops.back());
+		}
+		if (failure.empty()) continue;
+
+		cout << "Difference after " << done << " operations (game " << games << ", seed " << seed << "): " << failure << "\n";
+		shrinkOps(game, model, grid, ops, failure);
+		cout << "Shrunk to " << ops.size() << " operations: " << failure << "\nRegions:\n";
+		for (int i = 0; i < BOARD_SIZE; i++) {
+			cout << "  ";
+			for (int j = 0; j < BOARD_SIZE; j++) cout << grid[i][j];
+			cout << "\n";
+		}
+		cout << "Operations:";
+		for (size_t i = 0; i < ops.size(); i++) cout << " " << describeOp(ops[i]);
+		cout << "\n";
+		return 1;
+	}
+
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+	cout << done << " operations over " << games << " games in " << seconds << " s ("
+		<< (long long)(done / max(seconds, 1e-9)) << " ops/s), no differences (seed " << seed << ")\n";
+	return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef QUEENS_FUZZ_H
+#define QUEENS_FUZZ_H
+
+/*
+ * Differential fuzzer: plays the same random operations on QueensGame and on a slow reference
+ * model, compares their full state after every step, and shrinks any difference to a short
+ * reproducer. Run as "Queens fuzz [seed] [operations] [steps per game]".
+ */
+int runFuzz(int argc, char** argv);
+
+#endif
@@ -0,0 +1,241 @@
+#ifndef QUEENS_TABLES_H
+#define QUEENS_TABLES_H
+
+// Region maps every shipped puzzle is drawn from. generateColorRegions() picks one,
+// relabels its colors and applies one of the 8 board symmetries.
+constexpr int BASE_MAP_COUNT = 5;
+
+constexpr int BASE_MAPS[BASE_MAP_COUNT][8][8] = {
+	{
+		{0, 0, 0, 0, 1, 1, 1, 1},
+		{0, 2, 2, 0, 1, 1, 1, 1},
+		{2, 2, 2, 0, 3, 3, 1, 1},
+		{2, 2, 0, 0, 3, 3, 3, 4},
+		{2, 0, 0, 3, 3, 3, 4, 4},
+		{5, 5, 0, 3, 6, 6, 4, 4},
+		{5, 5, 5, 6, 6, 6, 4, 4},
+		{5, 5, 5, 6, 6, 7, 7, 7}
+	},
+	{
+		{0, 0, 0, 1, 1, 1, 1, 2},
+		{0, 0, 1, 1, 1, 2, 2, 2},
+		{0, 3, 3, 1, 2, 2, 2, 2},
+		{3, 3, 3, 3, 4, 4, 2, 5},
+		{3, 3, 4, 4, 4, 4, 5, 5},
+		{6, 6, 4, 4, 5, 5, 5, 5},
+		{6, 6, 6, 7, 7, 5, 5, 5},
+		{6, 6, 6, 7, 7, 7, 7, 7}
+	},
+	{
+		{0, 0, 0, 0, 1, 1, 1, 1},
+		{0, 0, 2, 2, 2, 1, 1, 1},
+		{0, 2, 2, 2, 3, 3, 1, 1},
+		{0, 2, 2, 3, 3, 3, 3, 4},
+		{5, 5, 2, 3, 3, 4, 4, 4},
+		{5, 5, 5, 5, 6, 6, 4, 4},
+		{5, 5, 7, 6, 6, 6, 4, 4},
+		{7, 7, 7, 7, 6, 6, 6, 4}
+	},
+	{
+		{0, 0, 1, 1, 1, 2, 2, 2},
+		{0, 0, 0, 1, 1, 1, 2, 2},
+		{0, 0, 3, 3, 1, 2, 2, 2},
+		{4, 4, 3, 3, 3, 3, 5, 5},
+		{4, 4, 4, 3, 3, 5, 5, 5},
+		{4, 4, 4, 6, 6, 6, 5, 5},
+		{7, 4, 6, 6, 6, 6, 5, 5},
+		{7, 7, 7, 7, 6, 6, 5, 5}
+	},
+	{
+		{0, 0, 0, 0, 0, 1, 1, 1},
+		{0, 2, 2, 3, 3, 3, 1, 1},
+		{2, 2, 2, 3, 3, 3, 1, 1},
+		{2, 2, 3, 3, 4, 4, 4, 1},
+		{2, 5, 5, 4, 4, 4, 4, 1},
+		{5, 5, 5, 5, 4, 6, 6, 6},
+		{5, 5, 7, 7, 6, 6, 6, 6},
+		{7, 7, 7, 7, 7, 7, 6, 6}
+	}
+};
+
+// Every solution of every base map, in the map's own orientation. Each entry packs the
+// queen's column for rows 0-7 in 3 bits per row, row 0 lowest; entries are sorted per map.
+// Generated with PuzzleSolver::listSolutions(); regenerate if BASE_MAPS changes.
+constexpr int BASE_SOLUTION_OFFSETS[BASE_MAP_COUNT + 1] = { 0, 67, 453, 865, 1288, 1714 };
+
+constexpr unsigned int BASE_SOLUTIONS[1714] = {
+	0xAC2F0E, 0xAC4E72, 0xAC4EB1, 0xAC633A, 0xAC650F, 0xAC687A, 0xAC68B9, 0xAC7332, 0xAC750E, 0xAC7872,
+	0xAC78B1, 0xACCE32, 0xACCE86, 0xACCEB0, 0xACE13A, 0xACE83A, 0xACE887, 0xACE8B8, 0xACE9D0, 0xACF132,
+	0xACF832, 0xACF886, 0xACF8B0, 0xACF990, 0xC2BE62, 0xC2BEA1, 0xC6BE22, 0xC6BE84, 0xC6BEA0, 0xCABE21,
+	0xCABE60, 0xCC2F0D, 0xCC2F4C, 0xCC4E6A, 0xCC4EA9, 0xCC5E62, 0xCC5EA1, 0xCC750D, 0xCC754C, 0xCC786A,
+	0xCC78A9, 0xCC7A62, 0xCC7AA1, 0xCCCE2A, 0xCCCE85, 0xCCCEA8, 0xCCDE22, 0xCCDE84, 0xCCDEA0, 0xCCF82A,
+	0xCCF885, 0xCCF8A8, 0xCCFA22, 0xCCFA84, 0xCCFAA0, 0xD03E6A, 0xD03EA9, 0xD0BE2A, 0xD0BE85, 0xD0BEA8,
+	0xEC650D, 0xEC654C, 0xEC686A, 0xEC68A9, 0xECE82A, 0xECE885, 0xECE8A8, 0x0F1BE2, 0x0F45CD, 0x0FC54E,
+	0x0FC58D, 0x0FD3A2, 0x0FD50E, 0x0FD58C, 0x0FD5A1, 0x1167CD, 0x11774E, 0x11778D, 0x131AFA, 0x139AF2,
+	0x13D2F2, 0x13D58B, 0x13D599, 0x2F0BE2, 0x2F443D, 0x2F45C5, 0x2FC546, 0x2FC585, 0x2FCC85, 0x2FD1A2,
+	0x2FD434, 0x2FD506, 0x2FD584, 0x2FD5A0, 0x31663D, 0x3167C5, 0x317746, 0x317785, 0x330AFA, 0x338AF2,
+	0x33BC85, 0x33D0F2, 0x33D433, 0x33D583, 0x33D598, 0x33D790, 0x530ACF, 0x530AF9, 0x530BCB, 0x530BD9,
+	0x531A1F, 0x531A3B, 0x531AC7, 0x531AF8, 0x531BC3, 0x531BD8, 0x5331CD, 0x5333C5, 0x538AF1, 0x539A33,
+	0x539AF0, 0x53B14E, 0x53B18D, 0x53B346, 0x53B385, 0x53D0F1, 0x53D18B, 0x53D199, 0x53D2F0, 0x53D383,
+	0x53D398, 0x631BE2, 0x6345CD, 0x63C54E, 0x63C58D, 0x63D3A2, 0x63D50E, 0x63D58C, 0x63D5A1, 0x670BE2,
+	0x67443D, 0x6745C5, 0x67C546, 0x67C585, 0x67CC85, 0x67D1A2, 0x67D434, 0x67D506, 0x67D584, 0x67D5A0,
+	0x7445CE, 0x74C5C6, 0x7845CD, 0x7853E2, 0x7855CC, 0x7855E1, 0x78C43D, 0x78C5C5, 0x78D1E2, 0x78D427,
+	0x78D43C, 0x78D5C4, 0x78D5E0, 0x7C454E, 0x7C458D, 0x7C53A2, 0x7C550E, 0x7C558C, 0x7C55A1, 0x7CC546,
+	0x7CC585, 0x7CCC85, 0x7CD1A2, 0x7CD434, 0x7CD506, 0x7CD584, 0x7CD5A0, 0x8167CD, 0x81774E, 0x81778D,
+	0x81E5CD, 0x81F54E, 0x81F58D, 0x831AFA, 0x839AF2, 0x83D2F2, 0x83D58B, 0x83D599, 0x85E43D, 0x85E5C5,
+	0x85F546, 0x85F585, 0x870AFA, 0x878AF2, 0x87BC85, 0x87D0F2, 0x87D433, 0x87D583, 0x87D598, 0x87D790,
+	0x8AB1CE, 0x8AB3C6, 0x8B0ACF, 0x8B0AF9, 0x8B0BCB, 0x8B0BD9, 0x8B1A1F, 0x8B1A3B, 0x8B1AC7, 0x8B1AF8,
+	0x8B1BC3, 0x8B1BD8, 0x8B31CD, 0x8B33C5, 0x8B8AF1, 0x8B9A33, 0x8B9AF0, 0x8BB14E, 0x8BB18D, 0x8BB346,
+	0x8BB385, 0x8BD0F1, 0x8BD18B, 0x8BD199, 0x8BD2F0, 0x8BD383, 0x8BD398, 0x9852FA, 0x9855CB, 0x9855D9,
+	0x98D0FA, 0x98D41F, 0x98D43B, 0x98D5C3, 0x98D5D8, 0x98D617, 0x98D7D0, 0x9C52F2, 0x9C558B, 0x9C5599,
+	0x9CBC85, 0x9CD0F2, 0x9CD433, 0x9CD583, 0x9CD598, 0x9CD790, 0xA167CC, 0xA167E1, 0xA1778C, 0xA177A1,
+	0xA1E3E2, 0xA1E5CC, 0xA1E5E1, 0xA1F3A2, 0xA1F50E, 0xA1F58C, 0xA1F5A1, 0xA333E2, 0xA342FA, 0xA345CB,
+	0xA345D9, 0xA3B3A2, 0xA3BC62, 0xA3BCA1, 0xA3C2F2, 0xA3C58B, 0xA3C599, 0xA5E1E2, 0xA5E427, 0xA5E43C,
+	0xA5E5C4, 0xA5E5E0, 0xA5F1A2, 0xA5F434, 0xA5F506, 0xA5F584, 0xA5F5A0, 0xA731E2, 0xA740FA, 0xA7441F,
+	0xA7443B, 0xA745C3, 0xA745D8, 0xA7B1A2, 0xA7BC84, 0xA7BCA0, 0xA7C0F2, 0xA7C433, 0xA7C583, 0xA7C598,
+	0xA7CC83, 0xAB09CB, 0xAB09D9, 0xAB181F, 0xAB183B, 0xAB19C3, 0xAB19D8, 0xAB31CC, 0xAB31E1, 0xAB33C4,
+	0xAB33E0, 0xAB40CF, 0xAB40F9, 0xAB41CB, 0xAB41D9, 0xAB42C7, 0xAB42F8, 0xAB43C3, 0xAB43D8, 0xAB898B,
+	0xAB8999, 0xAB9833, 0xAB9983, 0xAB9998, 0xABB10E, 0xABB18C, 0xABB1A1, 0xABB306, 0xABB384, 0xABB3A0,
+	0xABBC60, 0xABC0F1, 0xABC18B, 0xABC199, 0xABC2F0, 0xABC383, 0xABC398, 0xABCC58, 0xBC33A2, 0xBC3C62,
+	0xBC3CA1, 0xBC42F2, 0xBC458B, 0xBC4599, 0xBCB1A2, 0xBCBC84, 0xBCBCA0, 0xBCC0F2, 0xBCC433, 0xBCC583,
+	0xBCC598, 0xBCCC83, 0xC1774C, 0xC1F50D, 0xC1F54C, 0xC21AFA, 0xC2B3E2, 0xC3C2EA, 0xC3C54B, 0xC3C559,
+	0xC3D50B, 0xC5F505, 0xC5F544, 0xC60AFA, 0xC6B1E2, 0xC7C0EA, 0xC7C42B, 0xC7C543, 0xC7C558, 0xC7D503,
+	0xCA0ACF, 0xCA0AF9, 0xCA0BCB, 0xCA0BD9, 0xCA1A1F, 0xCA1A3B, 0xCA1AC7, 0xCA1AF8, 0xCA1BC3, 0xCA1BD8,
+	0xCA89CB, 0xCA89D9, 0xCA981F, 0xCA983B, 0xCA99C3, 0xCA99D8, 0xCAB1CC, 0xCAB1E1, 0xCAB3C4, 0xCAB3E0,
+	0xCB982B, 0xCBB10D, 0xCBB14C, 0xCBB305, 0xCBB344, 0xCBC0E9, 0xCBC14B, 0xCBC159, 0xCBC2E8, 0xCBC343,
+	0xCBC358, 0xCBD10B, 0xCBD303, 0xE1674C, 0xE1E50D, 0xE1E54C, 0xE21AF2, 0xE2B3A2, 0xE2BC62, 0xE2BCA1,
+	0xE342EA, 0xE3454B, 0xE34559, 0xE5E505, 0xE5E544, 0xE60AF2, 0xE6B1A2, 0xE6BC84, 0xE6BCA0, 0xE740EA,
+	0xE7442B, 0xE74543, 0xE74558, 0xEA0AF1, 0xEA1A33, 0xEA1AF0, 0xEA898B, 0xEA8999, 0xEA9833, 0xEA9983,
+	0xEA9998, 0xEAB10E, 0xEAB18C, 0xEAB1A1, 0xEAB306, 0xEAB384, 0xEAB3A0, 0xEABC60, 0xEB182B, 0xEB310D,
+	0xEB314C, 0xEB3305, 0xEB3344, 0xEB40E9, 0xEB414B, 0xEB4159, 0xEB42E8, 0xEB4343, 0xEB4358, 0xF433A2,
+	0xF43C62, 0xF43CA1, 0xF442F2, 0xF4458B, 0xF44599, 0xF4B1A2, 0xF4BC84, 0xF4BCA0, 0xF4C0F2, 0xF4C433,
+	0xF4C583, 0xF4C598, 0xF4CC83, 0x0F1BE2, 0x10E57B, 0x10FAB3, 0x10FAF2, 0x11637B, 0x117A73, 0x117ACE,
+	0x117AF1, 0x131ABB, 0x131AFA, 0x139AB3, 0x139AF2, 0x139CAB, 0x139CEA, 0x14CEB3, 0x14CEF2, 0x14E53B,
+	0x14E7E2, 0x14E8BB, 0x14F533, 0x14F7A2, 0x14F8B3, 0x154E73, 0x154ECE, 0x154EF1, 0x15633B, 0x1567E1,
+	0x15687B, 0x1569D9, 0x157333, 0x1577A1, 0x157873, 0x157999, 0x15E33A, 0x15E50F, 0x15E539, 0x15E87A,
+	0x15E8B9, 0x15F332, 0x15F50E, 0x15F531, 0x15F872, 0x15F8B1, 0x1797A2, 0x1798B3, 0x1A1ABB, 0x1A1AFA,
+	0x1E1AB3, 0x1E1AF2, 0x1E1CAB, 0x1E1CEA, 0x1E97A2, 0x1E98B3, 0x2F0BE2, 0x30657B, 0x307AB3, 0x307AF2,
+	0x31615F, 0x31715E, 0x317A1E, 0x317AC6, 0x317AF0, 0x33057B, 0x330ABB, 0x330AFA, 0x338AB3, 0x338AF2,
+	0x338CAB, 0x338CEA, 0x342F33, 0x344EB3, 0x344EF2, 0x34653B, 0x3467E2, 0x3468BB, 0x347533, 0x3477A2,
+	0x3478B3, 0x354E1E, 0x354EC6, 0x354EF0, 0x356627, 0x3567E0, 0x35681F, 0x3569D8, 0x357626, 0x3577A0,
+	0x35781E, 0x357998, 0x35E117, 0x35E507, 0x35E538, 0x35E817, 0x35E887, 0x35E8B8, 0x35E9D0, 0x35F116,
+	0x35F506, 0x35F530, 0x35F816, 0x35F886, 0x35F8B0, 0x35F990, 0x378533, 0x3787A2, 0x3788B3, 0x3A057B,
+	0x3A0ABB, 0x3A0AFA, 0x3E0AB3, 0x3E0AF2, 0x3E0CAB, 0x3E0CEA, 0x3E8533, 0x3E87A2, 0x3E88B3, 0x42637B,
+	0x427A73, 0x427ACE, 0x427AF1, 0x42F333, 0x42F7A1, 0x42F873, 0x42F999, 0x50637B, 0x507A73, 0x507ACE,
+	0x507AF1, 0x50E15F, 0x50F15E, 0x50FA1E, 0x50FAC6, 0x50FAF0, 0x530A7B, 0x530ACF, 0x530AF9, 0x530BD9,
+	0x531A1F, 0x531AC7, 0x531AF8, 0x531BD8, 0x538A73, 0x538ACE, 0x538AF1, 0x538C6B, 0x538CCD, 0x538CE9,
+	0x539A1E, 0x539AC6, 0x539AF0, 0x539C1D, 0x539CC5, 0x539CE8, 0x544E73, 0x544ECE, 0x544EF1, 0x54633B,
+	0x5467E1, 0x54687B, 0x5469D9, 0x547333, 0x5477A1, 0x547873, 0x547999, 0x54BE26, 0x54CE1E, 0x54CEC6,
+	0x54CEF0, 0x54E627, 0x54E7E0, 0x54E81F, 0x54E9D8, 0x54F626, 0x54F7A0, 0x54F81E, 0x54F998, 0x55E307,
+	0x55E338, 0x55E878, 0x55F306, 0x55F330, 0x55F870, 0x5787A1, 0x578873, 0x578999, 0x578CCC, 0x579626,
+	0x5797A0, 0x57981E, 0x579998, 0x579CC4, 0x5A0A7B, 0x5A0ACF, 0x5A0AF9, 0x5A0BD9, 0x5A1A1F, 0x5A1AC7,
+	0x5A1AF8, 0x5A1BD8, 0x5E0A73, 0x5E0ACE, 0x5E0AF1, 0x5E0C6B, 0x5E0CCD, 0x5E0CE9, 0x5E1A1E, 0x5E1AC6,
+	0x5E1AF0, 0x5E1C1D, 0x5E1CC5, 0x5E1CE8, 0x5E87A1, 0x5E8873, 0x5E8999, 0x5E8CCC, 0x5E9626, 0x5E97A0,
+	0x5E981E, 0x5E9998, 0x5E9CC4, 0x622F4E, 0x62637A, 0x62654F, 0x626579, 0x62754E, 0x627A72, 0x627AB1,
+	0x62AF0E, 0x62AF31, 0x62F332, 0x62F50E, 0x62F531, 0x62F872, 0x62F8B1, 0x662F46, 0x666157, 0x666547,
+	0x666578, 0x667156, 0x667546, 0x667A16, 0x667A86, 0x667AB0, 0x66AF06, 0x66AF30, 0x66F116, 0x66F506,
+	0x66F530, 0x66F816, 0x66F886, 0x66F8B0, 0x66F990, 0x742F0E, 0x742F31, 0x744E72, 0x744EB1, 0x74633A,
+	0x74650F, 0x746539, 0x74687A, 0x7468B9, 0x747332, 0x74750E, 0x747531, 0x747872, 0x7478B1, 0x74CE16,
+	0x74CE86, 0x74CEB0, 0x74E117, 0x74E507, 0x74E538, 0x74E817, 0x74E887, 0x74E8B8, 0x74E9D0, 0x74F116,
+	0x74F506, 0x74F530, 0x74F816, 0x74F886, 0x74F8B0, 0x74F990, 0x754E70, 0x756307, 0x756338, 0x756878,
+	0x757306, 0x757330, 0x757870, 0x77850E, 0x778531, 0x778872, 0x7788B1, 0x779816, 0x779886, 0x7798B0,
+	0x779990, 0x779C14, 0x779C84, 0x7A054F, 0x7A0579, 0x7A0A7A, 0x7A0AB9, 0x7A1A17, 0x7A1A87, 0x7A1AB8,
+	0x7A1BD0, 0x7E054E, 0x7E0A72, 0x7E0AB1, 0x7E0C6A, 0x7E0CA9, 0x7E1A16, 0x7E1A86, 0x7E1AB0, 0x7E1C15,
+	0x7E1C85, 0x7E1CA8, 0x7E850E, 0x7E8531, 0x7E8872, 0x7E88B1, 0x7E9816, 0x7E9886, 0x7E98B0, 0x7E9990,
+	0x7E9C14, 0x7E9C84, 0x88637B, 0x887A73, 0x887ACE, 0x887AF1, 0x8B0A7B, 0x8B0ACF, 0x8B0AF9, 0x8B0BD9,
+	0x8B1A1F, 0x8B1AC7, 0x8B1AF8, 0x8B1BD8, 0x8B8A73, 0x8B8ACE, 0x8B8AF1, 0x8B8C6B, 0x8B8CCD, 0x8B8CE9,
+	0x8B9A1E, 0x8B9AC6, 0x8B9AF0, 0x8B9C1D, 0x8B9CC5, 0x8B9CE8, 0xA84E73, 0xA84ECE, 0xA84EF1, 0xA8633B,
+	0xA867E1, 0xA8687B, 0xA869D9, 0xA87333, 0xA877A1, 0xA87873, 0xA87999, 0xAB07E1, 0xAB087B, 0xAB09D9,
+	0xAB1627, 0xAB17E0, 0xAB181F, 0xAB19D8, 0xAB87A1, 0xAB8873, 0xAB8999, 0xAB8CCC, 0xAB9626, 0xAB97A0,
+	0xAB981E, 0xAB9998, 0xAB9CC4, 0xC84E6B, 0xC84ECD, 0xC84EE9, 0xC8533B, 0xC857E1, 0xC8786B, 0xC87ACC,
+	0xCB886B, 0xCB8ACC, 0xCB981D, 0xCB9AC4, 0xEA0A73, 0xEA0ACE, 0xEA0AF1, 0xEA0C6B, 0xEA0CCD, 0xEA0CE9,
+	0xEA1A1E, 0xEA1AC6, 0xEA1AF0, 0xEA1C1D, 0xEA1CC5, 0xEA1CE8, 0xEA87A1, 0xEA8873, 0xEA8999, 0xEA8CCC,
+	0xEA9626, 0xEA97A0, 0xEA981E, 0xEA9998, 0xEA9CC4, 0x0F1BD4, 0x0F286F, 0x0F29E9, 0x0F2A67, 0x0F2A7C,
+	0x0F2BCC, 0x0F2BE1, 0x0FAA66, 0x0FAA74, 0x11666F, 0x1167E9, 0x117A5E, 0x117A73, 0x132A5F, 0x132A7B,
+	0x132BCB, 0x132BD9, 0x13AA5E, 0x13AA73, 0x14BD17, 0x14BF16, 0x14E7D4, 0x14F794, 0x154C5F, 0x154C7B,
+	0x154E5E, 0x154E73, 0x156667, 0x15667C, 0x1567CC, 0x1567E1, 0x15685F, 0x15687B, 0x1569CB, 0x1569D9,
+	0x157666, 0x157674, 0x15778C, 0x1577A1, 0x15785E, 0x157873, 0x15798B, 0x157999, 0x179794, 0x17A85E,
+	0x17A873, 0x17A98B, 0x17A999, 0x17B316, 0x17B394, 0x199BD4, 0x1A2A5F, 0x1A2A7B, 0x1A2BCB, 0x1A2BD9,
+	0x1E2A5E, 0x1E2A73, 0x1E9794, 0x1EA85E, 0x1EA873, 0x1EA98B, 0x1EA999, 0x1EB316, 0x1EB394, 0x2F0BD4,
+	0x2F282F, 0x2F29E8, 0x2F2A27, 0x2F2A3C, 0x2F2BC4, 0x2F2BE0, 0x2FAA26, 0x2FAA34, 0x31662F, 0x3167E8,
+	0x317A1E, 0x317A33, 0x332A1F, 0x332A3B, 0x332BC3, 0x332BD8, 0x33AA1E, 0x33AA33, 0x343D17, 0x343F16,
+	0x3467D4, 0x347794, 0x354C1F, 0x354C3B, 0x354E1E, 0x354E33, 0x356627, 0x35663C, 0x3567C4, 0x3567E0,
+	0x35681F, 0x35683B, 0x3569C3, 0x3569D8, 0x357626, 0x357634, 0x357784, 0x3577A0, 0x35781E, 0x357833,
+	0x357983, 0x357998, 0x378794, 0x37A81E, 0x37A833, 0x37A983, 0x37A998, 0x37B116, 0x37B194, 0x398BD4,
+	0x3A2A1F, 0x3A2A3B, 0x3A2BC3, 0x3A2BD8, 0x3E2A1E, 0x3E2A33, 0x3E8794, 0x3EA81E, 0x3EA833, 0x3EA983,
+	0x3EA998, 0x3EB116, 0x3EB194, 0x503C6F, 0x50666F, 0x5067E9, 0x507A5E, 0x507A73, 0x50BC2F, 0x50E62F,
+	0x50E7E8, 0x50FA1E, 0x50FA33, 0x53066F, 0x5307E9, 0x530A5F, 0x530A7B, 0x530BCB, 0x530BD9, 0x53162F,
+	0x5317E8, 0x531A1F, 0x531A3B, 0x531BC3, 0x531BD8, 0x5331E9, 0x5333E8, 0x538A5E, 0x538A73, 0x539A1E,
+	0x539A33, 0x543C67, 0x543C7C, 0x543D0F, 0x543D39, 0x543E66, 0x543E74, 0x543F0E, 0x543F31, 0x544C5F,
+	0x544C7B, 0x544E5E, 0x544E73, 0x546667, 0x54667C, 0x5467CC, 0x5467E1, 0x54685F, 0x54687B, 0x5469CB,
+	0x5469D9, 0x547666, 0x547674, 0x54778C, 0x5477A1, 0x54785E, 0x547873, 0x54798B, 0x547999, 0x54BC27,
+	0x54BC3C, 0x54BD07, 0x54BD38, 0x54BE26, 0x54BE34, 0x54BF06, 0x54BF30, 0x54CC1F, 0x54CC3B, 0x54CE1E,
+	0x54CE33, 0x54E627, 0x54E63C, 0x54E7C4, 0x54E7E0, 0x54E81F, 0x54E83B, 0x54E9C3, 0x54E9D8, 0x54F626,
+	0x54F634, 0x54F784, 0x54F7A0, 0x54F81E, 0x54F833, 0x54F983, 0x54F998, 0x578666, 0x578674, 0x57878C,
+	0x5787A1, 0x57885E, 0x578873, 0x57898B, 0x578999, 0x579626, 0x579634, 0x579784, 0x5797A0, 0x57981E,
+	0x579833, 0x579983, 0x579998, 0x57B10E, 0x57B131, 0x57B18C, 0x57B1A1, 0x57B306, 0x57B330, 0x57B384,
+	0x57B3A0, 0x57C18B, 0x57C199, 0x57C383, 0x57C398, 0x59886F, 0x5989E9, 0x598A67, 0x598A7C, 0x598BCC,
+	0x598BE1, 0x59982F, 0x5999E8, 0x599A27, 0x599A3C, 0x599BC4, 0x599BE0, 0x5A066F, 0x5A07E9, 0x5A0A5F,
+	0x5A0A7B, 0x5A0BCB, 0x5A0BD9, 0x5A162F, 0x5A17E8, 0x5A1A1F, 0x5A1A3B, 0x5A1BC3, 0x5A1BD8, 0x5D8A66,
+	0x5D8A74, 0x5D9A26, 0x5D9A34, 0x5E0A5E, 0x5E0A73, 0x5E1A1E, 0x5E1A33, 0x5E8666, 0x5E8674, 0x5E878C,
+	0x5E87A1, 0x5E885E, 0x5E8873, 0x5E898B, 0x5E8999, 0x5E9626, 0x5E9634, 0x5E9784, 0x5E97A0, 0x5E981E,
+	0x5E9833, 0x5E9983, 0x5E9998, 0x5EB10E, 0x5EB131, 0x5EB18C, 0x5EB1A1, 0x5EB306, 0x5EB330, 0x5EB384,
+	0x5EB3A0, 0x66642F, 0x6665E8, 0x667A32, 0x66F426, 0x66F434, 0x66F506, 0x66F530, 0x66F584, 0x66F5A0,
+	0x66F832, 0x66F982, 0x744C7A, 0x744E72, 0x74650F, 0x746539, 0x7465CC, 0x7465E1, 0x74687A, 0x74750E,
+	0x747531, 0x74758C, 0x7475A1, 0x747872, 0x74CC3A, 0x74CE32, 0x74E427, 0x74E43C, 0x74E507, 0x74E538,
+	0x74E5C4, 0x74E5E0, 0x74E83A, 0x74E9C2, 0x74F426, 0x74F434, 0x74F506, 0x74F530, 0x74F584, 0x74F5A0,
+	0x74F832, 0x74F982, 0x77850E, 0x778531, 0x77858C, 0x7785A1, 0x778872, 0x779832, 0x779982, 0x77C382,
+	0x7A05E9, 0x7A0A7A, 0x7A1A3A, 0x7A1BC2, 0x7E0A72, 0x7E1A32, 0x7E850E, 0x7E8531, 0x7E858C, 0x7E85A1,
+	0x7E8872, 0x7E9832, 0x7E9982, 0x81666F, 0x8167E9, 0x817A5E, 0x817A73, 0x832A5F, 0x832A7B, 0x832BCB,
+	0x832BD9, 0x83AA5E, 0x83AA73, 0xA14C5F, 0xA14C7B, 0xA14E5E, 0xA14E73, 0xA16667, 0xA1667C, 0xA167CC,
+	0xA167E1, 0xA1685F, 0xA1687B, 0xA169CB, 0xA169D9, 0xA17666, 0xA17674, 0xA1778C, 0xA177A1, 0xA1785E,
+	0xA17873, 0xA1798B, 0xA17999, 0xA317D4, 0xA3285F, 0xA3287B, 0xA329CB, 0xA329D9, 0xA33317, 0xA333D4,
+	0xA39794, 0xA3A85E, 0xA3A873, 0xA3A98B, 0xA3A999, 0xA3B316, 0xA3B394, 0xC19BD4, 0xC22A5F, 0xC22A7B,
+	0xC22BCB, 0xC22BD9, 0xC297D4, 0xC2A85F, 0xC2A87B, 0xC2A9CB, 0xC2A9D9, 0xC2B317, 0xC2B3D4, 0xE22A5E,
+	0xE22A73, 0xE29794, 0xE2A85E, 0xE2A873, 0xE2A98B, 0xE2A999, 0xE2B316, 0xE2B394, 0x11637B, 0x1163EB,
+	0x14E7D4, 0x1562FC, 0x15633B, 0x15667C, 0x1567CC, 0x15E33A, 0x15E3E2, 0x15E5CC, 0x18BF54, 0x18CEAB,
+	0x18D7D4, 0x18F8AB, 0x19437B, 0x1943EB, 0x194E6B, 0x194F4B, 0x1952FC, 0x19533B, 0x19567C, 0x1957CC,
+	0x195ECC, 0x195F0B, 0x19786B, 0x197ACC, 0x19D33A, 0x19D3E2, 0x19D5CC, 0x19DE62, 0x19DEA1, 0x19F86A,
+	0x19F8A9, 0x19FA62, 0x19FAA1, 0x1A1EAB, 0x1A2E6B, 0x1A2F4B, 0x1CD794, 0x1D52F4, 0x1D5333, 0x1D5674,
+	0x1D578C, 0x1DD332, 0x1DD3A2, 0x1DD58C, 0x31617B, 0x3161EB, 0x3467D4, 0x350CFC, 0x350D3B, 0x3560FC,
+	0x35613B, 0x35663C, 0x358D3A, 0x35E13A, 0x35E1E2, 0x35E43C, 0x383F54, 0x384EAB, 0x3857D4, 0x3878AB,
+	0x3909EB, 0x390AFC, 0x39417B, 0x3941EB, 0x394E2B, 0x3950FC, 0x39513B, 0x39563C, 0x39782B, 0x3989EA,
+	0x398BE2, 0x39D13A, 0x39D1E2, 0x39D43C, 0x39DE22, 0x39DEA0, 0x39DF10, 0x39F82A, 0x39F8A8, 0x39FA22,
+	0x39FAA0, 0x3A217B, 0x3A21EB, 0x3A2E2B, 0x3C5794, 0x3D0AF4, 0x3D50F4, 0x3D5133, 0x3D5634, 0x3DD132,
+	0x3DD1A2, 0x3DD434, 0x43337C, 0x433F4C, 0x43437B, 0x4343EB, 0x434E6B, 0x434F4B, 0x43D2F4, 0x43D333,
+	0x43D674, 0x43D78C, 0x50637B, 0x5063EB, 0x50E17B, 0x50E1EB, 0x5462FC, 0x54633B, 0x54667C, 0x5467CC,
+	0x54E0FC, 0x54E13B, 0x54E63C, 0x558D39, 0x55E139, 0x55E1E1, 0x55E307, 0x55E338, 0x55E3E0, 0x58337C,
+	0x583F4C, 0x58437B, 0x5843EB, 0x584E6B, 0x584F4B, 0x5852FC, 0x58533B, 0x58567C, 0x5857CC, 0x585ECC,
+	0x585F0B, 0x58786B, 0x587ACC, 0x58B17C, 0x58C17B, 0x58C1EB, 0x58CE2B, 0x58D0FC, 0x58D13B, 0x58D63C,
+	0x58F82B, 0x5989E9, 0x598BE1, 0x59D139, 0x59D1E1, 0x59D307, 0x59D338, 0x59D3E0, 0x59DE21, 0x59DE60,
+	0x59F829, 0x59F868, 0x59FA21, 0x59FA60, 0x5A1E2B, 0x5C52F4, 0x5C5333, 0x5C5674, 0x5C578C, 0x5CD0F4,
+	0x5CD133, 0x5CD634, 0x5DD131, 0x5DD1A1, 0x5DD306, 0x5DD330, 0x5DD3A0, 0x5DE305, 0x63437A, 0x6343EA,
+	0x634E6A, 0x634EA9, 0x63D332, 0x63D3A2, 0x63D58C, 0x668D3A, 0x6709EA, 0x670BE2, 0x67417A, 0x6741EA,
+	0x674E2A, 0x674EA8, 0x674F50, 0x67D132, 0x67D1A2, 0x67D434, 0x74633A, 0x7463E2, 0x7465CC, 0x74E13A,
+	0x74E1E2, 0x74E43C, 0x750D39, 0x756139, 0x7561E1, 0x756307, 0x756338, 0x7563E0, 0x78437A, 0x7843EA,
+	0x784E6A, 0x784EA9, 0x78533A, 0x7853E2, 0x7855CC, 0x785E62, 0x785EA1, 0x78786A, 0x7878A9, 0x787A62,
+	0x787AA1, 0x78C17A, 0x78C1EA, 0x78CE2A, 0x78CEA8, 0x78CF50, 0x78D13A, 0x78D1E2, 0x78D43C, 0x78DE22,
+	0x78DEA0, 0x78DF10, 0x78F82A, 0x78F8A8, 0x78FA22, 0x78FAA0, 0x7909E9, 0x790BE1, 0x794179, 0x7941E9,
+	0x794347, 0x794378, 0x7943E8, 0x794E29, 0x794E68, 0x795139, 0x7951E1, 0x795307, 0x795338, 0x7953E0,
+	0x795E21, 0x795E60, 0x797829, 0x797868, 0x797A21, 0x797A60, 0x7A1E2A, 0x7A1EA8, 0x7A1F50, 0x7A2179,
+	0x7A21E9, 0x7A2E29, 0x7A2E68, 0x7C5332, 0x7C53A2, 0x7C558C, 0x7CD132, 0x7CD1A2, 0x7CD434, 0x7D4346,
+	0x7D5131, 0x7D51A1, 0x7D5306, 0x7D5330, 0x7D53A0, 0x7D6305, 0x83337A, 0x8333EA, 0x833E6A, 0x833EA9,
+	0x83D2F2, 0x83D58B, 0x83D672, 0x868CFA, 0x870AFA, 0x87317A, 0x8731EA, 0x873E2A, 0x873EA8, 0x873F50,
+	0x878AF2, 0x87D0F2, 0x87D433, 0x87D632, 0x87D790, 0x98337A, 0x9833EA, 0x983E6A, 0x983EA9, 0x9852FA,
+	0x9855CB, 0x98567A, 0x98B17A, 0x98B1EA, 0x98BE2A, 0x98BEA8, 0x98BF50, 0x98D0FA, 0x98D43B, 0x98D63A,
+	0x98D7D0, 0x990AF9, 0x990BD9, 0x9950F9, 0x9951D9, 0x9952C7, 0x9952F8, 0x9953D8, 0x995639, 0x995678,
+	0x995E19, 0x995E58, 0x997A19, 0x997A58, 0x99D439, 0x9C52F2, 0x9C558B, 0x9C5672, 0x9CD0F2, 0x9CD433,
+	0x9CD632, 0x9CD790, 0x9D0AF1, 0x9D50F1, 0x9D5199, 0x9D52C6, 0x9D52F0, 0x9D5398, 0x9D5631, 0x9D5670,
+	0x9D62C5, 0x9DD431, 0xA3333A, 0xA333E2, 0xA33E62, 0xA33EA1, 0xA342FA, 0xA345CB, 0xA3B332, 0xA3B3A2,
+	0xA3C2F2, 0xA3C58B, 0xA7313A, 0xA731E2, 0xA73E22, 0xA73EA0, 0xA73F10, 0xA740FA, 0xA7443B, 0xA7B132,
+	0xA7B1A2, 0xA7C0F2, 0xA7C433, 0xBC3332, 0xBC33A2, 0xBC42F2, 0xBC458B, 0xBCB132, 0xBCB1A2, 0xBCC0F2,
+	0xBCC433, 0xBD0999, 0xBD40F1, 0xBD4199, 0xBD42C6, 0xBD42F0, 0xBD4398, 0xBE1632, 0xBE1790, 0xBE20F1,
+	0xBE2199, 0xC8337C, 0xC83F4C, 0xC8437B, 0xC843EB, 0xC84E6B, 0xC84F4B, 0xC852FC, 0xC8533B, 0xC8567C,
+	0xC857CC, 0xC85ECC, 0xC85F0B, 0xC8786B, 0xC87ACC, 0xCA1E2B, 0xCC437A, 0xCC43EA, 0xCC4E6A, 0xCC4EA9,
+	0xCC533A, 0xCC53E2, 0xCC55CC, 0xCC5E62, 0xCC5EA1, 0xCC786A, 0xCC78A9, 0xCC7A62, 0xCC7AA1, 0xCCC17A,
+	0xCCC1EA, 0xCCCE2A, 0xCCCEA8, 0xCCCF50, 0xCCD13A, 0xCCD1E2, 0xCCD43C, 0xCCDE22, 0xCCDEA0, 0xCCDF10,
+	0xCCF82A, 0xCCF8A8, 0xCCFA22, 0xCCFAA0, 0xE852F4, 0xE85333, 0xE85674, 0xE8578C, 0xEC5332, 0xEC53A2,
+	0xEC558C, 0xECD132, 0xECD1A2, 0xECD434
+};
+
+#endif
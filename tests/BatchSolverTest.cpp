@@ -0,0 +1,69 @@
+// Solves the shipped maps, generated maps and random region maps with BatchSolver, on the AVX2
+// lanes and on the scalar search, and checks both against PuzzleSolver::listSolutions(): the
+// same solutions in the same order, cut off at the limit.
+#include "QueensEngine.h"
+#include <iostream>
+using namespace std;
+
+int main() {
+	const int count = 2003;
+	vector<int> regionMaps;
+	PuzzleGenerator generator;
+	unsigned long long rng = 7;
+	int grid[BOARD_SIZE][BOARD_SIZE];
+	for (int p = 0; p < count; p++) {
+		if (p < BASE_MAP_COUNT) {
+			for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+				grid[cell / BOARD_SIZE][cell % BOARD_SIZE] = BASE_MAPS[p][cell / BOARD_SIZE][cell % BOARD_SIZE];
+			}
+		}
+		else if (p % 2 == 0) {
+			generator.generate(ZobristKeys::next(rng), grid, 64);
+		}
+		else {
+			for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+				grid[cell / BOARD_SIZE][cell % BOARD_SIZE] = (int)(ZobristKeys::next(rng) % BOARD_SIZE);
+			}
+		}
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			regionMaps.push_back(grid[cell / BOARD_SIZE][cell % BOARD_SIZE]);
+		}
+	}
+
+	PuzzleSolver solver;
+	vector<vector<unsigned int> > expected(count);
+	int allowed[BOARD_SIZE];
+	for (int p = 0; p < count; p++) {
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			grid[cell / BOARD_SIZE][cell % BOARD_SIZE] = regionMaps[p * BOARD_SIZE * BOARD_SIZE + cell];
+		}
+		for (int i = 0; i < BOARD_SIZE; i++) allowed[i] = (1 << BOARD_SIZE) - 1;
+		solver.setColorGrid(grid);
+		solver.listSolutions(allowed, expected[p]);
+	}
+
+	bool simd = avx2Enabled;
+	const int limits[3] = { 1, 2, 1000 };
+	int failures = 0;
+	for (int path = 0; path < 2; path++) {
+		avx2Enabled = simd && path == 0;
+		for (int l = 0; l < 3; l++) {
+			vector<unsigned int> solutions;
+			vector<int> offsets;
+			BatchSolver::solve(&regionMaps[0], count, limits[l], solutions, offsets);
+			for (int p = 0; p < count; p++) {
+				size_t want = min(expected[p].size(), (size_t)limits[l]);
+				bool same = offsets[p + 1] - offsets[p] == (int)want
+					&& equal(expected[p].begin(), expected[p].begin() + want, solutions.begin() + offsets[p]);
+				if (!same && failures++ < 10) {
+					cout << (path == 0 ? "AVX2" : "scalar") << " limit " << limits[l] << ", map " << p << ": "
+						<< offsets[p + 1] - offsets[p] << " solutions, expected " << want << "\n";
+				}
+			}
+		}
+	}
+	avx2Enabled = simd;
+
+	cout << count << " maps, AVX2 path " << (simd ? "checked" : "not available") << ", " << failures << " failures\n";
+	return failures == 0 ? 0 : 1;
+}
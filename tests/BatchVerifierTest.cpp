@@ -0,0 +1,80 @@
+// Checks BatchVerifier's AVX2 and scalar paths against each other on the shipped solutions and
+// on corrupted copies of them: moved queens, swapped columns and out-of-range coordinates.
+#include "QueensEngine.h"
+#include <iostream>
+using namespace std;
+
+int main() {
+	vector<int> regionMaps;
+	for (int m = 0; m < BASE_MAP_COUNT; m++) {
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			regionMaps.push_back(BASE_MAPS[m][cell / BOARD_SIZE][cell % BOARD_SIZE]);
+		}
+	}
+
+	unsigned long long rng = 1;
+	const int count = 20003;
+	vector<int> puzzleIds(count);
+	vector<unsigned char> rows[BOARD_SIZE], cols[BOARD_SIZE];
+	vector<bool> known(count);
+	for (int k = 0; k < BOARD_SIZE; k++) {
+		rows[k].resize(count + 8);
+		cols[k].resize(count + 8);
+	}
+	for (int s = 0; s < count; s++) {
+		int index = (int)(ZobristKeys::next(rng) % BASE_SOLUTION_OFFSETS[BASE_MAP_COUNT]);
+		int map = 0;
+		while (BASE_SOLUTION_OFFSETS[map + 1] <= index) map++;
+		puzzleIds[s] = map;
+		for (int k = 0; k < BOARD_SIZE; k++) {
+			rows[k][s] = (unsigned char)k;
+			cols[k][s] = (unsigned char)((BASE_SOLUTIONS[index] >> (3 * k)) & 7);
+		}
+		known[s] = s % 4 == 0;
+		if (known[s]) continue;
+
+		int k = (int)(ZobristKeys::next(rng) % BOARD_SIZE);
+		int other = (int)(ZobristKeys::next(rng) % BOARD_SIZE);
+		switch (s % 4) {
+		case 1:
+			cols[k][s] = (unsigned char)(ZobristKeys::next(rng) % BOARD_SIZE);
+			rows[k][s] = (unsigned char)(ZobristKeys::next(rng) % BOARD_SIZE);
+			break;
+		case 2:
+			swap(cols[k][s], cols[other][s]);
+			break;
+		default:
+			if (ZobristKeys::next(rng) & 1) rows[k][s] = (unsigned char)(ZobristKeys::next(rng) % 256);
+			else cols[k][s] = (unsigned char)(BOARD_SIZE + ZobristKeys::next(rng) % 8);
+			break;
+		}
+	}
+
+	SolutionBatch batch;
+	batch.count = count;
+	batch.puzzleIds = &puzzleIds[0];
+	batch.regionMaps = &regionMaps[0];
+	for (int k = 0; k < BOARD_SIZE; k++) {
+		batch.queenRows[k] = &rows[k][0];
+		batch.queenCols[k] = &cols[k][0];
+	}
+
+	bool simd = avx2Enabled;
+	vector<unsigned long long> fast((count + 63) / 64), scalar((count + 63) / 64);
+	BatchVerifier::verify(batch, &fast[0]);
+	avx2Enabled = false;
+	BatchVerifier::verify(batch, &scalar[0]);
+	avx2Enabled = simd;
+
+	int failures = 0, accepted = 0;
+	for (int s = 0; s < count; s++) {
+		bool a = (fast[s / 64] >> (s % 64)) & 1;
+		bool b = (scalar[s / 64] >> (s % 64)) & 1;
+		accepted += b;
+		if (a != b || (known[s] && !b)) {
+			if (failures++ < 10) cout << "solution " << s << ": AVX2 " << a << ", scalar " << b << "\n";
+		}
+	}
+	cout << count << " solutions, " << accepted << " valid, AVX2 path " << (simd ? "checked" : "not available") << ", " << failures << " failures\n";
+	return failures == 0 ? 0 : 1;
+}
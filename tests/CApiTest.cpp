@@ -0,0 +1,204 @@
+// Drives the engine only through libqueens: handles, seeding, move statuses, save round-trips,
+// verify, loading a pack, and the error statuses for bad handles, arguments and buffers.
+#include "QueensAPI.h"
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+	if (!ok && failures++ < 20) cout << "failed: " << what << "\n";
+}
+
+static void checkStatus(queens_status got, queens_status expected, const char* what) {
+	if (got != expected && failures++ < 20) {
+		cout << "failed: " << what << ": got " << queens_status_name(got) << ", expected " << queens_status_name(expected) << "\n";
+	}
+}
+
+static bool sameRegions(queens_game* a, queens_game* b) {
+	for (int cell = 0; cell < QUEENS_BOARD_SIZE * QUEENS_BOARD_SIZE; cell++) {
+		int row = cell / QUEENS_BOARD_SIZE;
+		int col = cell % QUEENS_BOARD_SIZE;
+		if (queens_region(a, row, col) != queens_region(b, row, col)) return false;
+	}
+	return true;
+}
+
+static bool sameCells(queens_game* a, queens_game* b) {
+	for (int cell = 0; cell < QUEENS_BOARD_SIZE * QUEENS_BOARD_SIZE; cell++) {
+		int row = cell / QUEENS_BOARD_SIZE;
+		int col = cell % QUEENS_BOARD_SIZE;
+		if (queens_cell(a, row, col) != queens_cell(b, row, col)) return false;
+	}
+	return true;
+}
+
+// A version 2 pack holding one map and its solutions, with no certificate.
+static vector<unsigned char> makePack(queens_game* game, const vector<vector<int> >& solutions) {
+	vector<unsigned char> pack;
+	pack.push_back('Q');
+	pack.push_back('P');
+	pack.push_back('A');
+	pack.push_back('K');
+	pack.push_back(2);
+	pack.push_back(1);
+	for (int cell = 0; cell < QUEENS_BOARD_SIZE * QUEENS_BOARD_SIZE; cell += 2) {
+		int low = queens_region(game, cell / QUEENS_BOARD_SIZE, cell % QUEENS_BOARD_SIZE);
+		int high = queens_region(game, (cell + 1) / QUEENS_BOARD_SIZE, (cell + 1) % QUEENS_BOARD_SIZE);
+		pack.push_back((unsigned char)(low | (high << 4)));
+	}
+	pack.push_back((unsigned char)solutions.size());
+	for (size_t s = 0; s < solutions.size(); s++) {
+		unsigned int packed = 0;
+		for (int row = 0; row < QUEENS_BOARD_SIZE; row++) {
+			packed |= (unsigned int)solutions[s][row] << (3 * row);
+		}
+		pack.push_back((unsigned char)(packed & 0xFF));
+		pack.push_back((unsigned char)((packed >> 8) & 0xFF));
+		pack.push_back((unsigned char)(packed >> 16));
+	}
+	pack.push_back(0);
+	return pack;
+}
+
+int main() {
+	// Seeding: the same seed gives the same puzzle, whether at creation or through queens_seed.
+	queens_game* a = queens_create(42);
+	queens_game* b = queens_create(42);
+	queens_game* c = queens_create(7);
+	check(a != NULL && b != NULL && c != NULL, "create");
+	check(sameRegions(a, b) && queens_puzzle_key(a) == queens_puzzle_key(b), "same seed, same puzzle");
+	checkStatus(queens_seed(c, 42), QUEENS_OK, "reseed");
+	check(sameRegions(a, c), "queens_seed matches queens_create");
+	bool differs = false;
+	for (unsigned long long seed = 1; seed <= 8 && !differs; seed++) {
+		queens_seed(c, seed);
+		differs = !sameRegions(a, c);
+	}
+	check(differs, "different seeds give different puzzles");
+
+	// Move statuses, in the order QueensGame checks them.
+	int cols[QUEENS_BOARD_SIZE];
+	checkStatus(queens_solve(a, cols), QUEENS_OK, "solve");
+	check(queens_verify(a, cols) == 1, "verify accepts the solution");
+	check(queens_solutions_left(a) >= 1, "solutions left on a fresh puzzle");
+	checkStatus(queens_undo(a), QUEENS_NOTHING_TO_UNDO, "undo at the start");
+	checkStatus(queens_redo(a), QUEENS_NOTHING_TO_REDO, "redo at the start");
+	checkStatus(queens_move(a, QUEENS_PLACE, -1, 0), QUEENS_OUT_OF_RANGE, "place off the board");
+	checkStatus(queens_move(a, QUEENS_MARK, 0, QUEENS_BOARD_SIZE), QUEENS_OUT_OF_RANGE, "mark off the board");
+	checkStatus(queens_move(a, QUEENS_REMOVE, 0, cols[0]), QUEENS_NO_QUEEN, "remove from an empty cell");
+	checkStatus(queens_move(a, QUEENS_CLEAR, 0, cols[0]), QUEENS_ALREADY_EMPTY, "clear an empty cell");
+	checkStatus(queens_move(a, (queens_action)9, 0, 0), QUEENS_INVALID_ARGUMENT, "unknown action");
+	checkStatus(queens_move(a, QUEENS_PLACE, 0, cols[0]), QUEENS_OK, "place");
+	check(queens_cell(a, 0, cols[0]) == 1 && queens_queen_count(a) == 1 && queens_move_count(a) == 1, "queen on the board");
+	checkStatus(queens_move(a, QUEENS_PLACE, 0, cols[0]), QUEENS_OCCUPIED, "place on a queen");
+	checkStatus(queens_move(a, QUEENS_MARK, 0, cols[0]), QUEENS_IS_QUEEN, "mark a queen");
+	int other = (cols[0] + 4) % QUEENS_BOARD_SIZE;
+	checkStatus(queens_move(a, QUEENS_MARK, 1, cols[1]), QUEENS_OK, "mark");
+	check(queens_cell(a, 1, cols[1]) == 2, "mark on the board");
+	checkStatus(queens_move(a, QUEENS_MARK, 1, cols[1]), QUEENS_ALREADY_MARKED, "mark twice");
+	checkStatus(queens_move(a, QUEENS_PLACE, 1, cols[1]), QUEENS_MARKED, "place on a mark");
+	checkStatus(queens_move(a, QUEENS_CLEAR, 1, cols[1]), QUEENS_OK, "clear a mark");
+	checkStatus(queens_undo(a), QUEENS_OK, "undo");
+	check(queens_cell(a, 1, cols[1]) == 2, "undo restores the mark");
+	checkStatus(queens_redo(a), QUEENS_OK, "redo");
+	check(queens_cell(a, 1, cols[1]) == 0, "redo clears the mark again");
+	checkStatus(queens_move(a, QUEENS_REMOVE, 0, cols[0]), QUEENS_OK, "remove");
+	checkStatus(queens_move(a, QUEENS_PLACE, 0, other), QUEENS_OK, "place off the solution");
+	check(queens_cell(a, 0, other) == 1 && queens_queen_count(a) == 1, "moved queen");
+	for (int row = 1; row < QUEENS_BOARD_SIZE; row++) {
+		if (queens_cell(a, row, other) == 0) {
+			checkStatus(queens_move(a, QUEENS_PLACE, row, other), QUEENS_COL_CONFLICT, "second queen in a column");
+			break;
+		}
+	}
+	checkStatus(queens_move(a, QUEENS_CLEAR, 0, other), QUEENS_OK, "clear a queen");
+	for (int row = 0; row < QUEENS_BOARD_SIZE; row++) {
+		checkStatus(queens_move(a, QUEENS_PLACE, row, cols[row]), QUEENS_OK, "place the solution");
+	}
+	check(queens_is_solved(a) == 1 && queens_queen_count(a) == QUEENS_BOARD_SIZE, "solved");
+
+	// Save round-trip, and the buffer-size protocol.
+	size_t size = 0;
+	checkStatus(queens_serialize(a, NULL, &size), QUEENS_BUFFER_TOO_SMALL, "size query");
+	vector<unsigned char> blob(size);
+	size_t small = size - 1;
+	checkStatus(queens_serialize(a, &blob[0], &small), QUEENS_BUFFER_TOO_SMALL, "buffer one byte short");
+	check(small == size, "the short buffer reports the needed size");
+	checkStatus(queens_serialize(a, &blob[0], &size), QUEENS_OK, "serialize");
+	checkStatus(queens_deserialize(b, &blob[0], blob.size()), QUEENS_OK, "deserialize");
+	check(sameRegions(a, b) && sameCells(a, b), "loaded board");
+	check(queens_move_count(a) == queens_move_count(b) && queens_queen_count(a) == queens_queen_count(b)
+		&& queens_is_solved(b) == 1, "loaded counters");
+	vector<unsigned char> again(blob.size());
+	size_t againSize = again.size();
+	checkStatus(queens_serialize(b, &again[0], &againSize), QUEENS_OK, "serialize the loaded game");
+	check(again == blob, "the loaded game saves the same blob");
+	checkStatus(queens_deserialize(b, &blob[0], blob.size() / 2), QUEENS_BAD_SAVE, "truncated save");
+	check(sameCells(a, b), "a bad save leaves the game unchanged");
+
+	// Verify rejects anything but a solution of this puzzle.
+	queens_seed(a, 42);
+	int wrong[QUEENS_BOARD_SIZE];
+	for (int row = 0; row < QUEENS_BOARD_SIZE; row++) wrong[row] = cols[row];
+	wrong[0] = other;
+	check(queens_verify(a, wrong) == 0, "verify rejects a changed column");
+	wrong[0] = QUEENS_BOARD_SIZE;
+	check(queens_verify(a, wrong) == 0, "verify rejects a column off the board");
+	int regions[QUEENS_BOARD_SIZE * QUEENS_BOARD_SIZE];
+	for (int cell = 0; cell < QUEENS_BOARD_SIZE * QUEENS_BOARD_SIZE; cell++) {
+		regions[cell] = queens_region(c, cell / QUEENS_BOARD_SIZE, cell % QUEENS_BOARD_SIZE);
+	}
+	checkStatus(queens_set_puzzle(b, regions), QUEENS_OK, "set puzzle");
+	check(sameRegions(b, c) && queens_queen_count(b) == 0, "set puzzle starts a new game");
+	regions[0] = QUEENS_BOARD_SIZE;
+	check(queens_set_puzzle(b, regions) != QUEENS_OK, "set puzzle rejects a bad color");
+
+	// Packs: a good one loads and keeps verify working; damaged ones are refused.
+	vector<vector<int> > solutions(1, vector<int>(cols, cols + QUEENS_BOARD_SIZE));
+	vector<unsigned char> pack = makePack(a, solutions);
+	checkStatus(queens_load_pack(&pack[0], pack.size()), QUEENS_OK, "load pack");
+	check(queens_verify(a, cols) == 1, "verify after loading the pack");
+	wrong[0] = other;
+	check(queens_verify(a, wrong) == 0, "verify after loading the pack rejects a changed column");
+	checkStatus(queens_load_pack(&pack[0], pack.size() - 5), QUEENS_BAD_SAVE, "truncated pack");
+	vector<vector<int> > illegal(1, vector<int>(QUEENS_BOARD_SIZE, 0));
+	vector<unsigned char> badSolution = makePack(a, illegal);
+	checkStatus(queens_load_pack(&badSolution[0], badSolution.size()), QUEENS_BAD_SAVE, "pack with an illegal solution");
+	vector<unsigned char> badMagic = pack;
+	badMagic[0] = 'X';
+	checkStatus(queens_load_pack(&badMagic[0], badMagic.size()), QUEENS_BAD_SAVE, "pack with a bad magic");
+
+	// Bad handles and arguments.
+	checkStatus(queens_seed(NULL, 1), QUEENS_INVALID_ARGUMENT, "seed a null handle");
+	checkStatus(queens_move(NULL, QUEENS_PLACE, 0, 0), QUEENS_INVALID_ARGUMENT, "move on a null handle");
+	checkStatus(queens_undo(NULL), QUEENS_INVALID_ARGUMENT, "undo on a null handle");
+	checkStatus(queens_redo(NULL), QUEENS_INVALID_ARGUMENT, "redo on a null handle");
+	int row, col;
+	checkStatus(queens_hint(NULL, &row, &col), QUEENS_INVALID_ARGUMENT, "hint on a null handle");
+	checkStatus(queens_hint(a, NULL, &col), QUEENS_INVALID_ARGUMENT, "hint with a null row");
+	checkStatus(queens_solve(NULL, cols), QUEENS_INVALID_ARGUMENT, "solve on a null handle");
+	checkStatus(queens_solve(a, NULL), QUEENS_INVALID_ARGUMENT, "solve with a null buffer");
+	check(queens_verify(NULL, cols) == 0 && queens_verify(a, NULL) == 0, "verify with null arguments");
+	checkStatus(queens_serialize(NULL, &blob[0], &size), QUEENS_INVALID_ARGUMENT, "serialize a null handle");
+	checkStatus(queens_serialize(a, &blob[0], NULL), QUEENS_INVALID_ARGUMENT, "serialize with a null size");
+	checkStatus(queens_deserialize(NULL, &blob[0], blob.size()), QUEENS_INVALID_ARGUMENT, "deserialize a null handle");
+	checkStatus(queens_deserialize(a, NULL, 0), QUEENS_INVALID_ARGUMENT, "deserialize a null buffer");
+	checkStatus(queens_set_puzzle(NULL, regions), QUEENS_INVALID_ARGUMENT, "set puzzle on a null handle");
+	checkStatus(queens_set_puzzle(a, NULL), QUEENS_INVALID_ARGUMENT, "set puzzle with null regions");
+	checkStatus(queens_load_pack(NULL, 0), QUEENS_INVALID_ARGUMENT, "load a null pack");
+	check(queens_cell(NULL, 0, 0) == -1 && queens_cell(a, 0, -1) == -1 && queens_region(a, QUEENS_BOARD_SIZE, 0) == -1, "cell queries off the board");
+	check(queens_puzzle_key(NULL) == 0 && queens_queen_count(NULL) == 0 && queens_move_count(NULL) == 0
+		&& queens_solutions_left(NULL) == 0 && queens_is_solved(NULL) == 0, "queries on a null handle");
+	check(string(queens_status_name((queens_status)99)) == "unknown", "name of an unknown status");
+	queens_destroy(NULL);
+
+	queens_destroy(a);
+	queens_destroy(b);
+	queens_destroy(c);
+	cout << failures << " failures\n";
+	return failures == 0 ? 0 : 1;
+}
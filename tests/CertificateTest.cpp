@@ -0,0 +1,98 @@
+// Builds uniqueness certificates for generated puzzles and checks that each verifies, and that
+// verify() rejects every copy with one byte changed, every truncated or padded copy, and any
+// packed solution but the right one. build() must refuse maps with no solution or several, and
+// a pack must not load when a certificate comes with zero or two stored solutions.
+#include "QueensEngine.h"
+#include <iostream>
+using namespace std;
+
+int main() {
+	PuzzleGenerator generator;
+	PuzzleSolver solver;
+	unsigned long long rng = 46;
+	int failures = 0, certificates = 0;
+	long long bytes = 0;
+	int grid[BOARD_SIZE][BOARD_SIZE];
+
+	for (int p = 0; p < 100; p++) {
+		if (!generator.generate(ZobristKeys::next(rng), grid, 64)) continue;
+		vector<unsigned char> certificate;
+		unsigned int packed;
+		if (!UniquenessCertificate::build(grid, certificate, packed) || packed != UniquenessCertificate::packSolution(generator.planted)) {
+			if (failures++ < 10) cout << "puzzle " << p << ": no certificate for the planted solution\n";
+			continue;
+		}
+		certificates++;
+		bytes += (long long)certificate.size();
+		if (!UniquenessCertificate::verify(grid, certificate, packed) && failures++ < 10) cout << "puzzle " << p << ": a valid certificate was rejected\n";
+
+		for (size_t at = 0; at < certificate.size(); at++) {
+			for (int bit = 0; bit < 8; bit++) {
+				vector<unsigned char> flipped = certificate;
+				flipped[at] ^= (unsigned char)(1 << bit);
+				if (UniquenessCertificate::verify(grid, flipped, packed) && failures++ < 10) {
+					cout << "puzzle " << p << ": byte " << at << " with bit " << bit << " flipped verified\n";
+				}
+			}
+		}
+		for (size_t size = 0; size < certificate.size(); size++) {
+			vector<unsigned char> truncated(certificate.begin(), certificate.begin() + size);
+			if (UniquenessCertificate::verify(grid, truncated, packed) && failures++ < 10) {
+				cout << "puzzle " << p << ": a " << size << "-byte prefix verified\n";
+			}
+		}
+		vector<unsigned char> padded = certificate;
+		padded.push_back(0);
+		if (UniquenessCertificate::verify(grid, padded, packed) && failures++ < 10) cout << "puzzle " << p << ": a padded certificate verified\n";
+
+		for (int row = 0; row < BOARD_SIZE; row++) {
+			for (int col = 0; col < BOARD_SIZE; col++) {
+				unsigned int wrong = (packed & ~(7U << (3 * row))) | ((unsigned int)col << (3 * row));
+				if (wrong != packed && UniquenessCertificate::verify(grid, certificate, wrong) && failures++ < 10) {
+					cout << "puzzle " << p << ": verified with row " << row << " moved to column " << col << "\n";
+				}
+			}
+		}
+
+		// The same certificate in a pack, stored with no solution or with a second one.
+		SolutionIndex single;
+		single.addPuzzle(grid, solver);
+		single.rebuild();
+		vector<unsigned char> pack = single.savePack();
+		size_t countAt = 5 + 1 + BOARD_SIZE * BOARD_SIZE / 2;
+		vector<unsigned char> none = pack;
+		none[countAt] = 0;
+		none.erase(none.begin() + countAt + 1, none.begin() + countAt + 4);
+		vector<unsigned char> two = pack;
+		two[countAt] = 2;
+		unsigned int other = single.get(0).solutions[0] ^ 1;
+		unsigned char extra[3] = { (unsigned char)(other & 0xFF), (unsigned char)((other >> 8) & 0xFF), (unsigned char)(other >> 16) };
+		two.insert(two.begin() + countAt + 4, extra, extra + 3);
+		SolutionIndex index;
+		if (!index.loadPack(pack) || index.loadPack(none) || index.loadPack(two) || index.size() != 1) {
+			if (failures++ < 10) cout << "puzzle " << p << ": a certificate loaded without exactly one stored solution\n";
+		}
+	}
+
+	// No solution: two one-cell regions touching diagonally.
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		grid[cell / BOARD_SIZE][cell % BOARD_SIZE] = 2 + (cell / BOARD_SIZE) % 6;
+	}
+	grid[0][0] = 0;
+	grid[1][1] = 1;
+	vector<unsigned char> certificate;
+	unsigned int packed = 0;
+	if (UniquenessCertificate::build(grid, certificate, packed) || !certificate.empty()) {
+		cout << "a map with no solution got a certificate\n";
+		failures++;
+	}
+	// Many solutions: every shipped map has more than one.
+	for (int m = 0; m < BASE_MAP_COUNT; m++) {
+		if (UniquenessCertificate::build(BASE_MAPS[m], certificate, packed) || !certificate.empty()) {
+			if (failures++ < 10) cout << "base map " << m << " got a certificate\n";
+		}
+	}
+
+	cout << certificates << " certificates (" << (certificates > 0 ? bytes / certificates : 0) << " bytes each), " << failures << " failures\n";
+	return failures == 0 ? 0 : 1;
+}
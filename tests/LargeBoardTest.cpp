@@ -0,0 +1,46 @@
+// Plays random placements and removals on LargeBoard and compares the candidate cells after each
+// removal with a board of the same seed that placed only the remaining queens, in order.
+#include "QueensEngine.h"
+#include <iostream>
+using namespace std;
+
+int main() {
+	int failures = 0;
+	int sizes[] = { 9, 17, 64, 70 };
+	for (int s = 0; s < 4; s++) {
+		int n = sizes[s];
+		LargeBoard board(n, 100 + n);
+		unsigned long long rng = n;
+		vector<int> queens;
+		for (int step = 0; step < 400; step++) {
+			int row = (int)(ZobristKeys::next(rng) % n);
+			int col = (int)(ZobristKeys::next(rng) % n);
+			if (!queens.empty() && ZobristKeys::next(rng) % 3 == 0) {
+				int pick = (int)(ZobristKeys::next(rng) % queens.size());
+				board.removeQueen(queens[pick] / n, queens[pick] % n);
+				queens.erase(queens.begin() + pick);
+			}
+			else if (board.placeQueen(row, col) == STATUS_OK) {
+				queens.push_back(row * n + col);
+				continue;
+			}
+			else {
+				continue;
+			}
+
+			LargeBoard fresh(n, 100 + n);
+			for (size_t k = 0; k < queens.size(); k++) {
+				fresh.placeQueen(queens[k] / n, queens[k] % n);
+			}
+			for (int cell = 0; cell < n * n; cell++) {
+				if (board.isCandidate(cell / n, cell % n) != fresh.isCandidate(cell / n, cell % n)) {
+					if (failures++ < 5) cout << n << "x" << n << " step " << step << ": cell " << cell << " differs\n";
+					break;
+				}
+			}
+		}
+		if (board.getQueenCount() != (int)queens.size()) failures++;
+	}
+	cout << failures << " failures\n";
+	return failures == 0 ? 0 : 1;
+}
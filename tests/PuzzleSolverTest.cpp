@@ -0,0 +1,96 @@
+// Checks BasicPuzzleSolver against a plain backtracking count: the shipped 8x8 maps and random
+// 12x12 maps, with and without some cells ruled out. Also reports the time per 12x12 count.
+#include "QueensEngine.h"
+#include <iostream>
+using namespace std;
+
+template <int N>
+int bruteForce(int grid[N][N], int allowed[N], int row, int cols, int colors, int prevCol) {
+	if (row == N) return 1;
+	int total = 0;
+	for (int c = 0; c < N; c++) {
+		if (!((allowed[row] >> c) & 1) || ((cols >> c) & 1) || ((colors >> grid[row][c]) & 1)) continue;
+		if (prevCol != -1 && (c == prevCol - 1 || c == prevCol + 1)) continue;
+		total += bruteForce<N>(grid, allowed, row + 1, cols | (1 << c), colors | (1 << grid[row][c]), c);
+	}
+	return total;
+}
+
+// Grows N regions from random seeds by random flood fill.
+template <int N>
+void randomMap(unsigned long long& rng, int grid[N][N]) {
+	for (int cell = 0; cell < N * N; cell++) grid[cell / N][cell % N] = -1;
+	vector<int> frontier;
+	for (int g = 0; g < N; g++) {
+		int cell;
+		do cell = (int)(ZobristKeys::next(rng) % (N * N)); while (grid[cell / N][cell % N] != -1);
+		grid[cell / N][cell % N] = g;
+		frontier.push_back(cell);
+	}
+	while (!frontier.empty()) {
+		int pick = (int)(ZobristKeys::next(rng) % frontier.size());
+		int cell = frontier[pick];
+		int row = cell / N, col = cell % N;
+		int dr[4] = { -1, 1, 0, 0 }, dc[4] = { 0, 0, -1, 1 };
+		bool grew = false;
+		for (int d = 0; d < 4 && !grew; d++) {
+			int r = row + dr[d], c = col + dc[d];
+			if (r < 0 || r >= N || c < 0 || c >= N || grid[r][c] != -1) continue;
+			grid[r][c] = grid[row][col];
+			frontier.push_back(r * N + c);
+			grew = true;
+		}
+		if (!grew) {
+			frontier[pick] = frontier.back();
+			frontier.pop_back();
+		}
+	}
+}
+
+template <int N>
+int check(BasicPuzzleSolver<N>& solver, int grid[N][N], unsigned long long& rng, double& seconds) {
+	int failures = 0;
+	solver.setColorGrid(grid);
+	int allowed[N];
+	for (int step = 0; step < 4; step++) {
+		for (int i = 0; i < N; i++) {
+			allowed[i] = step == 0 ? (1 << N) - 1 : allowed[i] & ~(1 << (ZobristKeys::next(rng) % N));
+		}
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		int fast = solver.countSolutions(allowed);
+		seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		int slow = bruteForce<N>(grid, allowed, 0, 0, 0, -1);
+		vector<typename BasicPuzzleSolver<N>::Packed> listed;
+		solver.listSolutions(allowed, listed);
+		if (fast != slow || (int)listed.size() != slow) {
+			if (failures++ < 5) cout << N << "x" << N << ": counted " << fast << ", listed " << listed.size() << ", expected " << slow << "\n";
+		}
+	}
+	return failures;
+}
+
+int main() {
+	unsigned long long rng = 7;
+	int failures = 0;
+	double seconds = 0;
+
+	PuzzleSolver small;
+	for (int m = 0; m < BASE_MAP_COUNT; m++) {
+		int grid[BOARD_SIZE][BOARD_SIZE];
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) grid[cell / BOARD_SIZE][cell % BOARD_SIZE] = BASE_MAPS[m][cell / BOARD_SIZE][cell % BOARD_SIZE];
+		failures += check<BOARD_SIZE>(small, grid, rng, seconds);
+	}
+
+	BasicPuzzleSolver<12>* large = new BasicPuzzleSolver<12>();
+	const int maps = 30;
+	seconds = 0;
+	for (int m = 0; m < maps; m++) {
+		int grid[12][12];
+		randomMap<12>(rng, grid);
+		failures += check<12>(*large, grid, rng, seconds);
+	}
+	delete large;
+
+	cout << "12x12: " << (int)(seconds * 1e6 / (4 * maps)) << "us per count, " << failures << " failures\n";
+	return failures == 0 ? 0 : 1;
+}
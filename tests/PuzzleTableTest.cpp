@@ -0,0 +1,37 @@
+// Several threads intern and release the same two maps at once, so puzzles are created and
+// deleted over and over while other threads look them up. Every intern() must return a puzzle
+// for the map asked for, and the table must be empty once every reference is released.
+#include "QueensEngine.h"
+#include <iostream>
+using namespace std;
+
+atomic<int> failures(0);
+
+void churn(int seed) {
+	for (int round = 0; round < 2000; round++) {
+		const int (*grid)[BOARD_SIZE] = BASE_MAPS[(seed + round) % 2];
+		Puzzle* puzzle = puzzleTable.intern(grid);
+		if (!puzzle->hasMap(grid)) failures++;
+		if (round % 3 == 0) {
+			puzzleTable.acquire(puzzle);
+			puzzleTable.release(puzzle);
+		}
+		puzzleTable.release(puzzle);
+	}
+}
+
+int main() {
+	vector<thread> threads;
+	for (int t = 0; t < 4; t++) {
+		threads.push_back(thread(churn, t));
+	}
+	for (size_t t = 0; t < threads.size(); t++) {
+		threads[t].join();
+	}
+	if (puzzleTable.size() != 0) {
+		cout << puzzleTable.size() << " puzzles left in the table\n";
+		failures++;
+	}
+	cout << failures << " failures\n";
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+// Checks each rule policy against a plain reference written out here: the attack mask of every
+// cell against the geometry the rule describes, RuleBoard's solution counts on the shipped maps
+// against a brute-force search, and every puzzle BasicPuzzleGenerator makes for the policy
+// against the same search, which must find exactly one solution, the one the generator planted.
+#include "QueensEngine.h"
+#include <iostream>
+using namespace std;
+
+static const int CELLS = BOARD_SIZE * BOARD_SIZE;
+
+static bool classicAttack(int dr, int dc) {
+	return (dr == 1 || dr == -1) && (dc == 1 || dc == -1);
+}
+
+static bool chessAttack(int dr, int dc) {
+	return dr != 0 && (dr == dc || dr == -dc);
+}
+
+static bool starAttack(int dr, int dc) {
+	return !(dr == 0 && dc == 0) && dr * dr <= 1 && dc * dc <= 1;
+}
+
+static bool knightAttack(int dr, int dc) {
+	return classicAttack(dr, dc) || (dr * dr == 1 && dc * dc == 4) || (dr * dr == 4 && dc * dc == 1);
+}
+
+// Rows are filled in order with perUnit queens each, so only columns, regions and attacks on
+// earlier queens need checking. Stops counting at limit.
+struct Reference {
+	bool (*attack)(int, int);
+	int perUnit;
+	int regions[CELLS];
+	int colCount[BOARD_SIZE];
+	int regionCount[BOARD_SIZE];
+	int queens[BOARD_SIZE * 2];
+	int placed;
+	int limit;
+	int found;
+	unsigned long long first;
+
+	bool fits(int cell) {
+		if (colCount[cell % BOARD_SIZE] == perUnit || regionCount[regions[cell]] == perUnit) return false;
+		for (int q = 0; q < placed; q++) {
+			if (attack(cell / BOARD_SIZE - queens[q] / BOARD_SIZE, cell % BOARD_SIZE - queens[q] % BOARD_SIZE)) return false;
+		}
+		return true;
+	}
+
+	void search(int row, int fromCol, int need) {
+		if (found >= limit) return;
+		if (need == 0) {
+			if (row + 1 < BOARD_SIZE) {
+				search(row + 1, 0, perUnit);
+				return;
+			}
+			for (int r = 0; r < BOARD_SIZE; r++) {
+				if (colCount[r] != perUnit || regionCount[r] != perUnit) return;
+			}
+			if (found++ == 0) {
+				first = 0;
+				for (int q = 0; q < placed; q++) first |= 1ULL << queens[q];
+			}
+			return;
+		}
+		for (int col = fromCol; col < BOARD_SIZE; col++) {
+			int cell = row * BOARD_SIZE + col;
+			if (!fits(cell)) continue;
+			colCount[col]++;
+			regionCount[regions[cell]]++;
+			queens[placed++] = cell;
+			search(row, col + 1, need - 1);
+			placed--;
+			colCount[col]--;
+			regionCount[regions[cell]]--;
+		}
+	}
+
+	int count(const int grid[BOARD_SIZE][BOARD_SIZE], int maxCount) {
+		for (int cell = 0; cell < CELLS; cell++) regions[cell] = grid[cell / BOARD_SIZE][cell % BOARD_SIZE];
+		for (int u = 0; u < BOARD_SIZE; u++) colCount[u] = regionCount[u] = 0;
+		placed = 0;
+		limit = maxCount;
+		found = 0;
+		search(0, 0, perUnit);
+		return found;
+	}
+};
+
+template <class Rules>
+int checkPolicy(bool (*attack)(int, int), int perUnit, int puzzles, unsigned long long seed) {
+	int failures = 0;
+	for (int cell = 0; cell < CELLS; cell++) {
+		unsigned long long expected = 0;
+		for (int other = 0; other < CELLS; other++) {
+			if (attack(other / BOARD_SIZE - cell / BOARD_SIZE, other % BOARD_SIZE - cell % BOARD_SIZE)) expected |= 1ULL << other;
+		}
+		if (AttackTable<Rules>::instance.masks[cell] != expected && failures++ < 5) {
+			cout << Rules::name() << ": attack mask of cell " << cell << " is " << hex << AttackTable<Rules>::instance.masks[cell]
+				<< ", expected " << expected << dec << "\n";
+		}
+	}
+	if (Rules::PER_UNIT != perUnit) {
+		cout << Rules::name() << ": " << Rules::PER_UNIT << " per unit, expected " << perUnit << "\n";
+		failures++;
+	}
+
+	Reference reference;
+	reference.attack = attack;
+	reference.perUnit = perUnit;
+	RuleBoard<Rules> board;
+	vector<unsigned long long> found;
+	for (int m = 0; m < BASE_MAP_COUNT; m++) {
+		board.setRegions(BASE_MAPS[m]);
+		int count = board.listSolutions(0, 1000, found);
+		int expected = reference.count(BASE_MAPS[m], 1000);
+		if (count != expected && failures++ < 5) cout << Rules::name() << ": base map " << m << " has " << count << " solutions, expected " << expected << "\n";
+	}
+
+	BasicPuzzleGenerator<Rules> generator;
+	int grid[BOARD_SIZE][BOARD_SIZE];
+	int made = 0;
+	for (int p = 0; p < puzzles; p++) {
+		if (!generator.generate(ZobristKeys::next(seed), grid, 64)) continue;
+		made++;
+		int count = reference.count(grid, 2);
+		if ((count != 1 || reference.first != generator.planted) && failures++ < 5) {
+			cout << Rules::name() << ": generated puzzle " << p << " has " << count << " solutions";
+			if (count == 1) cout << ", not the planted one";
+			cout << "\n";
+		}
+	}
+	if (made == 0) {
+		cout << Rules::name() << ": no puzzle generated\n";
+		failures++;
+	}
+	cout << Rules::name() << ": " << made << " puzzles, " << failures << " failures\n";
+	return failures;
+}
+
+int main() {
+	int failures = 0;
+	failures += checkPolicy<ClassicRules>(classicAttack, 1, 100, 1);
+	failures += checkPolicy<ChessDiagonalRules>(chessAttack, 1, 100, 2);
+	failures += checkPolicy<StarBattleRules<2> >(starAttack, 2, 40, 3);
+	failures += checkPolicy<KnightExclusionRules>(knightAttack, 1, 100, 4);
+	cout << failures << " failures\n";
+	return failures == 0 ? 0 : 1;
+}
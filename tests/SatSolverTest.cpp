@@ -0,0 +1,84 @@
+// Enumerates every solution of the shipped maps and of generated puzzles with QueensEncoding,
+// blocking each one with findAnother() until the solver reports unsatisfiable, and checks the
+// list against PuzzleSolver. On its own, findAnother() after the first solution must prove a
+// unique puzzle unique and return a different valid solution for any other.
+#include "QueensEngine.h"
+#include <algorithm>
+#include <iostream>
+using namespace std;
+
+static unsigned int packCols(const vector<int>& cols) {
+	unsigned int packed = 0;
+	for (int row = 0; row < BOARD_SIZE; row++) {
+		packed |= (unsigned int)cols[row] << (3 * row);
+	}
+	return packed;
+}
+
+int main() {
+	PuzzleSolver solver;
+	PuzzleGenerator generator;
+	unsigned long long rng = 41;
+	int failures = 0, maps = 0, unique = 0;
+	long long total = 0;
+	int grid[BOARD_SIZE][BOARD_SIZE];
+	int allowed[BOARD_SIZE];
+	for (int i = 0; i < BOARD_SIZE; i++) allowed[i] = (1 << BOARD_SIZE) - 1;
+
+	for (int g = 0; g < BASE_MAP_COUNT + 60; g++) {
+		if (g < BASE_MAP_COUNT) {
+			for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+				grid[cell / BOARD_SIZE][cell % BOARD_SIZE] = BASE_MAPS[g][cell / BOARD_SIZE][cell % BOARD_SIZE];
+			}
+		}
+		else if (!generator.generate(ZobristKeys::next(rng), grid, 64)) {
+			continue;
+		}
+		maps++;
+		vector<int> regionOf(BOARD_SIZE * BOARD_SIZE);
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			regionOf[cell] = grid[cell / BOARD_SIZE][cell % BOARD_SIZE];
+		}
+		solver.setColorGrid(grid);
+		vector<unsigned int> expected;
+		solver.listSolutions(allowed, expected);
+		sort(expected.begin(), expected.end());
+		int count = solver.countSolutions(allowed);
+		if (count != (int)expected.size() && failures++ < 10) cout << "map " << g << ": PuzzleSolver counts " << count << " but lists " << expected.size() << "\n";
+		if (count == 1) unique++;
+		total += count;
+
+		// Enumerate by blocking each solution in turn.
+		QueensEncoding all(BOARD_SIZE, regionOf);
+		vector<int> cols, other;
+		vector<unsigned int> found;
+		SatResult result = all.solve(-1, cols);
+		while (result == SAT_SATISFIABLE && (int)found.size() <= count) {
+			found.push_back(packCols(cols));
+			result = all.findAnother(cols, -1, other);
+			cols = other;
+		}
+		sort(found.begin(), found.end());
+		if (result != SAT_UNSATISFIABLE || found != expected) {
+			if (failures++ < 10) cout << "map " << g << ": SAT found " << found.size() << " solutions, PuzzleSolver " << count << "\n";
+		}
+
+		// One findAnother() after the first solution.
+		QueensEncoding encoding(BOARD_SIZE, regionOf);
+		result = encoding.solve(-1, cols);
+		if (result != (count > 0 ? SAT_SATISFIABLE : SAT_UNSATISFIABLE)) {
+			if (failures++ < 10) cout << "map " << g << ": solve() disagrees with a count of " << count << "\n";
+			continue;
+		}
+		if (count == 0) continue;
+		result = encoding.findAnother(cols, -1, other);
+		if (count == 1 && result != SAT_UNSATISFIABLE) {
+			if (failures++ < 10) cout << "map " << g << ": findAnother() did not prove the puzzle unique\n";
+		}
+		if (count > 1 && (result != SAT_SATISFIABLE || other == cols || !binary_search(expected.begin(), expected.end(), packCols(other)))) {
+			if (failures++ < 10) cout << "map " << g << ": findAnother() did not return a second solution\n";
+		}
+	}
+	cout << maps << " maps (" << unique << " unique), " << total << " solutions, " << failures << " failures\n";
+	return failures == 0 ? 0 : 1;
+}
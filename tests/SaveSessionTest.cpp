@@ -0,0 +1,49 @@
+// Round-trips a session with branches and a jump back to the start, then feeds loadSession()
+// truncated, padded and bit-flipped copies: each must either load or leave the game unchanged.
+#include "QueensEngine.h"
+#include <iostream>
+using namespace std;
+
+int main() {
+	GameRecordsBST records;
+	QueensGame saved(&records, false);
+	saved.markX(0, 0);
+	saved.markX(1, 1);
+	saved.undo();
+	saved.markX(2, 2);
+	saved.jumpToVariation(0);
+	vector<unsigned char> blob = saved.saveSession();
+
+	QueensGame game(&records, false);
+	game.markX(3, 3);
+	vector<unsigned char> before = game.saveSession();
+
+	int failures = 0;
+	for (size_t size = 0; size <= blob.size() + 1; size++) {
+		if (size == blob.size()) continue;
+		vector<unsigned char> damaged(blob.begin(), blob.begin() + min(size, blob.size()));
+		if (size > blob.size()) damaged.push_back(0);
+		if (game.loadSession(damaged) || game.saveSession() != before) {
+			if (failures++ < 5) cout << "a " << size << "-byte copy loaded or changed the game\n";
+		}
+	}
+
+	unsigned long long rng = 3;
+	for (int k = 0; k < 5000; k++) {
+		vector<unsigned char> damaged = blob;
+		damaged[ZobristKeys::next(rng) % damaged.size()] ^= (unsigned char)(1 << (ZobristKeys::next(rng) % 8));
+		if (game.loadSession(damaged)) {
+			game.loadSession(before);
+		}
+		else if (game.saveSession() != before) {
+			if (failures++ < 5) cout << "a rejected save changed the game\n";
+		}
+	}
+
+	if (!game.loadSession(blob) || game.saveSession() != blob) {
+		cout << "the intact save did not round-trip\n";
+		failures++;
+	}
+	cout << failures << " failures\n";
+	return failures == 0 ? 0 : 1;
+}
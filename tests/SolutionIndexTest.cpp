@@ -0,0 +1,165 @@
+// Fills a SolutionIndex with the shipped maps and a few hundred generated ones, round-trips it
+// through savePack() and loadPack(), and checks that every map is found in the perfect hash from
+// any of its eight symmetric copies, that other keys and other maps miss, that packs with a bad
+// solution or certificate are refused, and that PuzzleSymmetry::mapSolution() carries each
+// solution to a solution of the transformed map.
+#include "QueensEngine.h"
+#include <algorithm>
+#include <iostream>
+using namespace std;
+
+static void transformGrid(int t, const int grid[BOARD_SIZE][BOARD_SIZE], int out[BOARD_SIZE][BOARD_SIZE]) {
+	for (int i = 0; i < BOARD_SIZE; i++) {
+		for (int j = 0; j < BOARD_SIZE; j++) {
+			int row = i, col = j;
+			PuzzleSymmetry::forward(t, row, col);
+			out[row][col] = grid[i][j];
+		}
+	}
+}
+
+static bool sameSet(const SolutionSet& a, const SolutionSet& b) {
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		if (a.labels[cell / BOARD_SIZE][cell % BOARD_SIZE] != b.labels[cell / BOARD_SIZE][cell % BOARD_SIZE]) return false;
+	}
+	return a.key == b.key && a.solutions == b.solutions && a.certificate == b.certificate;
+}
+
+int main() {
+	PuzzleSolver solver;
+	PuzzleGenerator generator;
+	SolutionIndex index;
+	index.addShipped();
+	vector<vector<int> > grids;
+	unsigned long long rng = 38;
+	int grid[BOARD_SIZE][BOARD_SIZE];
+	for (int m = 0; m < BASE_MAP_COUNT; m++) {
+		grids.push_back(vector<int>(&BASE_MAPS[m][0][0], &BASE_MAPS[m][0][0] + BOARD_SIZE * BOARD_SIZE));
+	}
+	for (int g = 0; g < 300; g++) {
+		if (!generator.generate(ZobristKeys::next(rng), grid, 64)) continue;
+		index.addPuzzle(grid, solver);
+		grids.push_back(vector<int>(&grid[0][0], &grid[0][0] + BOARD_SIZE * BOARD_SIZE));
+	}
+	index.rebuild();
+	int failures = 0;
+
+	// Pack round-trip: the same sets in the same order, and the same bytes when saved again.
+	vector<unsigned char> pack = index.savePack();
+	SolutionIndex loaded;
+	if (!loaded.loadPack(pack) || loaded.size() != index.size() || loaded.savePack() != pack) {
+		cout << "the pack did not round-trip\n";
+		failures++;
+	}
+	for (int k = 0; k < index.size() && k < loaded.size(); k++) {
+		if (!sameSet(index.get(k), loaded.get(k)) && failures++ < 10) cout << "set " << k << " changed in the pack\n";
+	}
+
+	// Every set is found by its own key and map, and every copy of every map finds its set.
+	for (int k = 0; k < loaded.size(); k++) {
+		const SolutionSet& set = loaded.get(k);
+		if (loaded.find(set.key, set.labels) != &set && failures++ < 10) cout << "set " << k << " not found\n";
+	}
+	for (size_t g = 0; g < grids.size(); g++) {
+		int original[BOARD_SIZE][BOARD_SIZE];
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			original[cell / BOARD_SIZE][cell % BOARD_SIZE] = grids[g][cell];
+		}
+		solver.setColorGrid(original);
+		int allowed[BOARD_SIZE];
+		for (int i = 0; i < BOARD_SIZE; i++) allowed[i] = (1 << BOARD_SIZE) - 1;
+		vector<unsigned int> solutions;
+		solver.listSolutions(allowed, solutions);
+
+		for (int t = 0; t < 8; t++) {
+			int copy[BOARD_SIZE][BOARD_SIZE];
+			transformGrid(t, original, copy);
+			for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+				copy[cell / BOARD_SIZE][cell % BOARD_SIZE] = (copy[cell / BOARD_SIZE][cell % BOARD_SIZE] + t) % BOARD_SIZE;
+			}
+			CanonicalForm form;
+			form.compute(copy);
+			const SolutionSet* set = loaded.find(form.key, form.labels);
+			if (set == NULL) {
+				if (failures++ < 10) cout << "map " << g << " under symmetry " << t << " not found\n";
+				continue;
+			}
+
+			// Each solution of the original, moved through t, is a solution of the copy, and
+			// moving it back gives the original solution.
+			vector<unsigned int> expected;
+			solver.setColorGrid(copy);
+			solver.listSolutions(allowed, expected);
+			sort(expected.begin(), expected.end());
+			vector<unsigned int> moved;
+			for (size_t s = 0; s < solutions.size(); s++) {
+				unsigned int forward, back;
+				if (!PuzzleSymmetry::mapSolution(t, solutions[s], forward, false)
+					|| !PuzzleSymmetry::mapSolution(t, forward, back, true) || back != solutions[s]) {
+					if (failures++ < 10) cout << "map " << g << ": solution " << s << " does not map back under symmetry " << t << "\n";
+				}
+				moved.push_back(forward);
+			}
+			sort(moved.begin(), moved.end());
+			if (moved != expected && failures++ < 10) cout << "map " << g << ": solutions moved through symmetry " << t << " differ\n";
+
+			// What the index stores for the copy, moved back out of canonical orientation.
+			vector<unsigned int> stored;
+			for (size_t s = 0; s < set->solutions.size(); s++) {
+				unsigned int mapped;
+				PuzzleSymmetry::mapSolution(form.transform, set->solutions[s], mapped, true);
+				stored.push_back(mapped);
+			}
+			sort(stored.begin(), stored.end());
+			if (stored != expected && failures++ < 10) cout << "map " << g << " under symmetry " << t << ": index solutions differ\n";
+		}
+	}
+
+	// Misses: unknown keys, and a known key with a different map.
+	for (int k = 0; k < 10000; k++) {
+		const SolutionSet& set = loaded.get(k % loaded.size());
+		if (loaded.find(ZobristKeys::next(rng), set.labels) != NULL && failures++ < 10) cout << "a random key was found\n";
+		int other[BOARD_SIZE][BOARD_SIZE];
+		const SolutionSet& next = loaded.get((k + 1) % loaded.size());
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			other[cell / BOARD_SIZE][cell % BOARD_SIZE] = next.labels[cell / BOARD_SIZE][cell % BOARD_SIZE];
+		}
+		if (loaded.find(set.key, other) != NULL && failures++ < 10) cout << "set " << k << " was found under another map\n";
+	}
+	SolutionIndex empty;
+	if (empty.find(loaded.get(0).key, loaded.get(0).labels) != NULL) {
+		cout << "an empty index found a set\n";
+		failures++;
+	}
+
+	// Damaged packs, on a generated map so that it is unique and certified: a solution moved to
+	// another column, or a certificate byte flipped, must reject the whole pack and leave the
+	// index as it was.
+	SolutionIndex single;
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		grid[cell / BOARD_SIZE][cell % BOARD_SIZE] = grids[BASE_MAP_COUNT][cell];
+	}
+	single.addPuzzle(grid, solver);
+	single.rebuild();
+	vector<unsigned char> good = single.savePack();
+	size_t solutionAt = 5 + 1 + BOARD_SIZE * BOARD_SIZE / 2 + 1;
+	for (int bit = 0; bit < 24; bit++) {
+		vector<unsigned char> bad = good;
+		bad[solutionAt + bit / 8] ^= (unsigned char)(1 << (bit % 8));
+		int before = loaded.size();
+		if ((loaded.loadPack(bad) || loaded.size() != before) && failures++ < 10) cout << "a pack with solution bit " << bit << " flipped loaded\n";
+	}
+	for (size_t at = solutionAt + 4; at < good.size(); at++) {
+		vector<unsigned char> bad = good;
+		bad[at] ^= 0x01;
+		int before = loaded.size();
+		if ((loaded.loadPack(bad) || loaded.size() != before) && failures++ < 10) cout << "a pack with certificate byte " << at << " flipped loaded\n";
+	}
+	if (single.get(0).certificate.empty() || !loaded.loadPack(good)) {
+		cout << "the undamaged single-puzzle pack did not load\n";
+		failures++;
+	}
+
+	cout << grids.size() << " maps, " << loaded.size() << " sets, " << failures << " failures\n";
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+// Checks the telemetry pipeline end to end: an EventRing hands events from one thread to another
+// in order and counts every push it refuses as dropped, and the events of two sessions come back
+// from the .qtel log the drain thread writes, in order and intact, through Telemetry::decode().
+#include "QueensEngine.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+using namespace std;
+
+static const unsigned int PUSHES = 200000;
+
+static EventRing shared;
+static atomic<unsigned int> accepted(0);
+static atomic<unsigned int> attempts(0);
+static atomic<bool> finished(false);
+
+// Even events are pushed until the ring takes them, odd ones only once.
+static void produce() {
+	for (unsigned int k = 0; k < PUSHES; k++) {
+		TelemetryEvent event;
+		event.time = k;
+		bool pushed;
+		do {
+			attempts++;
+			pushed = shared.push(event);
+			if (!pushed) this_thread::yield();
+		} while (!pushed && k % 2 == 0);
+		if (pushed) accepted++;
+	}
+	finished = true;
+}
+
+static TelemetryEvent makeEvent(unsigned long long time, int type, int cell, int flags, unsigned long long puzzle) {
+	TelemetryEvent event;
+	event.time = time;
+	event.puzzle = puzzle;
+	event.session = 0;
+	event.type = (unsigned char)type;
+	event.cell = (unsigned char)cell;
+	event.flags = (unsigned char)flags;
+	return event;
+}
+
+int main() {
+	int failures = 0;
+	TelemetryEvent event;
+
+	// One thread: a full ring refuses the next push and counts it; the rest pop in order.
+	EventRing ring;
+	unsigned int capacity = EventRing::CAPACITY;
+	for (unsigned int k = 0; k < capacity + 10; k++) {
+		bool pushed = ring.push(makeEvent(k, 1, 0, 0, 0));
+		if (pushed != (k < capacity) && failures++ < 10) cout << "push " << k << " returned " << pushed << "\n";
+	}
+	if (ring.dropped.load() != 10) {
+		cout << "dropped " << ring.dropped.load() << " events, expected 10\n";
+		failures++;
+	}
+	for (unsigned int k = 0; k < capacity; k++) {
+		if ((!ring.pop(event) || event.time != k) && failures++ < 10) cout << "pop " << k << " out of order\n";
+	}
+	if (ring.pop(event)) {
+		cout << "popped from an empty ring\n";
+		failures++;
+	}
+
+	// Two threads: the consumer sees the accepted events in push order, every even one among them,
+	// and accepted plus dropped accounts for every push.
+	thread producer(produce);
+	unsigned long long popped = 0, evens = 0, last = 0;
+	bool done = false;
+	while (!done) {
+		done = finished.load();
+		while (shared.pop(event)) {
+			if (popped > 0 && event.time <= last && failures++ < 10) cout << "event " << event.time << " after " << last << "\n";
+			if (event.time % 2 == 0) evens++;
+			last = event.time;
+			popped++;
+		}
+	}
+	producer.join();
+	if (popped != accepted || evens != PUSHES / 2 || accepted + shared.dropped.load() != attempts) {
+		cout << popped << " popped (" << evens << " even), " << accepted << " accepted, " << shared.dropped.load()
+			<< " dropped of " << attempts << " pushes\n";
+		failures++;
+	}
+
+	// Log round-trip: bursts of events in two sessions, some waiting long enough for the drain
+	// thread to write them as separate blocks, decode back to the same events per session.
+	const char* path = "TelemetryTest.qtel";
+	remove(path);
+	vector<TelemetryEvent> recorded[2];
+	unsigned int ids[2];
+	unsigned long long rng = 40;
+	{
+		Telemetry telemetry(path);
+		TelemetrySession* sessions[2] = { telemetry.openSession(), telemetry.openSession() };
+		for (int s = 0; s < 2; s++) ids[s] = sessions[s]->id;
+		unsigned long long time = 1000;
+		for (int burst = 0; burst < 6; burst++) {
+			for (int k = 0; k < 300; k++) {
+				int s = (int)(ZobristKeys::next(rng) % 2);
+				int type = k == 0 ? EVENT_START : 1 + (int)(ZobristKeys::next(rng) % EVENT_WIN);
+				int cell = type == EVENT_START ? 0xFF : (int)(ZobristKeys::next(rng) % (BOARD_SIZE * BOARD_SIZE));
+				time += ZobristKeys::next(rng) % (burst % 2 == 0 ? 100 : 1ULL << 40);
+				TelemetryEvent next = makeEvent(time, type, cell, (int)(ZobristKeys::next(rng) % 2), ZobristKeys::next(rng));
+				next.session = ids[s];
+				if (!sessions[s]->ring.push(next) && failures++ < 10) cout << "burst " << burst << " overflowed a ring\n";
+				recorded[s].push_back(next);
+			}
+			if (burst % 3 != 2) this_thread::sleep_for(chrono::milliseconds(3 * 50));
+		}
+		sessions[0]->close();
+		sessions[1]->close();
+		telemetry.flush();
+		TelemetrySummary summary = telemetry.getSummary();
+		if (summary.events != (long long)(recorded[0].size() + recorded[1].size()) || summary.dropped != 0 || summary.sessions != 2) {
+			cout << "summary: " << summary.events << " events, " << summary.dropped << " dropped, " << summary.sessions << " sessions\n";
+			failures++;
+		}
+	}
+
+	ifstream file(path, ios::binary);
+	vector<unsigned char> blob((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	file.close();
+	remove(path);
+	vector<TelemetryEvent> decoded;
+	if (!Telemetry::decode(blob, decoded)) {
+		cout << "the log did not decode\n";
+		failures++;
+	}
+	size_t next[2] = { 0, 0 };
+	for (size_t k = 0; k < decoded.size(); k++) {
+		int s = decoded[k].session == ids[0] ? 0 : decoded[k].session == ids[1] ? 1 : -1;
+		if (s < 0 || next[s] >= recorded[s].size()) {
+			if (failures++ < 10) cout << "decoded event " << k << " belongs to no recorded session\n";
+			continue;
+		}
+		const TelemetryEvent& want = recorded[s][next[s]++];
+		const TelemetryEvent& got = decoded[k];
+		if (got.time != want.time || got.type != want.type || got.cell != want.cell || got.flags != want.flags
+			|| (want.type == EVENT_START && got.puzzle != want.puzzle)) {
+			if (failures++ < 10) cout << "decoded event " << k << " differs from session " << s << " event " << next[s] - 1 << "\n";
+		}
+	}
+	if (next[0] != recorded[0].size() || next[1] != recorded[1].size()) {
+		cout << "decoded " << next[0] << " and " << next[1] << " events, recorded " << recorded[0].size() << " and " << recorded[1].size() << "\n";
+		failures++;
+	}
+	vector<unsigned char> cut(blob.begin(), blob.end() - 1);
+	if (Telemetry::decode(cut, decoded)) {
+		cout << "a truncated log decoded\n";
+		failures++;
+	}
+
+	cout << popped << " events through the ring, " << blob.size() << " log bytes, " << failures << " failures\n";
+	return failures == 0 ? 0 : 1;
+}
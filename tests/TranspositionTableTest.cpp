@@ -0,0 +1,115 @@
+// Plays random moves, undos, redos and jumps, and after each one compares the X marks and the
+// solutions-left count, which QueensGame reads from the shared transposition table when it can,
+// with a fresh computation: marks from the queens plus the hand-placed ones, and a count from a
+// separate PuzzleSolver. Between moves the slots of the current position and of every position
+// one toggle away are overwritten with entries for other keys that land in the same slot.
+#include "QueensEngine.h"
+#include <iostream>
+using namespace std;
+
+int main() {
+	PuzzleGenerator generator;
+	PuzzleSolver reference;
+	QueensGame game(NULL, false);
+	unsigned long long rng = 27;
+	int failures = 0, checks = 0;
+	int grid[BOARD_SIZE][BOARD_SIZE];
+
+	for (int g = 0; g < 60; g++) {
+		if (g < BASE_MAP_COUNT) {
+			for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+				grid[cell / BOARD_SIZE][cell % BOARD_SIZE] = BASE_MAPS[g][cell / BOARD_SIZE][cell % BOARD_SIZE];
+			}
+		}
+		else {
+			generator.generate(ZobristKeys::next(rng), grid, 64);
+		}
+		game.setPuzzle(grid);
+		int colors[BOARD_SIZE][BOARD_SIZE];
+		unsigned long long puzzleHash = 0;
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			colors[cell / BOARD_SIZE][cell % BOARD_SIZE] = game.getColor(cell / BOARD_SIZE, cell % BOARD_SIZE);
+			puzzleHash ^= zobrist.colorKeys[cell][colors[cell / BOARD_SIZE][cell % BOARD_SIZE]];
+		}
+		reference.setColorGrid(colors);
+
+		for (int step = 0; step < 150; step++) {
+			int row = (int)(ZobristKeys::next(rng) % BOARD_SIZE);
+			int col = (int)(ZobristKeys::next(rng) % BOARD_SIZE);
+			switch (ZobristKeys::next(rng) % 8) {
+			case 0:
+			case 1:
+			case 2:
+				game.placeQueen(row, col);
+				break;
+			case 3:
+				game.removeQueen(row, col);
+				break;
+			case 4:
+				game.markX(row, col);
+				break;
+			case 5:
+				game.clearCell(row, col);
+				break;
+			case 6:
+				game.undo();
+				break;
+			default:
+				if (ZobristKeys::next(rng) & 1) game.redo();
+				else game.jumpToVariation((int)(ZobristKeys::next(rng) % game.getVariations().getNodeCount()));
+				break;
+			}
+
+			unsigned long long queens = 0, marks = 0;
+			for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+				int state = game.getCell(cell / BOARD_SIZE, cell % BOARD_SIZE);
+				if (state == 1) queens |= 1ULL << cell;
+				if (state == 2) marks |= 1ULL << cell;
+			}
+			unsigned long long manual = game.getVariations().getCurrent()->manualMarks;
+			unsigned long long expectedMarks = manual & ~queens;
+			unsigned long long positionHash = puzzleHash;
+			for (int q = 0; q < BOARD_SIZE * BOARD_SIZE; q++) {
+				if (!((queens >> q) & 1)) continue;
+				positionHash ^= zobrist.queenKeys[q];
+				for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+					int dr = cell / BOARD_SIZE - q / BOARD_SIZE;
+					int dc = cell % BOARD_SIZE - q % BOARD_SIZE;
+					bool ruled = dr == 0 || dc == 0
+						|| colors[cell / BOARD_SIZE][cell % BOARD_SIZE] == colors[q / BOARD_SIZE][q % BOARD_SIZE]
+						|| ((dr == 1 || dr == -1) && (dc == 1 || dc == -1));
+					if (ruled && !((queens >> cell) & 1)) expectedMarks |= 1ULL << cell;
+				}
+			}
+
+			int allowed[BOARD_SIZE];
+			for (int i = 0; i < BOARD_SIZE; i++) {
+				allowed[i] = ((1 << BOARD_SIZE) - 1) & ~(int)((manual >> (i * BOARD_SIZE)) & 0xFF);
+				int rowQueens = (int)((queens >> (i * BOARD_SIZE)) & 0xFF);
+				if (rowQueens != 0) allowed[i] = rowQueens;
+			}
+			int expectedCount = reference.countSolutions(allowed);
+
+			checks++;
+			if (marks != expectedMarks || game.getSolutionsLeft() != expectedCount) {
+				if (failures++ < 10) {
+					cout << "game " << g << " step " << step << ": marks " << hex << marks << ", expected " << expectedMarks
+						<< dec << "; solutions left " << game.getSolutionsLeft() << ", expected " << expectedCount << "\n";
+				}
+			}
+
+			// Same slot, different key: a probe must miss rather than return the intruder.
+			if (step % 2 == 0) {
+				for (int cell = -1; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+					unsigned long long key = positionHash ^ (cell < 0 ? 0 : zobrist.queenKeys[cell]);
+					TableEntry intruder;
+					intruder.markMask = ZobristKeys::next(rng);
+					intruder.data = ZobristKeys::next(rng) | ENTRY_HAS_COUNT | ENTRY_HAS_HINT;
+					sharedTable.store(key ^ ((ZobristKeys::next(rng) | 1) << 32), intruder);
+				}
+			}
+		}
+	}
+	cout << checks << " positions, " << failures << " failures\n";
+	return failures == 0 ? 0 : 1;
+}
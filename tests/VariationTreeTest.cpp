@@ -0,0 +1,125 @@
+// Branches the variation tree with random moves, undos, redos and jumps, and checks each position
+// against a fresh game that replays the path from the root: same board, same marks, and a move
+// history naming the same nodes. Every so often the session goes through a QSAV save and load and
+// the loaded tree must have the same nodes, links, redo targets and current position.
+#include "QueensEngine.h"
+#include <iostream>
+using namespace std;
+
+static bool sameBoard(QueensGame& a, QueensGame& b) {
+	for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+		if (a.getCell(cell / BOARD_SIZE, cell % BOARD_SIZE) != b.getCell(cell / BOARD_SIZE, cell % BOARD_SIZE)) return false;
+	}
+	return true;
+}
+
+static int nodeId(VariationNode* node) {
+	return node == NULL ? -1 : node->id;
+}
+
+static bool sameTree(VariationTree& a, VariationTree& b) {
+	if (a.getNodeCount() != b.getNodeCount() || a.getCurrent()->id != b.getCurrent()->id) return false;
+	for (int id = 0; id < a.getNodeCount(); id++) {
+		VariationNode* x = a.getNode(id);
+		VariationNode* y = b.getNode(id);
+		if (nodeId(x->parent) != nodeId(y->parent) || nodeId(x->lastVisited) != nodeId(y->lastVisited)) return false;
+		if (x->row != y->row || x->col != y->col || x->prevState != y->prevState || x->newState != y->newState) return false;
+		if (x->queens != y->queens || x->marks != y->marks || x->manualMarks != y->manualMarks) return false;
+		int xChildren = 0, yChildren = 0;
+		for (VariationNode* c = x->firstChild; c != NULL; c = c->nextSibling) xChildren++;
+		for (VariationNode* c = y->firstChild; c != NULL; c = c->nextSibling) {
+			if (c->parent != y) return false;
+			yChildren++;
+		}
+		if (xChildren != yChildren) return false;
+	}
+	return true;
+}
+
+// Plays the moves from the root to node on a fresh game of the same map.
+static bool replay(VariationNode* node, QueensGame& game) {
+	vector<VariationNode*> path;
+	for (; node->parent != NULL; node = node->parent) path.push_back(node);
+	for (int i = (int)path.size() - 1; i >= 0; i--) {
+		VariationNode* step = path[i];
+		MoveStatus status;
+		if (step->newState == 1) status = game.placeQueen(step->row, step->col);
+		else if (step->newState == 2) status = game.markX(step->row, step->col);
+		else status = game.clearCell(step->row, step->col);
+		if (status != STATUS_OK) return false;
+	}
+	MoveNode* move = game.getHistory().getLastMove();
+	for (size_t i = 0; i < path.size(); i++, move = move->next) {
+		if (move == NULL || move->row != path[i]->row || move->col != path[i]->col) return false;
+	}
+	return move == NULL && game.getHistory().getCount() == (int)path.size();
+}
+
+int main() {
+	unsigned long long rng = 31;
+	int failures = 0, checks = 0, saves = 0;
+	int grid[BOARD_SIZE][BOARD_SIZE];
+
+	for (int g = 0; g < 40; g++) {
+		for (int cell = 0; cell < BOARD_SIZE * BOARD_SIZE; cell++) {
+			grid[cell / BOARD_SIZE][cell % BOARD_SIZE] = BASE_MAPS[g % BASE_MAP_COUNT][cell / BOARD_SIZE][cell % BOARD_SIZE];
+		}
+		QueensGame game(NULL, false);
+		game.setPuzzle(grid);
+		int actions = 0;
+
+		for (int step = 0; step < 120; step++) {
+			int row = (int)(ZobristKeys::next(rng) % BOARD_SIZE);
+			int col = (int)(ZobristKeys::next(rng) % BOARD_SIZE);
+			MoveStatus status;
+			switch (ZobristKeys::next(rng) % 7) {
+			case 0:
+			case 1:
+				status = game.placeQueen(row, col);
+				break;
+			case 2:
+				status = game.markX(row, col);
+				break;
+			case 3:
+				status = game.clearCell(row, col);
+				break;
+			case 4:
+				status = game.undo();
+				break;
+			case 5:
+				status = game.redo();
+				break;
+			default:
+				status = game.jumpToVariation((int)(ZobristKeys::next(rng) % game.getVariations().getNodeCount()));
+				break;
+			}
+			if (status == STATUS_OK) actions++;
+
+			VariationNode* current = game.getVariations().getCurrent();
+			QueensGame fresh(NULL, false);
+			fresh.setPuzzle(grid);
+			bool historyOk = game.getHistory().getCount() == actions
+				&& (actions == 0 || game.getHistory().getLastMove()->nodeId == current->id);
+			bool replayed = replay(current, fresh);
+			VariationNode* end = fresh.getVariations().getCurrent();
+			checks++;
+			if (!historyOk || !replayed || !sameBoard(game, fresh) || end->queens != current->queens
+				|| end->marks != current->marks || end->manualMarks != current->manualMarks
+				|| game.getSolutionsLeft() != fresh.getSolutionsLeft()) {
+				if (failures++ < 10) cout << "game " << g << " step " << step << ": node " << current->id << " differs from its replay\n";
+			}
+
+			if (step % 10 == 9) {
+				vector<unsigned char> blob = game.saveSession();
+				QueensGame loaded(NULL, false);
+				saves++;
+				if (!loaded.loadSession(blob) || !sameTree(game.getVariations(), loaded.getVariations())
+					|| !sameBoard(game, loaded) || loaded.saveSession() != blob) {
+					if (failures++ < 10) cout << "game " << g << " step " << step << ": the tree did not survive a save\n";
+				}
+			}
+		}
+	}
+	cout << checks << " positions, " << saves << " saves, " << failures << " failures\n";
+	return failures == 0 ? 0 : 1;
+}